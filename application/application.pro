@@ -41,7 +41,7 @@ OBJECTS_DIR   = ./.objs
 UI_DIR        = ./.ui
 RCC_DIR       = ./.rcc
 
-QT           += core gui widgets network printsupport xml
+QT           += core gui widgets network printsupport xml concurrent
 CONFIG       += c++11
 DEFINES      += QT_NO_FOREACH
 
@@ -85,39 +85,79 @@ isEmpty(PREVIEW) {
 
 include(templates/templates.pri)
 include(parser/parser.pri)
+include(trace/trace.pri)
 
 HEADERS       += inyokaedit.h \
+                 articlelibrary.h \
+                 articlescanner.h \
+                 batchrenderer.h \
+                 batchspellchecker.h \
+                 buildcache.h \
+                 diagnostics.h \
                  download.h \
                  downloadimg.h \
                  fileoperations.h \
+                 filesearch.h \
+                 filesearchpanel.h \
                  findreplace.h \
+                 librarypanel.h \
+                 livesyntaxcheck.h \
                  plugins.h \
+                 previewcache.h \
+                 renderserver.h \
+                 renderservice.h \
                  texteditor.h \
+                 trigramindex.h \
                  session.h \
                  settings.h \
                  settingsdialog.h \
+                 spellrenderservice.h \
                  syntaxcheck.h \
+                 syntaxpanel.h \
                  upload.h \
                  utils.h \
                  xmlparser.h \
-                 ieditorplugin.h
+                 ieditorplugin.h \
+                 irenderservice.h \
+                 ispellchecker.h
 
 SOURCES       += main.cpp \
                  inyokaedit.cpp \
+                 articlelibrary.cpp \
+                 articlescanner.cpp \
+                 batchrenderer.cpp \
+                 batchspellchecker.cpp \
+                 buildcache.cpp \
+                 diagnostics.cpp \
                  download.cpp \
                  downloadimg.cpp \
                  fileoperations.cpp \
+                 filesearch.cpp \
+                 filesearchpanel.cpp \
                  findreplace.cpp \
+                 librarypanel.cpp \
+                 livesyntaxcheck.cpp \
                  plugins.cpp \
+                 previewcache.cpp \
+                 renderserver.cpp \
+                 renderservice.cpp \
                  texteditor.cpp \
+                 trigramindex.cpp \
                  session.cpp \
                  settings.cpp \
                  settingsdialog.cpp \
+                 spellrenderservice.cpp \
                  syntaxcheck.cpp \
+                 syntaxpanel.cpp \
                  upload.cpp \
                  xmlparser.cpp \
                  utils.cpp
 
+contains(DEFINES, NOPREVIEW) {
+  HEADERS     += previewserver.h
+  SOURCES     += previewserver.cpp
+}
+
 FORMS         += inyokaedit.ui \
                  findreplace.ui \
                  settingsdialog.ui
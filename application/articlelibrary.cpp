@@ -0,0 +1,418 @@
+/**
+ * \file articlelibrary.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Incrementally updated index of articles for title, tag and link lookups.
+ */
+
+#include "./articlelibrary.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QtConcurrent>
+
+#include "./filesearch.h"
+#include "./parser/parser.h"
+#include "./trace/trace.h"
+
+ArticleLibrary::ArticleLibrary(const ArticleScanner &scanner,
+                               const QString &sIndexDir, QObject *pParent)
+  : QObject(pParent),
+    m_scanner(scanner),
+    m_sIndexDir(sIndexDir),
+    m_bPending(false) {
+  connect(&m_watcher, &QFutureWatcher<LibraryUpdate>::finished,
+          this, &ArticleLibrary::finishedUpdate);
+}
+
+ArticleLibrary::~ArticleLibrary() {
+  m_watcher.waitForFinished();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void ArticleLibrary::setDir(const QString &sDir) {
+  const QString sAbsDir(sDir.isEmpty() ? QString()
+                                       : QDir(sDir).absolutePath());
+  if (sAbsDir != m_sDir) {
+    m_sDir = sAbsDir;
+    this->load();
+    emit this->updated(0);
+  }
+  this->update();
+}
+
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::getDir() const -> QString {
+  return m_sDir;
+}
+
+// ----------------------------------------------------------------------------
+
+void ArticleLibrary::update() {
+  if (m_sDir.isEmpty()) {
+    return;
+  }
+  if (m_watcher.isRunning()) {
+    m_bPending = true;
+    return;
+  }
+  m_bPending = false;
+  m_watcher.setFuture(QtConcurrent::run(&ArticleLibrary::updateArticles,
+                                        m_sDir, m_hashArticles, m_scanner));
+}
+
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::isUpdating() const -> bool {
+  return m_watcher.isRunning();
+}
+
+// ----------------------------------------------------------------------------
+
+void ArticleLibrary::finishedUpdate() {
+  const LibraryUpdate result(m_watcher.result());
+  // Folder changed while updating
+  if (result.sDir != m_sDir) {
+    this->update();
+    return;
+  }
+
+  m_hashArticles = result.hashArticles;
+  this->updatePages();
+  if (result.nChanged > 0 || !QFile::exists(this->getIndexFile())) {
+    this->save();
+  }
+  emit this->updated(result.nChanged);
+  if (m_bPending) {
+    this->update();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+// Worker thread: Only new and changed files are scanned
+auto ArticleLibrary::updateArticles(
+    const QString &sDir, const QHash<QString, ArticleInfo> &hashOld,
+    const ArticleScanner &scanner) -> LibraryUpdate {
+  TraceSpan span("library", "updateArticles");
+  LibraryUpdate result;
+  result.sDir = sDir;
+
+  const QStringList sListFiles(FileSearch::collectFiles(sDir));
+  for (const auto &sFile : sListFiles) {
+    const QFileInfo fi(sFile);
+    const qint64 nModified = fi.lastModified().toMSecsSinceEpoch();
+    const auto it = hashOld.constFind(sFile);
+    if (it != hashOld.constEnd() && it.value().nModified == nModified &&
+        it.value().nSize == fi.size()) {
+      result.hashArticles.insert(sFile, it.value());
+      continue;
+    }
+
+    QString sText;
+    if (!FileSearch::readArticle(sFile, &sText)) {
+      qWarning() << "Could not read article:" << sFile;
+      continue;
+    }
+    ArticleInfo info(scanner.scan(sText));
+    info.nModified = nModified;
+    info.nSize = fi.size();
+    result.hashArticles.insert(sFile, info);
+    result.nChanged++;
+  }
+
+  // Removed files
+  if (result.hashArticles.size() - result.nChanged != hashOld.size()) {
+    result.nChanged = qMax(result.nChanged, 1);
+  }
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::getIndexFile() const -> QString {
+  return m_sIndexDir + "/" + QCryptographicHash::hash(
+        m_sDir.toUtf8(), QCryptographicHash::Md5).toHex() + ".lib";
+}
+
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::load() -> bool {
+  m_hashArticles.clear();
+  m_hashPages.clear();
+  QFile indexFile(this->getIndexFile());
+  if (m_sDir.isEmpty() || !indexFile.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  QDataStream in(&indexFile);
+  in.setVersion(QDataStream::Qt_5_9);
+  quint32 nMagic = 0;
+  quint32 nVersion = 0;
+  quint32 nCount = 0;
+  in >> nMagic >> nVersion >> nCount;
+  if (nMagic != m_cMAGIC || nVersion != m_cVERSION) {
+    return false;  // Outdated, will be overwritten by next save()
+  }
+
+  // File names are stored relative to folder
+  const QDir dir(m_sDir);
+  for (quint32 i = 0; i < nCount && in.status() == QDataStream::Ok; i++) {
+    QString sFile;
+    ArticleInfo info;
+    in >> sFile >> info.nModified >> info.nSize >> info.sListHeadlines
+       >> info.sListTags >> info.sListTemplates >> info.sListImages
+       >> info.sListLinks;
+    m_hashArticles.insert(dir.absoluteFilePath(sFile), info);
+  }
+  if (in.status() != QDataStream::Ok) {
+    qWarning() << "Corrupt article library:" << indexFile.fileName();
+    m_hashArticles.clear();
+    return false;
+  }
+  this->updatePages();
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::save() -> bool {
+  QDir dir;
+  if (!dir.mkpath(m_sIndexDir)) {
+    qWarning() << "Could not create library folder:" << m_sIndexDir;
+    return false;
+  }
+
+  QSaveFile indexFile(this->getIndexFile());
+  if (!indexFile.open(QIODevice::WriteOnly)) {
+    qWarning() << "Could not write article library:" << indexFile.fileName();
+    return false;
+  }
+  QDataStream out(&indexFile);
+  out.setVersion(QDataStream::Qt_5_9);
+  out << m_cMAGIC << m_cVERSION
+      << static_cast<quint32>(m_hashArticles.size());
+  const QDir libraryDir(m_sDir);
+  for (auto it = m_hashArticles.constBegin();
+       it != m_hashArticles.constEnd(); ++it) {
+    const ArticleInfo &info = it.value();
+    out << libraryDir.relativeFilePath(it.key()) << info.nModified
+        << info.nSize << info.sListHeadlines << info.sListTags
+        << info.sListTemplates << info.sListImages << info.sListLinks;
+  }
+  if (!indexFile.commit()) {
+    qWarning() << "Could not write article library:" << indexFile.fileName();
+    return false;
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void ArticleLibrary::updatePages() {
+  m_hashPages.clear();
+  m_hashPages.reserve(m_hashArticles.size());
+  for (auto it = m_hashArticles.constBegin();
+       it != m_hashArticles.constEnd(); ++it) {
+    m_hashPages.insert(ArticleLibrary::normalizePage(
+                         this->getPageName(it.key())), it.key());
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::getFiles() const -> QStringList {
+  QStringList sListFiles(m_hashArticles.keys());
+  sListFiles.sort();
+  return sListFiles;
+}
+
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::getInfo(const QString &sFile) const -> ArticleInfo {
+  return m_hashArticles.value(sFile);
+}
+
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::getPageName(const QString &sFile) const -> QString {
+  QString sPage(QDir(m_sDir).relativeFilePath(sFile));
+  sPage.truncate(sPage.lastIndexOf(QChar('.')));
+  return sPage.replace(QChar('_'), QChar(' '));
+}
+
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::getTitle(const QString &sFile) const -> QString {
+  const QStringList sListHeadlines(
+        m_hashArticles.value(sFile).sListHeadlines);
+  if (sListHeadlines.isEmpty()) {
+    return this->getPageName(sFile);
+  }
+  return sListHeadlines.first().mid(5);  // Remove "##<level>##"
+}
+
+// ----------------------------------------------------------------------------
+
+// Page name or title contains all words of filter (case insensitive)
+auto ArticleLibrary::findTitle(const QString &sFilter) const -> QStringList {
+#if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
+  const QStringList sListWords(sFilter.split(QChar(' '),
+                                             QString::SkipEmptyParts));
+#else
+  const QStringList sListWords(sFilter.split(QChar(' '),
+                                             Qt::SkipEmptyParts));
+#endif
+  QStringList sListFiles;
+  const QStringList sListAll(this->getFiles());
+  for (const auto &sFile : sListAll) {
+    const QString sName(this->getPageName(sFile) + " " +
+                        this->getTitle(sFile));
+    bool bFound = true;
+    for (const auto &sWord : sListWords) {
+      if (!sName.contains(sWord, Qt::CaseInsensitive)) {
+        bFound = false;
+        break;
+      }
+    }
+    if (bFound) {
+      sListFiles << sFile;
+    }
+  }
+  return sListFiles;
+}
+
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::getTags() const -> QMap<QString, QStringList> {
+  QMap<QString, QStringList> mapTags;
+  const QStringList sListFiles(this->getFiles());
+  for (const auto &sFile : sListFiles) {
+    const QStringList sListTags(m_hashArticles.value(sFile).sListTags);
+    for (const auto &sTag : sListTags) {
+      if (!sTag.isEmpty()) {
+        mapTags[sTag] << sFile;
+      }
+    }
+  }
+  return mapTags;
+}
+
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::getBacklinks(const QString &sFile) const -> QStringList {
+  const QString sPage(ArticleLibrary::normalizePage(this->getPageName(sFile)));
+  QStringList sListFiles;
+  for (auto it = m_hashArticles.constBegin();
+       it != m_hashArticles.constEnd(); ++it) {
+    if (it.key() == sFile) {
+      continue;
+    }
+    for (const auto &sLink : it.value().sListLinks) {
+      if (ArticleLibrary::normalizePage(sLink) == sPage) {
+        sListFiles << it.key();
+        break;
+      }
+    }
+  }
+  sListFiles.sort();
+  return sListFiles;
+}
+
+// ----------------------------------------------------------------------------
+
+auto ArticleLibrary::getBrokenLinks() const -> QList<LibraryLink> {
+  QList<LibraryLink> listBroken;
+  const QStringList sListFiles(this->getFiles());
+  for (const auto &sFile : sListFiles) {
+    const ArticleInfo info(m_hashArticles.value(sFile));
+    for (const auto &sLink : info.sListLinks) {
+      const QString sTarget(
+            m_hashPages.value(ArticleLibrary::normalizePage(sLink)));
+      if (sTarget.isEmpty()) {
+        listBroken << LibraryLink{sFile, sLink,
+                                  QStringLiteral("PAGE_MISSING")};
+        continue;
+      }
+      const int nAnchor = sLink.indexOf(QChar('#'));
+      if (-1 == nAnchor) {
+        continue;
+      }
+      const QString sAnchor(sLink.mid(nAnchor + 1).trimmed());
+      bool bFound = false;
+      const QStringList sListHeadlines(
+            m_hashArticles.value(sTarget).sListHeadlines);
+      for (const auto &sHeadline : sListHeadlines) {
+        if (Parser::getHeadlineAnchor(sHeadline.mid(5)) == sAnchor) {
+          bFound = true;
+          break;
+        }
+      }
+      if (!bFound) {
+        listBroken << LibraryLink{sFile, sLink,
+                                  QStringLiteral("SECTION_MISSING")};
+      }
+    }
+
+    // Images of archives are inside the archive
+    if (sFile.endsWith(QLatin1String(".inyzip"))) {
+      continue;
+    }
+    const QDir articleDir(QFileInfo(sFile).absolutePath());
+    for (const auto &sImage : info.sListImages) {
+      if (sImage.startsWith(QLatin1String("Wiki/")) ||
+          sImage.startsWith(QLatin1String("img/")) ||
+          sImage.contains(QLatin1String("://"))) {
+        continue;  // Community or external image
+      }
+      if (!articleDir.exists(sImage)) {
+        listBroken << LibraryLink{sFile, sImage,
+                                  QStringLiteral("IMAGE_MISSING")};
+      }
+    }
+  }
+  return listBroken;
+}
+
+// ----------------------------------------------------------------------------
+
+// Page names are compared without anchor, "_" and case
+auto ArticleLibrary::normalizePage(const QString &sPage) -> QString {
+  QString sNormalized(sPage);
+  const int nAnchor = sNormalized.indexOf(QChar('#'));
+  if (-1 != nAnchor) {
+    sNormalized.truncate(nAnchor);
+  }
+  return sNormalized.replace(QChar('_'), QChar(' ')).trimmed().toLower();
+}
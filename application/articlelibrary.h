@@ -0,0 +1,113 @@
+/**
+ * \file articlelibrary.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for index of all articles in a folder.
+ */
+
+#ifndef APPLICATION_ARTICLELIBRARY_H_
+#define APPLICATION_ARTICLELIBRARY_H_
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include "./articlescanner.h"
+
+struct LibraryLink {
+  QString sFile;
+  QString sLink;
+  QString sCode;  // PAGE_MISSING, SECTION_MISSING or IMAGE_MISSING
+};
+
+struct LibraryUpdate {
+  QString sDir;
+  QHash<QString, ArticleInfo> hashArticles;
+  int nChanged = 0;  // New, changed and removed files
+};
+
+/**
+ * \class ArticleLibrary
+ * \brief Headlines, tags, templates, images and links of all articles
+ *
+ * The index of a folder is stored in user data folder. An update only
+ * scans files with changed modification time or size (in a worker
+ * thread), therefore lookups don't need to parse any article.
+ */
+class ArticleLibrary : public QObject {
+  Q_OBJECT
+
+ public:
+    ArticleLibrary(const ArticleScanner &scanner, const QString &sIndexDir,
+                   QObject *pParent = nullptr);
+    ~ArticleLibrary();
+
+    void setDir(const QString &sDir);
+    auto getDir() const -> QString;
+    void update();
+    auto isUpdating() const -> bool;
+
+    auto getFiles() const -> QStringList;
+    auto getInfo(const QString &sFile) const -> ArticleInfo;
+    // Wiki page name of file, e.g. "Foo/Bar_Baz.iny" -> "Foo/Bar Baz"
+    auto getPageName(const QString &sFile) const -> QString;
+    // First headline, page name if article has no headline
+    auto getTitle(const QString &sFile) const -> QString;
+    auto findTitle(const QString &sFilter) const -> QStringList;
+    auto getTags() const -> QMap<QString, QStringList>;
+    auto getBacklinks(const QString &sFile) const -> QStringList;
+    // Offline check: Pages, sections and images not found in library
+    auto getBrokenLinks() const -> QList<LibraryLink>;
+
+ signals:
+    void updated(const int nChanged);
+
+ private slots:
+    void finishedUpdate();
+
+ private:
+    static auto updateArticles(
+        const QString &sDir, const QHash<QString, ArticleInfo> &hashOld,
+        const ArticleScanner &scanner) -> LibraryUpdate;
+    static auto normalizePage(const QString &sPage) -> QString;
+    auto getIndexFile() const -> QString;
+    auto load() -> bool;
+    auto save() -> bool;
+    void updatePages();
+
+    static const quint32 m_cMAGIC = 0x494E594C;  // "INYL"
+    static const quint32 m_cVERSION = 1;
+
+    const ArticleScanner m_scanner;
+    const QString m_sIndexDir;
+    QString m_sDir;
+    QHash<QString, ArticleInfo> m_hashArticles;  // Absolute file path
+    QHash<QString, QString> m_hashPages;  // Normalized page name -> file
+    QFutureWatcher<LibraryUpdate> m_watcher;
+    bool m_bPending;
+};
+
+#endif  // APPLICATION_ARTICLELIBRARY_H_
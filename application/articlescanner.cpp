@@ -0,0 +1,198 @@
+/**
+ * \file articlescanner.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Extract headlines, tags, templates, images and wiki links of an article.
+ */
+
+#include "./articlescanner.h"
+
+#include "./parser/parser.h"
+#include "./syntaxcheck.h"
+
+ArticleScanner::ArticleScanner(const QStringList &sListTplTrans,
+                               const QStringList &sListImgTrans)
+  : m_sListTplTrans(sListTplTrans),
+    m_sListImgTrans(sListImgTrans) {
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto ArticleScanner::scan(const QString &sText) const -> ArticleInfo {
+  ArticleInfo info;
+  bool bCode = false;
+  quint8 nLevel = 0;
+  QString sHeadline;
+
+  const QStringList sListLines(sText.split(QChar('\n')));
+  for (const auto &sLine : sListLines) {
+    if (!bCode) {
+      // Comment, see Parser::removeComments()
+      if (sLine.startsWith(QLatin1String("##"))) {
+        continue;
+      }
+      if (Parser::parseHeadline(sLine, &nLevel, &sHeadline)) {
+        info.sListHeadlines << "##" + QString::number(nLevel) + "##" +
+                               sHeadline;
+        continue;
+      }
+      if (Parser::parseTags(sLine, &info.sListTags)) {
+        continue;
+      }
+    }
+    this->scanLine(sLine, &info, &bCode);
+  }
+
+  info.sListTemplates.removeDuplicates();
+  info.sListImages.removeDuplicates();
+  info.sListLinks.removeDuplicates();
+  return info;
+}
+
+// ----------------------------------------------------------------------------
+
+void ArticleScanner::scanLine(const QString &sLine, ArticleInfo *pInfo,
+                              bool *pbCode) const {
+  int i = 0;
+  while (i < sLine.size()) {
+    if (*pbCode) {
+      const int nClose = sLine.indexOf(QLatin1String("}}}"), i);
+      if (-1 == nClose) {
+        return;
+      }
+      *pbCode = false;
+      i = nClose + 3;
+      continue;
+    }
+
+    const QChar c(sLine.at(i));
+    if ('`' == c) {  // Monotype `` or `
+      const QString sMono(
+            SyntaxCheck::startsAt(sLine, i, QStringLiteral("``"))
+            ? QStringLiteral("``") : QStringLiteral("`"));
+      const int nClose = sLine.indexOf(sMono, i + sMono.size());
+      if (-1 != nClose) {
+        i = nClose + sMono.size();
+        continue;
+      }
+    } else if ('{' == c &&
+               SyntaxCheck::startsAt(sLine, i, QStringLiteral("{{{"))) {
+      // Content of parser templates is markup, everything else is code
+      const QString sTemplate(
+            ArticleScanner::getBlockTemplate(sLine, i + 3, m_sListTplTrans));
+      if (sTemplate.isEmpty()) {
+        *pbCode = true;
+      } else {
+        pInfo->sListTemplates << sTemplate;
+      }
+      i += 3;
+      continue;
+    } else if ('[' == c &&
+               SyntaxCheck::startsAt(sLine, i, QStringLiteral("[["))) {
+      const QString sTemplate(
+            ArticleScanner::getMacroArgument(sLine, i + 2, m_sListTplTrans));
+      if (!sTemplate.isEmpty()) {
+        pInfo->sListTemplates << sTemplate;
+      } else {
+        const QString sImage(ArticleScanner::getMacroArgument(
+                               sLine, i + 2, m_sListImgTrans));
+        if (!sImage.isEmpty()) {
+          pInfo->sListImages << sImage;
+        }
+      }
+    } else if ('[' == c &&
+               SyntaxCheck::startsAt(sLine, i, QStringLiteral("[:"))) {
+      // [:Page:], [:Page:Text] or [:Page#Anchor:], see ParseLinks
+      const int nClose = sLine.indexOf(QChar(']'), i);
+      const int nColon = sLine.indexOf(QChar(':'), i + 2);
+      if (-1 != nClose && -1 != nColon && nColon < nClose) {
+        const QString sPage(sLine.mid(i + 2, nColon - i - 2).trimmed());
+        if (!sPage.isEmpty()) {
+          pInfo->sListLinks << sPage;
+        }
+        i = nClose + 1;
+        continue;
+      }
+    }
+    i++;
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+// First argument of [[Macro(Argument, ...)]]
+auto ArticleScanner::getMacroArgument(
+    const QString &sLine, const int nPos,
+    const QStringList &sListTrans) -> QString {
+  for (const auto &sTrans : sListTrans) {
+    if (!SyntaxCheck::startsAt(sLine, nPos, sTrans, Qt::CaseInsensitive)) {
+      continue;
+    }
+    int nStart = nPos + sTrans.size();
+    while (nStart < sLine.size() && sLine.at(nStart).isSpace()) {
+      nStart++;
+    }
+    if (nStart >= sLine.size() || '(' != sLine.at(nStart)) {
+      continue;
+    }
+    nStart++;
+    int nEnd = sLine.indexOf(QChar(','), nStart);
+    const int nClose = sLine.indexOf(QChar(')'), nStart);
+    if (-1 == nEnd || (-1 != nClose && nClose < nEnd)) {
+      nEnd = nClose;
+    }
+    if (-1 == nEnd) {
+      return QString();
+    }
+    return sLine.mid(nStart, nEnd - nStart).trimmed();
+  }
+  return QString();
+}
+
+// ----------------------------------------------------------------------------
+
+// Template name of {{{#!vorlage Name
+auto ArticleScanner::getBlockTemplate(
+    const QString &sLine, const int nPos,
+    const QStringList &sListTrans) -> QString {
+  if (!SyntaxCheck::startsAt(sLine, nPos, QStringLiteral("#!"))) {
+    return QString();
+  }
+  for (const auto &sTrans : sListTrans) {
+    int nName = nPos + 2 + sTrans.size();
+    if (!SyntaxCheck::startsAt(sLine, nPos + 2, sTrans, Qt::CaseInsensitive) ||
+        nName >= sLine.size() || ' ' != sLine.at(nName)) {
+      continue;
+    }
+    while (nName < sLine.size() && ' ' == sLine.at(nName)) {
+      nName++;
+    }
+    int nEnd = sLine.indexOf(QChar(' '), nName);
+    if (-1 == nEnd) {
+      nEnd = sLine.size();
+    }
+    return sLine.mid(nName, nEnd - nName).remove(QChar(',')).trimmed();
+  }
+  return QString();
+}
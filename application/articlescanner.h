@@ -0,0 +1,70 @@
+/**
+ * \file articlescanner.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for extraction of article metadata.
+ */
+
+#ifndef APPLICATION_ARTICLESCANNER_H_
+#define APPLICATION_ARTICLESCANNER_H_
+
+#include <QString>
+#include <QStringList>
+
+struct ArticleInfo {
+  qint64 nModified = -1;  // Msecs since epoch
+  qint64 nSize = -1;
+  QStringList sListHeadlines;  // "##<level>##Headline", see replaceHeadlines
+  QStringList sListTags;
+  QStringList sListTemplates;
+  QStringList sListImages;
+  QStringList sListLinks;  // Wiki pages as written, with optional "#anchor"
+};
+
+/**
+ * \class ArticleScanner
+ * \brief Headlines, tags, templates, images and wiki links of an article
+ *
+ * Single pass over raw text without generating HTML; content of code
+ * blocks and comments is skipped like in parser. Only const data is used,
+ * therefore a copy can be used in worker threads.
+ */
+class ArticleScanner {
+ public:
+    ArticleScanner(const QStringList &sListTplTrans,
+                   const QStringList &sListImgTrans);
+
+    auto scan(const QString &sText) const -> ArticleInfo;
+
+ private:
+    void scanLine(const QString &sLine, ArticleInfo *pInfo,
+                  bool *pbCode) const;
+    static auto getMacroArgument(const QString &sLine, const int nPos,
+                                 const QStringList &sListTrans) -> QString;
+    static auto getBlockTemplate(const QString &sLine, const int nPos,
+                                 const QStringList &sListTrans) -> QString;
+
+    const QStringList m_sListTplTrans;
+    const QStringList m_sListImgTrans;
+};
+
+#endif  // APPLICATION_ARTICLESCANNER_H_
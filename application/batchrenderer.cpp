@@ -0,0 +1,417 @@
+/**
+ * \file batchrenderer.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Render articles to HTML in parallel, each thread with its own parser.
+ * Only articles with changed inputs are rendered again.
+ */
+
+#include "./batchrenderer.h"
+
+#include <QAtomicInt>
+#include <QDebug>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QRunnable>
+#include <QTextDocument>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+
+#include "./buildcache.h"
+#include "./parser/parser.h"
+#include "./settings.h"
+#include "./templates/templates.h"
+
+/**
+ * \struct RenderJob
+ * \brief Shared by all render workers, file list is read only
+ */
+struct RenderJob {
+  QList<QPair<QString, QString>> listFiles;
+  QString sOutputDir;
+  QString sSharePath;
+  QDir tmpImgDir;
+  QString sInyokaUrl;
+  QString sCommunity;
+  QString sPygmentize;
+  Templates *pTemplates;  // Only const getters are used
+  BuildCache *pCache;
+  QAtomicInt nNext;
+  QAtomicInt nFailed;
+  QAtomicInt nSkipped;
+};
+
+/**
+ * \class RenderWorker
+ * \brief Takes files from job until all are rendered
+ */
+class RenderWorker : public QRunnable {
+ public:
+    explicit RenderWorker(RenderJob *pJob)
+      : m_pJob(pJob) {
+    }
+
+    void run() override {
+      // Parser context is created in worker thread and reused for all files
+      Parser parser(m_pJob->sSharePath, m_pJob->tmpImgDir,
+                    m_pJob->sInyokaUrl, false, m_pJob->pTemplates,
+                    m_pJob->sCommunity, m_pJob->sPygmentize);
+      QTextDocument doc;
+
+      for (int i = m_pJob->nNext.fetchAndAddRelaxed(1);
+           i < m_pJob->listFiles.size();
+           i = m_pJob->nNext.fetchAndAddRelaxed(1)) {
+        switch (this->renderFile(&parser, &doc,
+                                 m_pJob->listFiles.at(i).first,
+                                 m_pJob->sOutputDir + "/" +
+                                 m_pJob->listFiles.at(i).second)) {
+          case FAILED:
+            m_pJob->nFailed.fetchAndAddRelaxed(1);
+            break;
+          case SKIPPED:
+            m_pJob->nSkipped.fetchAndAddRelaxed(1);
+            break;
+          default:
+            break;
+        }
+      }
+    }
+
+ private:
+    enum RESULT {RENDERED, SKIPPED, FAILED};
+
+    auto renderFile(Parser *pParser, QTextDocument *pDoc,
+                    const QString &sInput, const QString &sOutput) -> RESULT {
+      QFile inFile(sInput);
+      if (!inFile.open(QFile::ReadOnly)) {
+        qWarning() << "Could not open" << sInput << inFile.errorString();
+        return FAILED;
+      }
+      const QByteArray baRaw(inFile.readAll());
+      inFile.close();
+
+      const QByteArray baHash(BuildCache::hash(baRaw));
+      if (m_pJob->pCache->isUpToDate(sInput, baHash, sOutput)) {
+        return SKIPPED;
+      }
+
+      // Hash is taken from raw bytes, text is decoded like an opened file
+      QTextStream in(baRaw, QIODevice::ReadOnly | QIODevice::Text);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+      // Since Qt 6 UTF-8 is used by default
+      in.setCodec("UTF-8");
+#endif
+      in.setAutoDetectUnicode(true);
+      pDoc->setPlainText(in.readAll());
+      const QString sHtml(pParser->genOutput(sInput, pDoc));
+
+      QDir().mkpath(QFileInfo(sOutput).absolutePath());
+      QFile outFile(sOutput);
+      if (!outFile.open(QFile::WriteOnly | QFile::Text)) {
+        qWarning() << "Could not write" << sOutput << outFile.errorString();
+        return FAILED;
+      }
+      QTextStream out(&outFile);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+      // Since Qt 6 UTF-8 is used by default
+      out.setCodec("UTF-8");
+#endif
+      out << sHtml;
+      outFile.close();
+
+      m_pJob->pCache->update(sInput, baHash, sOutput,
+                             pParser->getUsedTemplates(), sHtml);
+      qInfo().noquote() << sInput << "->" << sOutput;
+      return RENDERED;
+    }
+
+    RenderJob *m_pJob;
+};
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+BatchRenderer::BatchRenderer(const QString &sSharePath,
+                             const QDir &userDataDir, QObject *pParent)
+  : QObject(pParent),
+    m_sSharePath(sSharePath),
+    m_UserDataDir(userDataDir),
+    m_pTemplates(nullptr),
+    m_pWatcher(nullptr),
+    m_pRebuildTimer(nullptr),
+    m_nJobs(0),
+    m_bReloadTemplates(false) {
+  // Same community, URL and pygmentize as configured for GUI
+  m_pSettings = new Settings(nullptr, m_sSharePath);
+  this->loadTemplates();
+}
+
+BatchRenderer::~BatchRenderer() {
+  delete m_pTemplates;
+  m_pTemplates = nullptr;
+  delete m_pSettings;
+  m_pSettings = nullptr;
+}
+
+// ----------------------------------------------------------------------------
+
+void BatchRenderer::loadTemplates() {
+  // Loaded once, shared by all parser threads
+  delete m_pTemplates;
+  m_pTemplates = new Templates(m_pSettings->getInyokaCommunity(),
+                               m_sSharePath, m_UserDataDir.absolutePath());
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto BatchRenderer::render(const QStringList &sListInput,
+                           const QString &sOutputDir,
+                           const int nJobs) -> int {
+  RenderJob job;
+  job.listFiles = BatchRenderer::collectFiles(sListInput);
+  job.sOutputDir = QDir(sOutputDir).absolutePath();
+  job.sSharePath = m_sSharePath;
+  job.tmpImgDir.setPath(m_UserDataDir.absolutePath() + "/tmpImages");
+  job.sInyokaUrl = m_pSettings->getInyokaUrl();
+  job.sCommunity = m_pSettings->getInyokaCommunity();
+  job.sPygmentize = m_pSettings->getPygmentize();
+  job.pTemplates = m_pTemplates;
+
+  if (job.listFiles.isEmpty()) {
+    qWarning() << "No files to render:" << sListInput;
+    return 1;
+  }
+  if (!QDir().mkpath(job.sOutputDir)) {
+    qWarning() << "Could not create output folder:" << job.sOutputDir;
+    return job.listFiles.size();
+  }
+
+  BuildCache cache(job.sOutputDir + "/.inyokaedit-cache.json", m_pTemplates,
+                   job.sCommunity + "\n" + job.sInyokaUrl + "\n" +
+                   job.sPygmentize);
+  job.pCache = &cache;
+
+  QElapsedTimer timer;
+  timer.start();
+  QThreadPool pool;
+  const int nThreads = qMax(1, qMin(nJobs > 0 ? nJobs :
+                                    QThread::idealThreadCount(),
+                                    job.listFiles.size()));
+  pool.setMaxThreadCount(nThreads);
+  for (int i = 0; i < nThreads; i++) {
+    pool.start(new RenderWorker(&job));
+  }
+  pool.waitForDone();
+  // Unchanged cache is not rewritten (would trigger watch mode again)
+  if (cache.isModified()) {
+    cache.save();
+  }
+
+  const int nFailed = job.nFailed.loadAcquire();
+  const int nSkipped = job.nSkipped.loadAcquire();
+  qInfo().noquote() << QStringLiteral("Rendered %1 of %2 files, %3 up to "
+                                      "date, in %4 ms (%5 threads)")
+                       .arg(job.listFiles.size() - nFailed - nSkipped)
+                       .arg(job.listFiles.size())
+                       .arg(nSkipped)
+                       .arg(timer.elapsed())
+                       .arg(nThreads);
+  return nFailed;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void BatchRenderer::watch(const QStringList &sListInput,
+                          const QString &sOutputDir, const int nJobs) {
+  m_sListInput = sListInput;
+  m_sOutputDir = sOutputDir;
+  m_nJobs = nJobs;
+
+  m_pWatcher = new QFileSystemWatcher(this);
+  connect(m_pWatcher, &QFileSystemWatcher::fileChanged,
+          this, &BatchRenderer::changedPath);
+  connect(m_pWatcher, &QFileSystemWatcher::directoryChanged,
+          this, &BatchRenderer::changedPath);
+
+  // Editors save in several steps; collect changes before rebuilding
+  m_pRebuildTimer = new QTimer(this);
+  m_pRebuildTimer->setSingleShot(true);
+  m_pRebuildTimer->setInterval(300);
+  connect(m_pRebuildTimer, &QTimer::timeout,
+          this, &BatchRenderer::rebuild);
+
+  this->updateWatcher();
+  qInfo() << "Watching for changes...";
+}
+
+// ----------------------------------------------------------------------------
+
+void BatchRenderer::changedPath(const QString &sPath) {
+  const QStringList sListCommunity(this->getCommunityDirs());
+  for (const auto &sDir : sListCommunity) {
+    if (sPath.startsWith(sDir)) {
+      m_bReloadTemplates = true;
+      m_pRebuildTimer->start();
+      return;
+    }
+  }
+
+  // Changed (or removed) article
+  if (m_sListArticles.contains(sPath)) {
+    m_pRebuildTimer->start();
+    return;
+  }
+
+  // Folder changed: Only new or removed articles count, not own output
+  // (HTML files, build cache), which may be written into an input folder
+  QStringList sListArticles;
+  const QList<QPair<QString, QString>> listFiles(
+        BatchRenderer::collectFiles(m_sListInput));
+  for (const auto &file : listFiles) {
+    sListArticles << file.first;
+  }
+  sListArticles.sort();
+  if (sListArticles != m_sListArticles) {
+    m_pRebuildTimer->start();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void BatchRenderer::rebuild() {
+  if (m_bReloadTemplates) {
+    m_bReloadTemplates = false;
+    qInfo() << "Community files changed - reloading templates";
+    this->loadTemplates();
+  }
+  this->render(m_sListInput, m_sOutputDir, m_nJobs);
+  this->updateWatcher();  // New files / files replaced while saving
+}
+
+// ----------------------------------------------------------------------------
+
+void BatchRenderer::updateWatcher() {
+  QStringList sListPaths;
+  const QString sOutputDir(QDir(m_sOutputDir).absolutePath());
+
+  // Templates, mappings and community configuration
+  const QStringList sListCommunity(this->getCommunityDirs());
+  for (const auto &sDir : sListCommunity) {
+    sListPaths << sDir;
+    QDirIterator it(sDir, QStringList() << QStringLiteral("*.tpl")
+                    << QStringLiteral("*.conf") << QStringLiteral("*.csv"),
+                    QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+      sListPaths << it.next();
+    }
+  }
+
+  for (const auto &sInput : qAsConst(m_sListInput)) {
+    const QFileInfo fi(sInput);
+    sListPaths << fi.absoluteFilePath();
+    if (fi.isDir()) {
+      QDirIterator it(fi.absoluteFilePath(),
+                      QDir::Dirs | QDir::NoDotAndDotDot,
+                      QDirIterator::Subdirectories);
+      while (it.hasNext()) {
+        const QString sDir(it.next());
+        if (!sDir.startsWith(sOutputDir)) {  // Don't react on own output
+          sListPaths << sDir;
+        }
+      }
+    }
+  }
+  const QList<QPair<QString, QString>> listFiles(
+        BatchRenderer::collectFiles(m_sListInput));
+  m_sListArticles.clear();
+  for (const auto &file : listFiles) {
+    sListPaths << file.first;
+    m_sListArticles << file.first;
+  }
+  m_sListArticles.sort();
+
+  const QStringList sListWatched(m_pWatcher->files() +
+                                 m_pWatcher->directories());
+  QStringList sListNew;
+  sListPaths.removeDuplicates();
+  for (const auto &sPath : qAsConst(sListPaths)) {
+    if (!sListWatched.contains(sPath) && QFileInfo::exists(sPath)) {
+      sListNew << sPath;
+    }
+  }
+  if (!sListNew.isEmpty()) {
+    m_pWatcher->addPaths(sListNew);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+auto BatchRenderer::getCommunityDirs() const -> QStringList {
+  const QString sCommunity("/community/" + m_pSettings->getInyokaCommunity());
+  QStringList sListDirs;
+  sListDirs << m_sSharePath + sCommunity
+            << m_UserDataDir.absolutePath() + sCommunity;
+  return sListDirs;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto BatchRenderer::collectFiles(
+    const QStringList &sListInput) -> QList<QPair<QString, QString>> {
+  static const QStringList sListFilter(QStringList() << QStringLiteral("*.iny")
+                                       << QStringLiteral("*.inyoka"));
+  QList<QPair<QString, QString>> listFiles;
+
+  for (const auto &sInput : sListInput) {
+    QFileInfo fi(sInput);
+    if (fi.isDir()) {
+      // Keep folder structure below given folder
+      const QDir inputDir(fi.absoluteFilePath());
+      QDirIterator it(inputDir.absolutePath(), sListFilter, QDir::Files,
+                      QDirIterator::Subdirectories);
+      while (it.hasNext()) {
+        const QFileInfo file(it.next());
+        const QString sRelative(inputDir.relativeFilePath(file.absolutePath()));
+        QString sOutput(file.completeBaseName() + ".html");
+        if (!sRelative.isEmpty() && sRelative != QLatin1String(".")) {
+          sOutput = sRelative + "/" + sOutput;
+        }
+        listFiles << qMakePair(file.absoluteFilePath(), sOutput);
+      }
+    } else if (fi.isFile()) {
+      listFiles << qMakePair(fi.absoluteFilePath(),
+                             fi.completeBaseName() + ".html");
+    } else {
+      qWarning() << "File not found:" << sInput;
+    }
+  }
+
+  return listFiles;
+}
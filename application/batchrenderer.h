@@ -0,0 +1,91 @@
+/**
+ * \file batchrenderer.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for headless rendering of articles (command line).
+ */
+
+#ifndef APPLICATION_BATCHRENDERER_H_
+#define APPLICATION_BATCHRENDERER_H_
+
+#include <QDir>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+class QFileSystemWatcher;
+class QTimer;
+
+class Settings;
+class Templates;
+
+/**
+ * \class BatchRenderer
+ * \brief Render Inyoka articles to HTML without GUI, one parser per thread
+ *
+ * Unchanged articles are skipped (see BuildCache). In watch mode, changed
+ * articles and community files trigger an incremental rebuild.
+ */
+class BatchRenderer : public QObject {
+  Q_OBJECT
+
+ public:
+    BatchRenderer(const QString &sSharePath, const QDir &userDataDir,
+                  QObject *pParent = nullptr);
+    ~BatchRenderer();
+
+    // Input: Files and/or folders; returns number of failed files
+    auto render(const QStringList &sListInput, const QString &sOutputDir,
+                const int nJobs) -> int;
+    // Rebuild on file system changes (needs running event loop)
+    void watch(const QStringList &sListInput, const QString &sOutputDir,
+               const int nJobs);
+    // Source file, output file name relative to output folder
+    static auto collectFiles(
+        const QStringList &sListInput) -> QList<QPair<QString, QString>>;
+
+ private slots:
+    void changedPath(const QString &sPath);
+    void rebuild();
+
+ private:
+    void loadTemplates();
+    void updateWatcher();
+    auto getCommunityDirs() const -> QStringList;
+
+    const QString m_sSharePath;
+    const QDir m_UserDataDir;
+    Settings *m_pSettings;
+    Templates *m_pTemplates;
+
+    QFileSystemWatcher *m_pWatcher;
+    QTimer *m_pRebuildTimer;
+    QStringList m_sListInput;
+    QStringList m_sListArticles;  // Sources of last rebuild
+    QString m_sOutputDir;
+    int m_nJobs;
+    bool m_bReloadTemplates;
+};
+
+#endif  // APPLICATION_BATCHRENDERER_H_
@@ -0,0 +1,233 @@
+/**
+ * \file batchspellchecker.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Spell check articles in parallel and write a report of unknown words.
+ */
+
+#include "./batchspellchecker.h"
+
+#include <QAtomicInt>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
+#include "./batchrenderer.h"
+#include "./ieditorplugin.h"
+#include "./ispellchecker.h"
+#include "./plugins.h"
+#include "./settings.h"
+#include "./spellrenderservice.h"
+#include "./templates/templates.h"
+
+/**
+ * \struct SpellJob
+ * \brief Shared by all spell check workers, file list is read only
+ */
+struct SpellJob {
+  QStringList sListFiles;
+  ISpellChecker *pSpellChecker;  // Thread safe
+  QStringList *pReports;  // One entry per file, written by one worker each
+  QAtomicInt nNext;
+  QAtomicInt nFailed;
+  QAtomicInt nUnknown;
+};
+
+/**
+ * \class SpellWorker
+ * \brief Takes files from job until all are checked
+ */
+class SpellWorker : public QRunnable {
+ public:
+    explicit SpellWorker(SpellJob *pJob)
+      : m_pJob(pJob) {
+    }
+
+    void run() override {
+      for (int i = m_pJob->nNext.fetchAndAddRelaxed(1);
+           i < m_pJob->sListFiles.size();
+           i = m_pJob->nNext.fetchAndAddRelaxed(1)) {
+        if (!this->checkFile(m_pJob->sListFiles.at(i),
+                             &m_pJob->pReports[i])) {
+          m_pJob->nFailed.fetchAndAddRelaxed(1);
+        }
+      }
+    }
+
+ private:
+    auto checkFile(const QString &sFile, QStringList *pReport) -> bool {
+      QFile inFile(sFile);
+      if (!inFile.open(QFile::ReadOnly | QFile::Text)) {
+        qWarning() << "Could not open" << sFile << inFile.errorString();
+        return false;
+      }
+      QTextStream in(&inFile);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+      // Since Qt 6 UTF-8 is used by default
+      in.setCodec("UTF-8");
+#endif
+      in.setAutoDetectUnicode(true);
+      const QString sText(in.readAll());
+      inFile.close();
+
+      // Positions are ascending, so lines are counted in one pass
+      const QList<QPair<int, QString>> listUnknown(
+            m_pJob->pSpellChecker->checkText(sText));
+      int nLine = 1;
+      int nPos = 0;
+      for (const auto &unknown : listUnknown) {
+        for (; nPos < unknown.first; nPos++) {
+          if ('\n' == sText.at(nPos)) {
+            nLine++;
+          }
+        }
+        *pReport << QStringLiteral("%1\t%2\t%3\t%4").arg(
+                      sFile, QString::number(nLine), unknown.second,
+                      m_pJob->pSpellChecker->getSuggestions(
+                        unknown.second).join(QStringLiteral(", ")));
+      }
+      m_pJob->nUnknown.fetchAndAddRelaxed(listUnknown.size());
+      return true;
+    }
+
+    SpellJob *m_pJob;
+};
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+BatchSpellChecker::BatchSpellChecker(const QString &sSharePath,
+                                     const QDir &userDataDir,
+                                     QObject *pParent)
+  : QObject(pParent),
+    m_UserDataDir(userDataDir),
+    m_pSpellChecker(nullptr) {
+  // Same community and spell checker settings as configured for GUI
+  m_pSettings = new Settings(nullptr, sSharePath);
+  m_pTemplates = new Templates(m_pSettings->getInyokaCommunity(), sSharePath,
+                               m_UserDataDir.absolutePath());
+  // Template keywords for markup aware tokenizer of plugin (no parser)
+  m_pRenderService = new SpellRenderService(m_pTemplates);
+
+  // Only the spell checker plugin library is loaded
+  QObject *pPlugin = Plugins::loadPlugin(
+                       QString::fromLatin1(ISpellChecker::m_cPLUGINIID),
+                       m_pSettings->getDisabledPlugins(),
+                       m_UserDataDir, sSharePath);
+  if (nullptr != pPlugin) {
+    qobject_cast<IEditorPlugin *>(pPlugin)->initPlugin(
+          nullptr, nullptr, m_UserDataDir, sSharePath, m_pRenderService);
+    auto *pSpellChecker = qobject_cast<ISpellChecker *>(pPlugin);
+    if (nullptr != pSpellChecker && pSpellChecker->initSpellCheck()) {
+      m_pSpellChecker = pSpellChecker;
+    }
+  }
+}
+
+BatchSpellChecker::~BatchSpellChecker() {
+  delete m_pRenderService;
+  m_pRenderService = nullptr;
+  delete m_pTemplates;
+  m_pTemplates = nullptr;
+  delete m_pSettings;
+  m_pSettings = nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto BatchSpellChecker::check(const QStringList &sListInput,
+                              const QString &sReport,
+                              const int nJobs) -> int {
+  if (nullptr == m_pSpellChecker) {
+    qWarning() << "Spell checker not available";
+    return 1;
+  }
+
+  SpellJob job;
+  const QList<QPair<QString, QString>> listFiles(
+        BatchRenderer::collectFiles(sListInput));
+  for (const auto &file : listFiles) {
+    job.sListFiles << file.first;
+  }
+  if (job.sListFiles.isEmpty()) {
+    qWarning() << "No files to check:" << sListInput;
+    return 1;
+  }
+  QVector<QStringList> listReports(job.sListFiles.size());
+  job.pSpellChecker = m_pSpellChecker;
+  job.pReports = listReports.data();
+
+  QElapsedTimer timer;
+  timer.start();
+  QThreadPool pool;
+  const int nThreads = qMax(1, qMin(nJobs > 0 ? nJobs :
+                                    QThread::idealThreadCount(),
+                                    job.sListFiles.size()));
+  pool.setMaxThreadCount(nThreads);
+  for (int i = 0; i < nThreads; i++) {
+    pool.start(new SpellWorker(&job));
+  }
+  pool.waitForDone();
+
+  // Report in order of input files
+  QFile outFile;
+  if (sReport.isEmpty()) {
+    if (!outFile.open(stdout, QIODevice::WriteOnly)) {
+      return job.sListFiles.size();
+    }
+  } else {
+    outFile.setFileName(sReport);
+    if (!outFile.open(QFile::WriteOnly | QFile::Text)) {
+      qWarning() << "Could not write" << sReport << outFile.errorString();
+      return job.sListFiles.size();
+    }
+  }
+  QTextStream out(&outFile);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+  // Since Qt 6 UTF-8 is used by default
+  out.setCodec("UTF-8");
+#endif
+  out << "file\tline\tword\tsuggestions\n";
+  for (const auto &sListReport : qAsConst(listReports)) {
+    for (const auto &sLine : sListReport) {
+      out << sLine << "\n";
+    }
+  }
+  out.flush();
+  outFile.close();
+
+  const int nFailed = job.nFailed.loadAcquire();
+  qInfo().noquote() << QStringLiteral("Checked %1 of %2 files, %3 unknown "
+                                      "words, in %4 ms (%5 threads)")
+                       .arg(job.sListFiles.size() - nFailed)
+                       .arg(job.sListFiles.size())
+                       .arg(job.nUnknown.loadAcquire())
+                       .arg(timer.elapsed())
+                       .arg(nThreads);
+  return nFailed;
+}
@@ -0,0 +1,71 @@
+/**
+ * \file batchspellchecker.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for headless spell checking of articles (command line).
+ */
+
+#ifndef APPLICATION_BATCHSPELLCHECKER_H_
+#define APPLICATION_BATCHSPELLCHECKER_H_
+
+#include <QDir>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class IRenderService;
+class ISpellChecker;
+class Settings;
+class Templates;
+
+/**
+ * \class BatchSpellChecker
+ * \brief Spell check Inyoka articles without GUI, files checked in parallel
+ *
+ * Uses the spell checker plugin with language, user word list and
+ * community dictionary as configured for the GUI. Each thread uses its
+ * own dictionary instance, verdicts and suggestions are cached for all.
+ * Report: One tab separated line per unknown word (file, line, word,
+ * suggestions).
+ */
+class BatchSpellChecker : public QObject {
+  Q_OBJECT
+
+ public:
+    BatchSpellChecker(const QString &sSharePath, const QDir &userDataDir,
+                      QObject *pParent = nullptr);
+    ~BatchSpellChecker();
+
+    // Input: Files and/or folders; report to stdout if sReport is empty;
+    // returns number of files which could not be checked
+    auto check(const QStringList &sListInput, const QString &sReport,
+               const int nJobs) -> int;
+
+ private:
+    const QDir m_UserDataDir;
+    Settings *m_pSettings;
+    Templates *m_pTemplates;
+    IRenderService *m_pRenderService;
+    ISpellChecker *m_pSpellChecker;  // nullptr if not available
+};
+
+#endif  // APPLICATION_BATCHSPELLCHECKER_H_
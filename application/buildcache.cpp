@@ -0,0 +1,246 @@
+/**
+ * \file buildcache.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Record inputs of rendered articles for incremental rendering.
+ */
+
+#include "./buildcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QSaveFile>
+
+#include "./templates/templates.h"
+
+BuildCache::BuildCache(const QString &sCacheFile,
+                       const Templates *pTemplates, const QString &sSettings)
+  : m_sCacheFile(sCacheFile),
+    m_baCommunity(BuildCache::communityVersion(pTemplates, sSettings)),
+    m_bModified(false) {
+  const QStringList sListNames(pTemplates->getListTplNamesINY());
+  const QStringList sListTemplates(pTemplates->getListTemplatesINY());
+  for (int i = 0; i < sListNames.size() && i < sListTemplates.size(); i++) {
+    m_TemplateVersions.insert(sListNames[i].toLower(),
+                              BuildCache::hash(sListTemplates[i].toUtf8()));
+  }
+  this->load();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto BuildCache::isUpToDate(const QString &sSource,
+                            const QByteArray &baSourceHash,
+                            const QString &sOutput) const -> bool {
+  QMutexLocker locker(&m_mutex);
+  auto it = m_Entries.constFind(sSource);
+  if (it == m_Entries.constEnd() || it->baSource != baSourceHash ||
+      it->sOutput != sOutput || !QFile::exists(sOutput)) {
+    return false;
+  }
+  for (auto tpl = it->templates.constBegin(); tpl != it->templates.constEnd();
+       ++tpl) {
+    if (m_TemplateVersions.value(tpl.key()) != tpl.value()) {
+      return false;
+    }
+  }
+  for (auto img = it->images.constBegin(); img != it->images.constEnd();
+       ++img) {
+    if (BuildCache::imageStamp(img.key()) != img.value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void BuildCache::update(const QString &sSource,
+                        const QByteArray &baSourceHash,
+                        const QString &sOutput,
+                        const QStringList &sListTemplates,
+                        const QString &sHtml) {
+  Entry entry;
+  entry.baSource = baSourceHash;
+  entry.sOutput = sOutput;
+  const QStringList sListImages(BuildCache::findImages(sHtml));
+  for (const auto &sImage : sListImages) {
+    entry.images.insert(sImage, BuildCache::imageStamp(sImage));
+  }
+
+  QMutexLocker locker(&m_mutex);
+  for (const auto &sTpl : sListTemplates) {
+    // Built-in templates have no version (covered by app version)
+    entry.templates.insert(sTpl.toLower(),
+                           m_TemplateVersions.value(sTpl.toLower()));
+  }
+  m_Entries.insert(sSource, entry);
+  m_bModified = true;
+}
+
+// ----------------------------------------------------------------------------
+
+auto BuildCache::isModified() const -> bool {
+  QMutexLocker locker(&m_mutex);
+  return m_bModified;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void BuildCache::load() {
+  QFile cacheFile(m_sCacheFile);
+  if (!cacheFile.open(QIODevice::ReadOnly)) {
+    return;  // First build
+  }
+  const QJsonObject root(QJsonDocument::fromJson(cacheFile.readAll()).object());
+  cacheFile.close();
+
+  if (root.value(QStringLiteral("version")).toInt() != m_cVERSION ||
+      root.value(QStringLiteral("community")).toString().toLatin1() !=
+      m_baCommunity) {
+    qDebug() << "Community or settings changed - rendering all files";
+    return;
+  }
+
+  const QJsonObject files(root.value(QStringLiteral("files")).toObject());
+  for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+    const QJsonObject obj(it.value().toObject());
+    Entry entry;
+    entry.baSource = obj.value(QStringLiteral("source")).toString().toLatin1();
+    entry.sOutput = obj.value(QStringLiteral("output")).toString();
+    const QJsonObject templates(
+          obj.value(QStringLiteral("templates")).toObject());
+    for (auto tpl = templates.constBegin(); tpl != templates.constEnd();
+         ++tpl) {
+      entry.templates.insert(tpl.key(), tpl.value().toString().toLatin1());
+    }
+    const QJsonObject images(obj.value(QStringLiteral("images")).toObject());
+    for (auto img = images.constBegin(); img != images.constEnd(); ++img) {
+      entry.images.insert(img.key(), img.value().toString());
+    }
+    m_Entries.insert(it.key(), entry);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+auto BuildCache::save() -> bool {
+  QJsonObject files;
+  {
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_Entries.constBegin(); it != m_Entries.constEnd(); ++it) {
+      QJsonObject templates;
+      for (auto tpl = it->templates.constBegin();
+           tpl != it->templates.constEnd(); ++tpl) {
+        templates.insert(tpl.key(), QString::fromLatin1(tpl.value()));
+      }
+      QJsonObject images;
+      for (auto img = it->images.constBegin(); img != it->images.constEnd();
+           ++img) {
+        images.insert(img.key(), img.value());
+      }
+      QJsonObject obj;
+      obj.insert(QStringLiteral("source"), QString::fromLatin1(it->baSource));
+      obj.insert(QStringLiteral("output"), it->sOutput);
+      obj.insert(QStringLiteral("templates"), templates);
+      obj.insert(QStringLiteral("images"), images);
+      files.insert(it.key(), obj);
+    }
+    m_bModified = false;
+  }
+
+  QJsonObject root;
+  root.insert(QStringLiteral("version"), m_cVERSION);
+  root.insert(QStringLiteral("community"), QString::fromLatin1(m_baCommunity));
+  root.insert(QStringLiteral("files"), files);
+
+  // Written atomically, an aborted build keeps the old cache
+  QSaveFile cacheFile(m_sCacheFile);
+  if (!cacheFile.open(QIODevice::WriteOnly)) {
+    qWarning() << "Could not write build cache:" << m_sCacheFile
+               << cacheFile.errorString();
+    return false;
+  }
+  cacheFile.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+  return cacheFile.commit();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto BuildCache::hash(const QByteArray &baData) -> QByteArray {
+  return QCryptographicHash::hash(baData, QCryptographicHash::Sha1).toHex();
+}
+
+// ----------------------------------------------------------------------------
+
+// Everything except the templates, which are tracked per article
+auto BuildCache::communityVersion(const Templates *pTemplates,
+                                  const QString &sSettings) -> QByteArray {
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  // Built-in templates and macros.conf are part of the application
+  hash.addData(QByteArrayLiteral(APP_VERSION));
+  hash.addData(sSettings.toUtf8());
+  hash.addData(pTemplates->getVersion(false));
+  return hash.result().toHex();
+}
+
+// ----------------------------------------------------------------------------
+
+// Local files referenced in generated HTML (images, icons)
+auto BuildCache::findImages(const QString &sHtml) -> QStringList {
+  QRegularExpression findSrc(QStringLiteral("src=\"([^\"]+)\""));
+  QRegularExpression localPath(QStringLiteral("^(/|[A-Za-z]:[/\\\\])"));
+  QStringList sListImages;
+
+  QRegularExpressionMatchIterator it = findSrc.globalMatch(sHtml);
+  while (it.hasNext()) {
+    QString sPath(it.next().captured(1));
+    if (sPath.startsWith(QLatin1String("file://"))) {
+      sPath.remove(0, 7);
+    }
+    if (localPath.match(sPath).hasMatch() && !sListImages.contains(sPath)) {
+      sListImages << sPath;
+    }
+  }
+  return sListImages;
+}
+
+// ----------------------------------------------------------------------------
+
+auto BuildCache::imageStamp(const QString &sPath) -> QString {
+  const QFileInfo fi(sPath);
+  if (!fi.exists()) {
+    return QStringLiteral("-");  // Rendering may change once it exists
+  }
+  return QString::number(fi.size()) + ":" +
+      QString::number(fi.lastModified().toMSecsSinceEpoch());
+}
@@ -0,0 +1,89 @@
+/**
+ * \file buildcache.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for dependency cache of rendered articles.
+ */
+
+#ifndef APPLICATION_BUILDCACHE_H_
+#define APPLICATION_BUILDCACHE_H_
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+class Templates;
+
+/**
+ * \class BuildCache
+ * \brief Inputs of each rendered article (source, templates, images)
+ *
+ * An article is only rendered again if one of its inputs or the community
+ * configuration changed. Lookups and updates are thread safe.
+ */
+class BuildCache {
+ public:
+    BuildCache(const QString &sCacheFile, const Templates *pTemplates,
+               const QString &sSettings);
+
+    auto isUpToDate(const QString &sSource, const QByteArray &baSourceHash,
+                    const QString &sOutput) const -> bool;
+    void update(const QString &sSource, const QByteArray &baSourceHash,
+                const QString &sOutput, const QStringList &sListTemplates,
+                const QString &sHtml);
+    // Entries updated since loading / last save
+    auto isModified() const -> bool;
+    auto save() -> bool;
+
+    static auto hash(const QByteArray &baData) -> QByteArray;
+
+ private:
+    /**
+     * \struct Entry
+     * \brief Inputs of one article at time of rendering
+     */
+    struct Entry {
+      QByteArray baSource;
+      QString sOutput;
+      QHash<QString, QByteArray> templates;  // Name (lower case), version
+      QHash<QString, QString> images;  // Path, stamp
+    };
+
+    void load();
+    static auto communityVersion(const Templates *pTemplates,
+                                 const QString &sSettings) -> QByteArray;
+    static auto findImages(const QString &sHtml) -> QStringList;
+    static auto imageStamp(const QString &sPath) -> QString;
+
+    static const int m_cVERSION = 1;
+
+    const QString m_sCacheFile;
+    QByteArray m_baCommunity;
+    QHash<QString, QByteArray> m_TemplateVersions;
+    QHash<QString, Entry> m_Entries;
+    bool m_bModified;
+    mutable QMutex m_mutex;
+};
+
+#endif  // APPLICATION_BUILDCACHE_H_
@@ -0,0 +1,76 @@
+// Live reload of InyokaEdit preview (builds without integrated preview).
+// Placeholders are replaced by PreviewServer.
+(function () {
+  'use strict';
+  var version = %VERSION%;
+  var base = '%BASE%';
+
+  function sameAttributes(oldElem, newElem) {
+    if (oldElem.attributes.length !== newElem.attributes.length) {
+      return false;
+    }
+    for (var i = 0; i < newElem.attributes.length; i++) {
+      var attr = newElem.attributes[i];
+      if (oldElem.getAttribute(attr.name) !== attr.value) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Replace changed nodes only, unchanged blocks (and scroll position) stay
+  function patch(oldNode, newNode) {
+    if (oldNode.nodeType !== newNode.nodeType ||
+        oldNode.nodeName !== newNode.nodeName ||
+        (1 === oldNode.nodeType && !sameAttributes(oldNode, newNode))) {
+      oldNode.parentNode.replaceChild(document.importNode(newNode, true),
+                                      oldNode);
+      return;
+    }
+    if (1 !== oldNode.nodeType) {
+      if (oldNode.nodeValue !== newNode.nodeValue) {
+        oldNode.nodeValue = newNode.nodeValue;
+      }
+      return;
+    }
+    if (oldNode.isEqualNode(newNode)) {
+      return;
+    }
+    var oldChildren = oldNode.childNodes;
+    var newChildren = newNode.childNodes;
+    for (var i = 0; i < newChildren.length; i++) {
+      if (i < oldChildren.length) {
+        patch(oldChildren[i], newChildren[i]);
+      } else {
+        oldNode.appendChild(document.importNode(newChildren[i], true));
+      }
+    }
+    while (oldChildren.length > newChildren.length) {
+      oldNode.removeChild(oldNode.lastChild);
+    }
+  }
+
+  function update() {
+    var request = new XMLHttpRequest();
+    request.open('GET', base);
+    request.onload = function () {
+      if (200 !== request.status) {
+        return;
+      }
+      var doc = new DOMParser().parseFromString(request.responseText,
+                                                'text/html');
+      document.title = doc.title;
+      patch(document.body, doc.body);
+    };
+    request.send();
+  }
+
+  var events = new EventSource(base + 'events');
+  events.onmessage = function (event) {
+    var newVersion = Number(event.data);
+    if (newVersion > version) {
+      version = newVersion;
+      update();
+    }
+  };
+})();
@@ -0,0 +1,151 @@
+/**
+ * \file diagnostics.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Show parse stage timings and counters of the last previews.
+ */
+
+#include "./diagnostics.h"
+
+#include <QDebug>
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+Diagnostics::Diagnostics(QWidget *pParent)
+  : QDialog(pParent),
+    m_pTree(new QTreeWidget(this)) {
+  // Counters and stage timers are cheap, so that the last previews are
+  // always available, not only while the dialog is open
+  ParseStatistics::setEnabled(true);
+  this->setWindowTitle(tr("Parser diagnostics"));
+  this->resize(600, 450);
+
+  m_pTree->setColumnCount(3);
+  m_pTree->setHeaderLabels(QStringList() << tr("Preview / stage")
+                           << tr("Value") << tr("Share"));
+  m_pTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+  m_pTree->header()->setStretchLastSection(false);
+
+  auto *pButtons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+  connect(pButtons, &QDialogButtonBox::rejected, this, &QDialog::close);
+
+  auto *pLayout = new QVBoxLayout(this);
+  pLayout->addWidget(new QLabel(
+                       tr("Statistics of the last %n preview(s).", "",
+                          m_cMAXENTRIES), this));
+  pLayout->addWidget(m_pTree);
+  pLayout->addWidget(pButtons);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void Diagnostics::showEvent(QShowEvent *pEvent) {
+  this->updateTree();
+  QDialog::showEvent(pEvent);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void Diagnostics::addPreview(const PreviewStatistics &stats) {
+  // Ring buffer: Oldest entry is overwritten
+  if (m_listPreviews.size() < m_cMAXENTRIES) {
+    m_listPreviews << stats;
+  } else {
+    m_listPreviews[m_nNextEntry] = stats;
+  }
+  m_nNextEntry = (m_nNextEntry + 1) % m_cMAXENTRIES;
+
+  QStringList sListCounters;
+  for (int i = 0; i < stats.listCounters.size(); i++) {
+    sListCounters << ParseStatistics::getCounterName(i) + ": " +
+                     QString::number(stats.listCounters.at(i));
+  }
+  qDebug() << "Preview" << stats.sFile << "-" << stats.nLines << "lines,"
+           << Diagnostics::formatMsecs(Diagnostics::getTotal(stats)) << "ms"
+           << sListCounters;
+
+  if (this->isVisible()) {
+    this->updateTree();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void Diagnostics::updateTree() {
+  m_pTree->clear();
+
+  // Newest first
+  for (int n = 1; n <= m_listPreviews.size(); n++) {
+    const PreviewStatistics &stats(m_listPreviews.at(
+                                     (m_nNextEntry - n + m_cMAXENTRIES) %
+                                     m_cMAXENTRIES));
+    const qint64 nTotal = Diagnostics::getTotal(stats);
+    auto *pItem = new QTreeWidgetItem(m_pTree);
+    pItem->setText(0, stats.timestamp.toString(QStringLiteral("HH:mm:ss")) +
+                   " - " + stats.sFile + " (" +
+                   tr("%n line(s)", "", stats.nLines) + ")");
+    pItem->setText(1, Diagnostics::formatMsecs(nTotal) + " ms");
+
+    for (const auto &stage : stats.listStages) {
+      auto *pStage = new QTreeWidgetItem(pItem);
+      pStage->setText(0, stage.first);
+      pStage->setText(1, Diagnostics::formatMsecs(stage.second) + " ms");
+      if (nTotal > 0) {
+        pStage->setText(2, QString::number(100.0 * stage.second / nTotal,
+                                           'f', 1) + " %");
+      }
+    }
+    for (int i = 0; i < stats.listCounters.size(); i++) {
+      auto *pCounter = new QTreeWidgetItem(pItem);
+      pCounter->setText(0, ParseStatistics::getCounterName(i));
+      pCounter->setText(1, QString::number(stats.listCounters.at(i)));
+    }
+  }
+
+  if (m_pTree->topLevelItemCount() > 0) {
+    m_pTree->topLevelItem(0)->setExpanded(true);
+  }
+  m_pTree->resizeColumnToContents(1);
+  m_pTree->resizeColumnToContents(2);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto Diagnostics::getTotal(const PreviewStatistics &stats) -> qint64 {
+  qint64 nTotal = 0;
+  for (const auto &stage : stats.listStages) {
+    nTotal += stage.second;
+  }
+  return nTotal;
+}
+
+// ----------------------------------------------------------------------------
+
+auto Diagnostics::formatMsecs(const qint64 nNsecs) -> QString {
+  return QString::number(nNsecs / 1e6, 'f', 2);
+}
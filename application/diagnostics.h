@@ -0,0 +1,65 @@
+/**
+ * \file diagnostics.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for parser diagnostics dialog.
+ */
+
+#ifndef APPLICATION_DIAGNOSTICS_H_
+#define APPLICATION_DIAGNOSTICS_H_
+
+#include <QDialog>
+#include <QVector>
+
+#include "./parser/parsestatistics.h"
+
+class QShowEvent;
+class QTreeWidget;
+
+/**
+ * \class Diagnostics
+ * \brief Timings and counters of the last generated previews
+ */
+class Diagnostics : public QDialog {
+  Q_OBJECT
+
+ public:
+    explicit Diagnostics(QWidget *pParent = nullptr);
+
+    void addPreview(const PreviewStatistics &stats);
+
+ protected:
+    void showEvent(QShowEvent *pEvent) override;
+
+ private:
+    void updateTree();
+    static auto getTotal(const PreviewStatistics &stats) -> qint64;
+    static auto formatMsecs(const qint64 nNsecs) -> QString;
+
+    static const int m_cMAXENTRIES = 20;
+
+    QTreeWidget *m_pTree;
+    QVector<PreviewStatistics> m_listPreviews;
+    int m_nNextEntry{};  // Slot overwritten by next preview
+};
+
+#endif  // APPLICATION_DIAGNOSTICS_H_
@@ -35,6 +35,7 @@
 
 #include "./downloadimg.h"
 #include "./session.h"
+#include "./trace/trace.h"
 #include "./utils.h"
 
 Download::Download(QWidget *pParent, Session *pSession,
@@ -136,6 +137,7 @@ void Download::downloadArticle(QString sUrl) {
                        QNetworkRequest::ManualRedirectPolicy);
   m_urlRedirectedTo = sUrl;
   QNetworkReply *reply = m_pSession->getNwManager()->get(request);
+  Trace::asyncReply(reply, "network", "Download article");
   m_listDownloadReplies.append(reply);
 }
 
@@ -151,6 +153,7 @@ void Download::downloadImages() {
   request.setOriginatingObject(this);
   m_urlRedirectedTo = sUrl;
   QNetworkReply *reply = m_pSession->getNwManager()->get(request);
+  Trace::asyncReply(reply, "network", "Download meta data");
   m_listDownloadReplies.append(reply);
 }
 
@@ -34,6 +34,8 @@
 #include <QNetworkReply>
 #include <QProgressDialog>
 
+#include "./trace/trace.h"
+
 DownloadImg::DownloadImg(QNetworkAccessManager* pNwManager, QObject *pObj)
   : m_pNwManager(pNwManager),
     m_pProgessDialog(nullptr),
@@ -94,6 +96,7 @@ void DownloadImg::doDownload(const QUrl &url,
   request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
                        QNetworkRequest::NoLessSafeRedirectPolicy);
   QNetworkReply *reply = m_pNwManager->get(request);
+  Trace::asyncReply(reply, "network", "Download image");
 
   m_listDownloadReplies.append(reply);
   m_sListRepliesPath.append(sSavePath);
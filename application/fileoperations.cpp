@@ -48,6 +48,7 @@
 #include "./findreplace.h"
 #include "./settings.h"
 #include "./texteditor.h"
+#include "./trace/trace.h"
 
 #if defined __linux__
 #define _LARGEFILE64_SOURCE 1
@@ -321,6 +322,7 @@ void FileOperations::loadFile(const QString &sFileName,
 // ----------------------------------------------------------------------------
 
 void FileOperations::loadInyArchive(const QString &sArchive) {
+  TraceSpan span("archive", "loadInyArchive");
   QString sArticle(QLatin1String(""));
   QString sOutput;
   QFileInfo file(sArchive);
@@ -408,6 +410,7 @@ void FileOperations::loadInyArchive(const QString &sArchive) {
 // ----------------------------------------------------------------------------
 
 auto FileOperations::saveFile(QString sFileName) -> bool {
+  TraceSpan span("file", "saveFile");
   QFile file;
   if (sFileName.endsWith(QLatin1String(".inyzip"))) {
     // Special characters not allowed for miniz achives
@@ -474,6 +477,7 @@ auto FileOperations::saveFile(QString sFileName) -> bool {
 // ----------------------------------------------------------------------------
 
 auto FileOperations::saveInyArchive(const QString &sArchive) -> bool {
+  TraceSpan span("archive", "saveInyArchive");
   QFileInfo file(sArchive);
   QString sArticle(file.baseName() + ".iny");
   QByteArray baComment("");
@@ -586,6 +590,7 @@ auto FileOperations::saveInyArchive(const QString &sArchive) -> bool {
 // ----------------------------------------------------------------------------
 
 void FileOperations::saveDocumentAuto() {
+  TraceSpan span("autosave", "saveDocumentAuto");
   if (!m_bCloseApp) {
     qDebug() << "Calling" << Q_FUNC_INFO;
     QFile fAutoSave;
@@ -909,3 +914,23 @@ auto FileOperations::getCurrentEditor() -> TextEditor* {
 auto FileOperations::getEditors() const -> QList<TextEditor *> {
   return m_pListEditors;
 }
+
+// ----------------------------------------------------------------------------
+
+// Switch to tab of already opened file, otherwise load it
+auto FileOperations::showFile(const QString &sFileName) -> TextEditor* {
+  const QString sAbsFile(QFileInfo(sFileName).absoluteFilePath());
+  for (auto *pEditor : qAsConst(m_pListEditors)) {
+    if (QFileInfo(pEditor->getFileName()).absoluteFilePath() == sAbsFile) {
+      m_pDocumentTabs->setCurrentWidget(pEditor);
+      return pEditor;
+    }
+  }
+
+  const int nEditors = m_pListEditors.size();
+  this->loadFile(sFileName, true);
+  if (m_pListEditors.size() > nEditors) {
+    return m_pCurrentEditor;
+  }
+  return nullptr;  // Not loaded
+}
@@ -55,6 +55,8 @@ class FileOperations : public QObject {
 
     auto getCurrentEditor() -> TextEditor*;
     auto getEditors() const -> QList<TextEditor *>;
+    // Switch to editor of file, file is loaded if not opened yet
+    auto showFile(const QString &sFileName) -> TextEditor*;
     auto getCurrentFile() const -> QString;
     auto maybeSave() -> bool;
     auto getLastOpenedFiles() const -> QList<QAction *>;
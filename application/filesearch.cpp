@@ -0,0 +1,487 @@
+/**
+ * \file filesearch.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * \section DESCRIPTION
+ * Search and replace in all open documents and article files of a folder.
+ */
+
+#include "./filesearch.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSet>
+#include <QTextDocument>
+#include <QTextStream>
+
+#include "./texteditor.h"
+#include "./trace/trace.h"
+#include "./3rdparty/miniz/miniz.h"
+
+struct FileSearchItem {
+  QString sFile;
+  int nTab;
+  QString sText;  // Open documents only
+  bool bOpened;  // File on disk, which is opened in an editor
+  bool bIndex;  // Index entry of file has to be created
+};
+
+struct FileSearchJob {
+  int nJob;
+  FileSearchOptions options;
+  QList<FileSearchItem> listItems;
+  QAtomicInt nNext;
+  QAtomicInt nRunning;
+  QAtomicInt nCanceled;
+};
+
+/**
+ * \class FileSearchWorker
+ * \brief Takes files from job until all are searched or job is stopped
+ */
+class FileSearchWorker : public QRunnable {
+ public:
+    FileSearchWorker(FileSearch *pSearch,
+                     const QSharedPointer<FileSearchJob> &pJob)
+      : m_pSearch(pSearch),
+        m_pJob(pJob) {
+    }
+
+    void run() override {
+      for (int i = m_pJob->nNext.fetchAndAddRelaxed(1);
+           i < m_pJob->listItems.size() &&
+           0 == m_pJob->nCanceled.loadAcquire();
+           i = m_pJob->nNext.fetchAndAddRelaxed(1)) {
+        const FileSearchResult result(
+              this->searchItem(m_pJob->listItems.at(i)));
+        QMetaObject::invokeMethod(m_pSearch, "addResult",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(FileSearchResult, result));
+      }
+
+      // Last worker reports end of job (after all results)
+      if (1 == m_pJob->nRunning.fetchAndAddOrdered(-1)) {
+        QMetaObject::invokeMethod(m_pSearch, "finishedJob",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(int, m_pJob->nJob));
+      }
+    }
+
+ private:
+    auto searchItem(const FileSearchItem &item) const -> FileSearchResult {
+      const FileSearchOptions &options = m_pJob->options;
+      FileSearchResult result;
+      result.nJob = m_pJob->nJob;
+      result.sFile = item.sFile;
+      result.nTab = item.nTab;
+
+      QString sText(item.sText);
+      bool bRoundTrip = false;
+      if (item.nTab < 0 &&
+          !FileSearch::readArticle(item.sFile, &sText, &bRoundTrip)) {
+        result.sError = FileSearch::tr("File could not be read.");
+        return result;
+      }
+      if (item.bIndex) {
+        result.entry = TrigramIndex::createEntry(QFileInfo(item.sFile),
+                                                 sText);
+        result.bIndexed = true;
+      }
+
+      const bool bArchive = item.sFile.endsWith(QLatin1String(".inyzip"));
+      if (!options.bReplace || bArchive || item.bOpened || !bRoundTrip) {
+        result.listHits = FileSearch::searchText(sText, options);
+        if (options.bReplace && !result.listHits.isEmpty()) {
+          if (bArchive) {
+            result.sError = FileSearch::tr("Archives are not changed.");
+          } else if (item.bOpened) {
+            result.sError = FileSearch::tr(
+                              "File is opened in editor, not changed.");
+          } else {
+            result.sError = FileSearch::tr(
+                              "File is not plain UTF-8, not changed.");
+          }
+        }
+        return result;
+      }
+
+      QString sReplaced;
+      result.listHits = FileSearch::searchText(sText, options, nullptr,
+                                               &sReplaced);
+      if (result.listHits.isEmpty()) {
+        return result;
+      }
+      QSaveFile file(item.sFile);
+      // Without text mode, read text equals bytes on disk (see above)
+      if (!file.open(QIODevice::WriteOnly) ||
+          file.write(sReplaced.toUtf8()) < 0 || !file.commit()) {
+        result.sError = FileSearch::tr("File could not be written:") +
+                        " " + file.errorString();
+        result.listHits = FileSearch::searchText(sText, options);
+      } else {
+        result.bReplaced = true;
+        result.bIndexed = false;
+      }
+      return result;
+    }
+
+    FileSearch *m_pSearch;
+    const QSharedPointer<FileSearchJob> m_pJob;
+};
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+FileSearch::FileSearch(const QString &sIndexDir, QObject *pParent)
+  : QObject(pParent),
+    m_sIndexDir(sIndexDir),
+    m_nJob(0),
+    m_pIndex(nullptr),
+    m_nFiles(0),
+    m_nSkipped(0),
+    m_nHits(0) {
+  qRegisterMetaType<FileSearchResult>("FileSearchResult");
+}
+
+FileSearch::~FileSearch() {
+  this->stop();
+  // Workers are using this object
+  m_pool.waitForDone();
+  delete m_pIndex;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void FileSearch::start(const FileSearchOptions &options,
+                       const QList<TextEditor *> &listEditors) {
+  TraceSpan span("search", "startFileSearch");
+  this->stop();
+  m_nJob++;
+  m_nFiles = 0;
+  m_nSkipped = 0;
+  m_nHits = 0;
+  QSharedPointer<FileSearchJob> pJob(new FileSearchJob);
+  pJob->nJob = m_nJob;
+  pJob->options = options;
+
+  QSet<QString> setOpened;
+  for (int i = 0; i < listEditors.size(); i++) {
+    TextEditor *pEditor = listEditors.at(i);
+    const QFileInfo fi(pEditor->getFileName());
+    if (fi.exists()) {
+      setOpened << fi.absoluteFilePath();
+    }
+    if (!options.bTabs) {
+      continue;
+    }
+
+    m_nFiles++;
+    if (options.bReplace) {
+      // Documents are changed in GUI thread, one undo step each
+      FileSearchResult result;
+      result.nJob = m_nJob;
+      result.sFile = pEditor->getFileName();
+      result.nTab = i;
+      QList<TextMatch> listMatches;
+      QString sReplaced;
+      result.listHits = FileSearch::searchText(pEditor->toPlainText(),
+                                               options, &listMatches,
+                                               &sReplaced);
+      FindReplace::replaceMatches(pEditor->document(), listMatches);
+      result.bReplaced = !listMatches.isEmpty();
+      this->addResult(result);
+    } else {
+      pJob->listItems << FileSearchItem{pEditor->getFileName(), i,
+                                        pEditor->toPlainText(),
+                                        false, false};
+    }
+  }
+
+  if (!options.sDir.isEmpty()) {
+    const QStringList sListFiles(FileSearch::collectFiles(options.sDir));
+    QVector<quint32> listQuery;
+    if (options.bUseIndex) {
+      this->loadIndex(options.sDir);
+      QSet<QString> setFiles;
+      for (const auto &sFile : sListFiles) {
+        setFiles << sFile;
+      }
+      m_pIndex->removeMissing(setFiles);
+      // Regular expressions can't be checked against index
+      if (!options.bRegexp) {
+        listQuery = TrigramIndex::trigrams(options.sSearch);
+      }
+    }
+
+    for (const auto &sFile : sListFiles) {
+      const bool bOpened = setOpened.contains(sFile);
+      if (bOpened && options.bTabs) {
+        continue;  // Current text in editor is searched instead
+      }
+      FileSearchItem item{sFile, -1, QString(), bOpened, false};
+      if (options.bUseIndex) {
+        if (!m_pIndex->isUpToDate(QFileInfo(sFile))) {
+          item.bIndex = true;
+        } else if (!m_pIndex->mayContain(sFile, listQuery)) {
+          m_nSkipped++;
+          continue;
+        }
+      }
+      pJob->listItems << item;
+    }
+  }
+
+  m_nFiles += pJob->listItems.size();
+  m_pJob = pJob;
+  const int nThreads = qMax(1, qMin(m_pool.maxThreadCount(),
+                                    static_cast<int>(
+                                      pJob->listItems.size())));
+  pJob->nRunning.storeRelease(nThreads);
+  for (int i = 0; i < nThreads; i++) {
+    m_pool.start(new FileSearchWorker(this, pJob));
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void FileSearch::stop() {
+  if (m_pJob.isNull()) {
+    return;
+  }
+  m_pJob->nCanceled.storeRelease(1);
+  m_pJob.clear();
+  m_nJob++;  // Pending results of stopped job are ignored
+  if (nullptr != m_pIndex) {
+    m_pIndex->save();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+auto FileSearch::isRunning() const -> bool {
+  return !m_pJob.isNull();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void FileSearch::addResult(const FileSearchResult &result) {
+  if (result.nJob != m_nJob) {
+    return;
+  }
+  if (nullptr != m_pIndex && result.nTab < 0) {
+    if (result.bReplaced) {
+      m_pIndex->remove(result.sFile);
+    } else if (result.bIndexed) {
+      m_pIndex->update(result.sFile, result.entry);
+    }
+  }
+
+  if (!result.listHits.isEmpty() || !result.sError.isEmpty()) {
+    m_nHits += result.listHits.size();
+    emit this->found(result);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void FileSearch::finishedJob(const int nJob) {
+  if (nJob != m_nJob || m_pJob.isNull()) {
+    return;
+  }
+  m_pJob.clear();
+  if (nullptr != m_pIndex) {
+    m_pIndex->save();
+  }
+  emit this->finished(m_nFiles, m_nSkipped, m_nHits);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void FileSearch::loadIndex(const QString &sDir) {
+  const QString sAbsDir(QDir(sDir).absolutePath());
+  if (nullptr != m_pIndex && sAbsDir == m_sIndexedDir) {
+    return;
+  }
+
+  delete m_pIndex;
+  m_sIndexedDir = sAbsDir;
+  m_pIndex = new TrigramIndex(
+               m_sIndexDir + "/" + QCryptographicHash::hash(
+                 sAbsDir.toUtf8(), QCryptographicHash::Md5).toHex() +
+               ".idx");
+  m_pIndex->load();
+}
+
+// ----------------------------------------------------------------------------
+
+auto FileSearch::collectFiles(const QString &sDir) -> QStringList {
+  QStringList sListFiles;
+  QDirIterator it(sDir, QStringList() << QStringLiteral("*.iny") <<
+                  QStringLiteral("*.inyoka") << QStringLiteral("*.inyzip"),
+                  QDir::Files, QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    sListFiles << it.fileInfo().absoluteFilePath();
+  }
+  sListFiles.sort();
+  return sListFiles;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto FileSearch::readArticle(const QString &sFile, QString *pText,
+                             bool *pRoundTrip) -> bool {
+  if (nullptr != pRoundTrip) {
+    *pRoundTrip = false;
+  }
+  if (!sFile.endsWith(QLatin1String(".inyzip"))) {
+    QFile file(sFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+      return false;
+    }
+    const QByteArray baRaw(file.readAll());
+
+    // Decoded like an opened file (see FileOperations::loadFile)
+    QTextStream in(baRaw, QIODevice::ReadOnly | QIODevice::Text);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    // Since Qt 6 UTF-8 is used by default
+    in.setCodec("UTF-8");
+#endif
+    in.setAutoDetectUnicode(true);
+    *pText = in.readAll();
+
+    // BOM, UTF-16, CRLF or invalid UTF-8 would be lost by writing back
+    if (nullptr != pRoundTrip) {
+      *pRoundTrip = (pText->toUtf8() == baRaw);
+    }
+    return true;
+  }
+
+  // Only article of archive is searched, not images
+  mz_zip_archive archive;
+  memset(&archive, 0, sizeof(archive));
+  if (!mz_zip_reader_init_file(&archive, QFile::encodeName(sFile), 0)) {
+    return false;
+  }
+  bool bFound = false;
+  const mz_uint nCount = mz_zip_reader_get_num_files(&archive);
+  for (mz_uint i = 0; i < nCount && !bFound; i++) {
+    mz_zip_archive_file_stat fileStat;
+    if (!mz_zip_reader_file_stat(&archive, i, &fileStat)) {
+      break;
+    }
+    const QString sName(QString::fromLatin1(fileStat.m_filename));
+    if (sName.endsWith(QLatin1String(".iny")) ||
+        sName.endsWith(QLatin1String(".inyoka"))) {
+      size_t nSize = 0;
+      void *pData = mz_zip_reader_extract_to_heap(&archive, i, &nSize, 0);
+      if (nullptr == pData) {
+        break;
+      }
+      *pText = QString::fromUtf8(static_cast<const char *>(pData),
+                                 static_cast<int>(nSize));
+      pText->replace(QLatin1String("\r\n"), QLatin1String("\n"));
+      mz_free(pData);
+      bFound = true;
+    }
+  }
+  mz_zip_reader_end(&archive);
+  return bFound;
+}
+
+// ----------------------------------------------------------------------------
+
+auto FileSearch::searchText(const QString &sText,
+                            const FileSearchOptions &options,
+                            QList<TextMatch> *pMatches,
+                            QString *pReplacedText) -> QList<FileSearchHit> {
+  const QList<TextMatch> listMatches(
+        FindReplace::findAll(sText, options.sSearch, options.sReplace,
+                             options.bCaseSens, options.bWholeWord,
+                             options.bRegexp));
+  if (nullptr != pMatches) {
+    *pMatches = listMatches;
+  }
+  if (nullptr == pReplacedText || !options.bReplace) {
+    return FileSearch::toHits(sText, listMatches);
+  }
+
+  // Same result as FindReplace::replaceMatches() in one pass
+  QString sReplaced;
+  sReplaced.reserve(sText.size());
+  QList<TextMatch> listReplaced;
+  int nLast = 0;
+  for (const auto &match : listMatches) {
+    sReplaced.append(sText.constData() + nLast, match.nPos - nLast);
+    listReplaced << TextMatch{static_cast<int>(sReplaced.size()),
+                              static_cast<int>(match.sReplacement.size()),
+                              QString()};
+    sReplaced += match.sReplacement;
+    nLast = match.nPos + match.nLength;
+  }
+  sReplaced.append(sText.constData() + nLast,
+                   static_cast<int>(sText.size()) - nLast);
+  *pReplacedText = sReplaced;
+  return FileSearch::toHits(sReplaced, listReplaced);
+}
+
+// ----------------------------------------------------------------------------
+
+// Line number and text of each match (sorted by position) in one pass
+auto FileSearch::toHits(
+    const QString &sText,
+    const QList<TextMatch> &listMatches) -> QList<FileSearchHit> {
+  static const int nMAXLINE = 200;
+  QList<FileSearchHit> listHits;
+  int nLine = 1;
+  int nLineStart = 0;
+  int nScanned = 0;
+  for (const auto &match : listMatches) {
+    for (; nScanned < match.nPos; nScanned++) {
+      if ('\n' == sText.at(nScanned)) {
+        nLine++;
+        nLineStart = nScanned + 1;
+      }
+    }
+    int nLineEnd = static_cast<int>(sText.indexOf('\n', match.nPos));
+    if (-1 == nLineEnd) {
+      nLineEnd = static_cast<int>(sText.size());
+    }
+    // Long lines are shortened around match
+    const int nStart = nLineEnd - nLineStart > nMAXLINE ?
+                         qMax(nLineStart, match.nPos - nMAXLINE / 4) :
+                         nLineStart;
+    listHits << FileSearchHit{match.nPos, match.nLength, nLine,
+                              sText.mid(nStart, qMin(nLineEnd - nStart,
+                                                     nMAXLINE)).trimmed()};
+  }
+  return listHits;
+}
@@ -0,0 +1,133 @@
+/**
+ * \file filesearch.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * \section DESCRIPTION
+ * Class definition for search and replace in open documents and files.
+ */
+
+#ifndef APPLICATION_FILESEARCH_H_
+#define APPLICATION_FILESEARCH_H_
+
+#include <QList>
+#include <QMetaType>
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+
+#include "./findreplace.h"
+#include "./trigramindex.h"
+
+class TextEditor;
+
+struct FileSearchHit {
+  int nPos;
+  int nLength;
+  int nLine;  // Starting with 1
+  QString sLineText;
+};
+
+struct FileSearchResult {
+  int nJob = 0;
+  QString sFile;
+  int nTab = -1;  // Index of open document, -1 for file on disk
+  QList<FileSearchHit> listHits;
+  QString sError;
+  bool bReplaced = false;
+  bool bIndexed = false;  // Entry contains trigrams of current file
+  TrigramEntry entry;
+};
+Q_DECLARE_METATYPE(FileSearchResult)
+
+struct FileSearchOptions {
+  QString sSearch;
+  QString sReplace;
+  bool bCaseSens = false;
+  bool bWholeWord = false;
+  bool bRegexp = false;
+  bool bReplace = false;
+  bool bTabs = true;
+  QString sDir;  // Articles in folder and subfolders, empty: none
+  bool bUseIndex = true;
+};
+
+struct FileSearchJob;
+
+/**
+ * \class FileSearch
+ * \brief Search (and replace) in open documents and article files
+ *
+ * Files are searched by worker threads, each result is reported as soon
+ * as a file is done. Replacing uses same matches as "Replace all" of
+ * find/replace dialog; open documents are changed in editor (one undo
+ * step each), files on disk are written directly.
+ */
+class FileSearch : public QObject {
+  Q_OBJECT
+
+ public:
+    explicit FileSearch(const QString &sIndexDir, QObject *pParent = nullptr);
+    ~FileSearch();
+
+    void start(const FileSearchOptions &options,
+               const QList<TextEditor *> &listEditors);
+    void stop();
+    auto isRunning() const -> bool;
+
+    // Articles (*.iny, *.inyoka, *.inyzip) of folder and subfolders
+    static auto collectFiles(const QString &sDir) -> QStringList;
+    // pRoundTrip: Text can be written back as UTF-8 without changing bytes
+    static auto readArticle(const QString &sFile, QString *pText,
+                            bool *pRoundTrip = nullptr) -> bool;
+    // With pReplacedText (and bReplace) hits are positions of replacements
+    static auto searchText(
+        const QString &sText, const FileSearchOptions &options,
+        QList<TextMatch> *pMatches = nullptr,
+        QString *pReplacedText = nullptr) -> QList<FileSearchHit>;
+
+ signals:
+    void found(const FileSearchResult &result);
+    void finished(const int nFiles, const int nSkipped, const int nHits);
+
+ private slots:
+    void addResult(const FileSearchResult &result);
+    void finishedJob(const int nJob);
+
+ private:
+    void loadIndex(const QString &sDir);
+    static auto toHits(
+        const QString &sText,
+        const QList<TextMatch> &listMatches) -> QList<FileSearchHit>;
+
+    const QString m_sIndexDir;
+    QThreadPool m_pool;
+    QSharedPointer<FileSearchJob> m_pJob;
+    int m_nJob;
+    TrigramIndex *m_pIndex;
+    QString m_sIndexedDir;
+    int m_nFiles;
+    int m_nSkipped;
+    int m_nHits;
+};
+
+#endif  // APPLICATION_FILESEARCH_H_
@@ -0,0 +1,306 @@
+/**
+ * \file filesearchpanel.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * \section DESCRIPTION
+ * Search in open documents and article files, list results while searching.
+ */
+
+#include "./filesearchpanel.h"
+
+#include <QApplication>
+#include <QCheckBox>
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QToolButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "./fileoperations.h"
+#include "./texteditor.h"
+
+FileSearchPanel::FileSearchPanel(FileOperations *pFileOperations,
+                                 const QString &sIndexDir, QWidget *pParent)
+  : QDockWidget(pParent),
+    m_pFileOperations(pFileOperations),
+    m_pFileSearch(new FileSearch(sIndexDir, this)),
+    m_pSearchEdit(new QLineEdit(this)),
+    m_pReplaceEdit(new QLineEdit(this)),
+    m_pCaseCheck(new QCheckBox(tr("Case sensitive"), this)),
+    m_pWholeWordCheck(new QCheckBox(tr("Whole words"), this)),
+    m_pRegexpCheck(new QCheckBox(tr("Regular expression"), this)),
+    m_pTabsCheck(new QCheckBox(tr("Open documents"), this)),
+    m_pDirCheck(new QCheckBox(tr("Folder:"), this)),
+    m_pDirEdit(new QLineEdit(this)),
+    m_pDirButton(new QToolButton(this)),
+    m_pIndexCheck(new QCheckBox(tr("Use index"), this)),
+    m_pSearchButton(new QPushButton(tr("Search"), this)),
+    m_pReplaceButton(new QPushButton(tr("Replace all"), this)),
+    m_pStopButton(new QPushButton(tr("Stop"), this)),
+    m_pStatusLabel(new QLabel(this)),
+    m_pTree(new QTreeWidget(this)) {
+  this->setObjectName(QStringLiteral("FileSearchPanel"));
+  this->setWindowTitle(tr("Find in files"));
+
+  m_pTabsCheck->setChecked(true);
+  m_pIndexCheck->setChecked(true);
+  m_pIndexCheck->setToolTip(tr("Skip unchanged files which can't contain "
+                               "the search term (not for regular "
+                               "expressions)"));
+  m_pDirButton->setText(QStringLiteral("..."));
+  m_pStopButton->setEnabled(false);
+
+  auto *pGrid = new QGridLayout();
+  pGrid->addWidget(new QLabel(tr("Search:"), this), 0, 0);
+  pGrid->addWidget(m_pSearchEdit, 0, 1);
+  pGrid->addWidget(new QLabel(tr("Replace:"), this), 1, 0);
+  pGrid->addWidget(m_pReplaceEdit, 1, 1);
+
+  auto *pOptions = new QHBoxLayout();
+  pOptions->addWidget(m_pCaseCheck);
+  pOptions->addWidget(m_pWholeWordCheck);
+  pOptions->addWidget(m_pRegexpCheck);
+  pOptions->addStretch();
+
+  auto *pScope = new QHBoxLayout();
+  pScope->addWidget(m_pTabsCheck);
+  pScope->addWidget(m_pDirCheck);
+  pScope->addWidget(m_pDirEdit, 1);
+  pScope->addWidget(m_pDirButton);
+  pScope->addWidget(m_pIndexCheck);
+
+  auto *pButtons = new QHBoxLayout();
+  pButtons->addWidget(m_pSearchButton);
+  pButtons->addWidget(m_pReplaceButton);
+  pButtons->addWidget(m_pStopButton);
+  pButtons->addWidget(m_pStatusLabel, 1);
+
+  m_pTree->setColumnCount(2);
+  m_pTree->setHeaderLabels(QStringList() << tr("Line") << tr("Text"));
+  m_pTree->header()->setStretchLastSection(true);
+
+  auto *pWidget = new QWidget(this);
+  auto *pLayout = new QVBoxLayout(pWidget);
+  pLayout->addLayout(pGrid);
+  pLayout->addLayout(pOptions);
+  pLayout->addLayout(pScope);
+  pLayout->addLayout(pButtons);
+  pLayout->addWidget(m_pTree);
+  this->setWidget(pWidget);
+
+  connect(m_pSearchEdit, &QLineEdit::returnPressed,
+          this, &FileSearchPanel::startSearch);
+  connect(m_pSearchButton, &QPushButton::clicked,
+          this, &FileSearchPanel::startSearch);
+  connect(m_pReplaceButton, &QPushButton::clicked,
+          this, &FileSearchPanel::startReplace);
+  connect(m_pStopButton, &QPushButton::clicked,
+          this, &FileSearchPanel::stopSearch);
+  connect(m_pDirButton, &QToolButton::clicked,
+          this, &FileSearchPanel::selectDir);
+  connect(m_pFileSearch, &FileSearch::found,
+          this, &FileSearchPanel::addResult);
+  connect(m_pFileSearch, &FileSearch::finished,
+          this, &FileSearchPanel::finishedSearch);
+  connect(m_pTree, &QTreeWidget::itemActivated,
+          this, &FileSearchPanel::activatedItem);
+  connect(m_pTree, &QTreeWidget::itemClicked,
+          this, &FileSearchPanel::activatedItem);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void FileSearchPanel::showSearch(const QString &sSearch) {
+  if (!sSearch.isEmpty()) {
+    m_pSearchEdit->setText(sSearch);
+  }
+  this->show();
+  this->raise();
+  m_pSearchEdit->setFocus();
+  m_pSearchEdit->selectAll();
+}
+
+// ----------------------------------------------------------------------------
+
+void FileSearchPanel::selectDir() {
+  const QString sDir(QFileDialog::getExistingDirectory(
+                       this, tr("Select folder"), m_pDirEdit->text()));
+  if (!sDir.isEmpty()) {
+    m_pDirEdit->setText(sDir);
+    m_pDirCheck->setChecked(true);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void FileSearchPanel::startSearch() {
+  this->search(false);
+}
+
+// ----------------------------------------------------------------------------
+
+void FileSearchPanel::startReplace() {
+  this->search(true);
+}
+
+// ----------------------------------------------------------------------------
+
+void FileSearchPanel::search(const bool bReplace) {
+  FileSearchOptions options;
+  options.sSearch = m_pSearchEdit->text();
+  options.sReplace = m_pReplaceEdit->text();
+  options.bCaseSens = m_pCaseCheck->isChecked();
+  options.bWholeWord = m_pWholeWordCheck->isChecked();
+  options.bRegexp = m_pRegexpCheck->isChecked();
+  options.bReplace = bReplace;
+  options.bTabs = m_pTabsCheck->isChecked();
+  options.bUseIndex = m_pIndexCheck->isChecked();
+  if (m_pDirCheck->isChecked()) {
+    options.sDir = m_pDirEdit->text().trimmed();
+  }
+  if (options.sSearch.isEmpty() || (!options.bTabs && options.sDir.isEmpty())) {
+    return;
+  }
+  if (!options.sDir.isEmpty() && !QDir(options.sDir).exists()) {
+    QMessageBox::warning(this, qApp->applicationName(),
+                         tr("The folder \"%1\" does not exist.")
+                         .arg(options.sDir));
+    return;
+  }
+  if (bReplace && !options.sDir.isEmpty() &&
+      QMessageBox::Yes != QMessageBox::question(
+        this, qApp->applicationName(),
+        tr("Replace all matches in files of folder \"%1\"?\nChanged files "
+           "are saved immediately, this can't be undone.")
+        .arg(options.sDir))) {
+    return;
+  }
+
+  const QList<TextEditor *> listEditors(m_pFileOperations->getEditors());
+  m_listEditors.clear();
+  for (auto *pEditor : listEditors) {
+    m_listEditors << pEditor;
+  }
+  m_sDir = options.sDir;
+  m_pTree->clear();
+  m_pStatusLabel->setText(tr("Searching..."));
+  this->setRunning(true);
+  m_pFileSearch->start(options, listEditors);
+}
+
+// ----------------------------------------------------------------------------
+
+void FileSearchPanel::stopSearch() {
+  m_pFileSearch->stop();
+  this->setRunning(false);
+  m_pStatusLabel->setText(tr("Search stopped."));
+}
+
+// ----------------------------------------------------------------------------
+
+void FileSearchPanel::setRunning(const bool bRunning) {
+  m_pSearchButton->setEnabled(!bRunning);
+  m_pReplaceButton->setEnabled(!bRunning);
+  m_pStopButton->setEnabled(bRunning);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void FileSearchPanel::addResult(const FileSearchResult &result) {
+  QString sName;
+  if (result.nTab >= 0) {
+    sName = QFileInfo(result.sFile).fileName() + " - " +
+            tr("open document");
+  } else {
+    sName = QDir(m_sDir).relativeFilePath(result.sFile);
+  }
+
+  auto *pFileItem = new QTreeWidgetItem(m_pTree);
+  pFileItem->setText(0, sName + " (" +
+                     QString::number(result.listHits.size()) + ")");
+  pFileItem->setToolTip(0, result.sFile);
+  pFileItem->setData(0, Qt::UserRole, result.sFile);
+  pFileItem->setData(0, Qt::UserRole + 1, result.nTab);
+  pFileItem->setFirstColumnSpanned(true);
+
+  if (!result.sError.isEmpty()) {
+    auto *pItem = new QTreeWidgetItem(pFileItem);
+    pItem->setText(1, result.sError);
+    pItem->setData(0, Qt::UserRole, -1);
+  }
+  for (const auto &hit : result.listHits) {
+    auto *pItem = new QTreeWidgetItem(pFileItem);
+    pItem->setText(0, QString::number(hit.nLine));
+    pItem->setText(1, hit.sLineText);
+    pItem->setData(0, Qt::UserRole, hit.nPos);
+    pItem->setData(0, Qt::UserRole + 1, hit.nLength);
+  }
+  pFileItem->setExpanded(true);
+}
+
+// ----------------------------------------------------------------------------
+
+void FileSearchPanel::finishedSearch(const int nFiles, const int nSkipped,
+                                     const int nHits) {
+  this->setRunning(false);
+  QString sStatus(tr("%1 matches in %2 of %3 files.")
+                  .arg(nHits).arg(m_pTree->topLevelItemCount())
+                  .arg(nFiles + nSkipped));
+  if (nSkipped > 0) {
+    sStatus += " " + tr("%1 files skipped by index.").arg(nSkipped);
+  }
+  m_pStatusLabel->setText(sStatus);
+}
+
+// ----------------------------------------------------------------------------
+
+void FileSearchPanel::activatedItem(QTreeWidgetItem *pItem) {
+  if (nullptr == pItem || nullptr == pItem->parent() ||
+      pItem->data(0, Qt::UserRole).toInt() < 0) {
+    return;
+  }
+  const QString sFile(pItem->parent()->data(0, Qt::UserRole).toString());
+  const int nTab = pItem->parent()->data(0, Qt::UserRole + 1).toInt();
+
+  TextEditor *pEditor = nullptr;
+  if (nTab >= 0 && nTab < m_listEditors.size()) {
+    pEditor = m_listEditors.at(nTab);  // Null if closed meanwhile
+  } else if (nTab < 0) {
+    pEditor = m_pFileOperations->showFile(sFile);
+  }
+
+  if (nullptr != pEditor) {
+    emit this->showMatch(pEditor, pItem->data(0, Qt::UserRole).toInt(),
+                         pItem->data(0, Qt::UserRole + 1).toInt());
+  }
+}
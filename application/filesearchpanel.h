@@ -0,0 +1,103 @@
+/**
+ * \file filesearchpanel.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * \section DESCRIPTION
+ * Class definition for search in files panel.
+ */
+
+#ifndef APPLICATION_FILESEARCHPANEL_H_
+#define APPLICATION_FILESEARCHPANEL_H_
+
+#include <QDockWidget>
+#include <QList>
+#include <QPointer>
+
+#include "./filesearch.h"
+
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QToolButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+class FileOperations;
+class TextEditor;
+
+/**
+ * \class FileSearchPanel
+ * \brief Search and replace in open documents and article folder
+ *
+ * Results are listed while search is running; activating a match opens
+ * the document (if not yet opened) and selects the match.
+ */
+class FileSearchPanel : public QDockWidget {
+  Q_OBJECT
+
+ public:
+    FileSearchPanel(FileOperations *pFileOperations, const QString &sIndexDir,
+                    QWidget *pParent = nullptr);
+
+    void showSearch(const QString &sSearch = QString());
+
+ signals:
+    void showMatch(TextEditor *pEditor, const int nPos, const int nLength);
+
+ private slots:
+    void startSearch();
+    void startReplace();
+    void stopSearch();
+    void selectDir();
+    void addResult(const FileSearchResult &result);
+    void finishedSearch(const int nFiles, const int nSkipped,
+                        const int nHits);
+    void activatedItem(QTreeWidgetItem *pItem);
+
+ private:
+    void search(const bool bReplace);
+    void setRunning(const bool bRunning);
+
+    FileOperations *m_pFileOperations;
+    FileSearch *m_pFileSearch;
+    QList<QPointer<TextEditor>> m_listEditors;  // Open documents of search
+    QString m_sDir;
+
+    QLineEdit *m_pSearchEdit;
+    QLineEdit *m_pReplaceEdit;
+    QCheckBox *m_pCaseCheck;
+    QCheckBox *m_pWholeWordCheck;
+    QCheckBox *m_pRegexpCheck;
+    QCheckBox *m_pTabsCheck;
+    QCheckBox *m_pDirCheck;
+    QLineEdit *m_pDirEdit;
+    QToolButton *m_pDirButton;
+    QCheckBox *m_pIndexCheck;
+    QPushButton *m_pSearchButton;
+    QPushButton *m_pReplaceButton;
+    QPushButton *m_pStopButton;
+    QLabel *m_pStatusLabel;
+    QTreeWidget *m_pTree;
+};
+
+#endif  // APPLICATION_FILESEARCHPANEL_H_
@@ -30,6 +30,7 @@
 #include <QMessageBox>
 #include <QRegularExpression>
 #include <QShowEvent>
+#include <QTextBlock>
 #include <QTextDocument>
 #include <QTextEdit>
 
@@ -228,33 +229,171 @@ void FindReplace::find(const bool bForward) {
   } else {
     m_pUi->lbl_Error->setText(tr("Could not find your expression"));
     // Move to the beginning of the document for the next search cycle
-    m_TextCursor.setPosition(0);
+    m_TextCursor = QTextCursor(m_pEditor->document());
     m_pEditor->setTextCursor(m_TextCursor);
-
-    // Workaround for LP: #941308
-    m_pEditor->setText(m_pEditor->toPlainText());
   }
 }
 
 // ----------------------------------------------------------------------------
 
 void FindReplace::replace() {
-  if (!m_pEditor->textCursor().hasSelection()) {
-    this->find(m_pUi->radio_Forward->isChecked());
-  } else {
-    m_pEditor->textCursor().insertText(m_pUi->text_Replace->text());
-    this->find(m_pUi->radio_Forward->isChecked());
+  QTextCursor cursor(m_pEditor->textCursor());
+  if (cursor.hasSelection()) {
+    QString sReplace(m_pUi->text_Replace->text());
+    // Capture references of selected match; matched in context of its line
+    // (look-arounds, anchors), not in the isolated selection
+    if (m_pUi->check_Regexp->isChecked()) {
+      const QTextBlock block(
+            m_pEditor->document()->findBlock(cursor.selectionStart()));
+      const int nPos = cursor.selectionStart() - block.position();
+      const int nLength = cursor.selectionEnd() - cursor.selectionStart();
+      const QList<TextMatch> listMatches(
+            FindReplace::findAll(block.text(), m_pUi->text_Search->text(),
+                                 sReplace, m_pUi->check_Case->isChecked(),
+                                 m_pUi->check_WholeWord->isChecked(), true));
+      for (const auto &match : listMatches) {
+        if (nPos == match.nPos && nLength == match.nLength) {
+          sReplace = match.sReplacement;
+          break;
+        }
+      }
+    }
+    cursor.insertText(sReplace);
   }
+  this->find(m_pUi->radio_Forward->isChecked());
 }
 
 // ----------------------------------------------------------------------------
 
 void FindReplace::replaceAll() {
-  quint32 nReplaced = 0;
-  while (m_pEditor->textCursor().hasSelection()) {
-    m_pEditor->textCursor().insertText(m_pUi->text_Replace->text());
-    this->find(m_pUi->radio_Forward->isChecked());
-    nReplaced++;
+  const QRegularExpression regexp(
+        FindReplace::createRegExp(m_pUi->text_Search->text(),
+                                  m_pUi->check_Case->isChecked(),
+                                  m_pUi->check_WholeWord->isChecked(),
+                                  m_pUi->check_Regexp->isChecked()));
+  if (!regexp.isValid()) {
+    m_pUi->lbl_Error->setText(regexp.errorString());
+    return;
+  }
+
+  // Matches of text snapshot are replaced in one edit block
+  const QList<TextMatch> listMatches(
+        FindReplace::findAll(m_pEditor->toPlainText(),
+                             m_pUi->text_Search->text(),
+                             m_pUi->text_Replace->text(),
+                             m_pUi->check_Case->isChecked(),
+                             m_pUi->check_WholeWord->isChecked(),
+                             m_pUi->check_Regexp->isChecked()));
+  FindReplace::replaceMatches(m_pEditor->document(), listMatches);
+  m_pUi->lbl_Error->setText(
+        tr("Replaced expressions: %1").arg(listMatches.size()));
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto FindReplace::findAll(const QString &sText, const QString &sSearch,
+                          const QString &sReplace, const bool bCaseSens,
+                          const bool bWholeWord,
+                          const bool bRegexp) -> QList<TextMatch> {
+  QList<TextMatch> listMatches;
+  const QRegularExpression regexp(
+        FindReplace::createRegExp(sSearch, bCaseSens, bWholeWord, bRegexp));
+  if (sSearch.isEmpty() || !regexp.isValid()) {
+    return listMatches;
+  }
+
+  // Line by line like QTextDocument::find(), so that find next and replace
+  // all are matching the same (no matches across line breaks)
+  int nLineStart = 0;
+  while (nLineStart <= sText.size()) {
+    int nLineEnd = sText.indexOf('\n', nLineStart);
+    if (-1 == nLineEnd) {
+      nLineEnd = sText.size();
+    }
+
+    QRegularExpressionMatchIterator it(
+          regexp.globalMatch(sText.mid(nLineStart, nLineEnd - nLineStart)));
+    while (it.hasNext()) {
+      const QRegularExpressionMatch match(it.next());
+      TextMatch textMatch{nLineStart + static_cast<int>(match.capturedStart()),
+                          static_cast<int>(match.capturedLength()), sReplace};
+      if (bRegexp) {
+        textMatch.sReplacement = FindReplace::expandCaptures(
+                                   sReplace, match.capturedTexts());
+      }
+      listMatches << textMatch;
+    }
+    nLineStart = nLineEnd + 1;
+  }
+  return listMatches;
+}
+
+// ----------------------------------------------------------------------------
+
+void FindReplace::replaceMatches(QTextDocument *pDoc,
+                                 const QList<TextMatch> &listMatches) {
+  if (listMatches.isEmpty()) {
+    return;
+  }
+
+  // Back to front, so that positions of remaining matches stay valid
+  QTextCursor cursor(pDoc);
+  cursor.beginEditBlock();
+  for (int i = listMatches.size() - 1; i >= 0; i--) {
+    const TextMatch &match = listMatches.at(i);
+    cursor.setPosition(match.nPos);
+    cursor.setPosition(match.nPos + match.nLength, QTextCursor::KeepAnchor);
+    cursor.insertText(match.sReplacement);
+  }
+  cursor.endEditBlock();
+}
+
+// ----------------------------------------------------------------------------
+
+// Plain search and whole words are handled as regular expression as well
+auto FindReplace::createRegExp(const QString &sSearch, const bool bCaseSens,
+                               const bool bWholeWord,
+                               const bool bRegexp) -> QRegularExpression {
+  QString sPattern(bRegexp ? sSearch : QRegularExpression::escape(sSearch));
+  QRegularExpression::PatternOptions options(
+        QRegularExpression::MultilineOption);
+  if (!bCaseSens) {
+    options |= QRegularExpression::CaseInsensitiveOption;
+  }
+  if (bWholeWord) {
+    sPattern = "(?<!\\w)(?:" + sPattern + ")(?!\\w)";
+    options |= QRegularExpression::UseUnicodePropertiesOption;
+  }
+  return QRegularExpression(sPattern, options);
+}
+
+// ----------------------------------------------------------------------------
+
+auto FindReplace::expandCaptures(const QString &sReplace,
+                                 const QStringList &sListCaptured) -> QString {
+  QString sRet;
+  sRet.reserve(sReplace.size());
+  for (int i = 0; i < sReplace.size(); i++) {
+    const QChar c(sReplace.at(i));
+    if ('\\' != c || i + 1 >= sReplace.size()) {
+      sRet += c;
+      continue;
+    }
+
+    const QChar cNext(sReplace.at(++i));
+    if (cNext.isDigit()) {
+      const int nGroup = cNext.digitValue();
+      if (nGroup < sListCaptured.size()) {
+        sRet += sListCaptured.at(nGroup);
+      }
+    } else if ('n' == cNext) {
+      sRet += '\n';
+    } else if ('t' == cNext) {
+      sRet += '\t';
+    } else {
+      sRet += cNext;  // E.g. \\ for backslash
+    }
   }
-  m_pUi->lbl_Error->setText(tr("Replaced expressions: %1").arg(nReplaced));
+  return sRet;
 }
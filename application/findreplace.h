@@ -28,12 +28,23 @@
 #define APPLICATION_FINDREPLACE_H_
 
 #include <QDialog>
+#include <QList>
+#include <QString>
+#include <QStringList>
 #include <QTextCursor>
 
 class QCloseEvent;
+class QRegularExpression;
+class QTextDocument;
 class QTextEdit;
 class QShowEvent;
 
+struct TextMatch {
+  int nPos;
+  int nLength;
+  QString sReplacement;
+};
+
 namespace Ui {
 class FindReplace;
 }
@@ -47,6 +58,16 @@ class FindReplace : public QDialog {
 
     void setEditor(QTextEdit *pEditor);
 
+    // All matches of text in one pass; with bRegexp the replacement may
+    // contain capture references \0 ... \9 (and \n, \t, \\)
+    static auto findAll(const QString &sText, const QString &sSearch,
+                        const QString &sReplace, const bool bCaseSens,
+                        const bool bWholeWord,
+                        const bool bRegexp) -> QList<TextMatch>;
+    // Replacing all matches (sorted by position) is one undo step
+    static void replaceMatches(QTextDocument *pDoc,
+                               const QList<TextMatch> &listMatches);
+
  public slots:
     void callFind();
     void callReplace();
@@ -64,6 +85,11 @@ class FindReplace : public QDialog {
 
  private:
     void find(const bool bForward);
+    static auto createRegExp(const QString &sSearch, const bool bCaseSens,
+                             const bool bWholeWord,
+                             const bool bRegexp) -> QRegularExpression;
+    static auto expandCaptures(const QString &sReplace,
+                               const QStringList &sListCaptured) -> QString;
     void toggleSearchReplace(bool bReplace);
 
     Ui::FindReplace *m_pUi;
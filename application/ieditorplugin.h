@@ -32,6 +32,7 @@
 
 class QDir;
 
+class IRenderService;
 class TextEditor;
 
 class IEditorPlugin {
@@ -41,7 +42,8 @@ class IEditorPlugin {
     // ALL FUNCTIONS PURE VIRTUAL !!!
     virtual void initPlugin(QWidget *pParent, TextEditor *pEditor,
                             const QDir &userDataDir,
-                            const QString &sSharePath) = 0;
+                            const QString &sSharePath,
+                            IRenderService *pRenderService) = 0;
     virtual QString getPluginName() const = 0;
     virtual QString getPluginVersion() const = 0;
     virtual void installTranslator(const QString &sLang) = 0;
@@ -60,6 +62,7 @@ class IEditorPlugin {
     virtual void showAbout() = 0;
 };
 
-Q_DECLARE_INTERFACE(IEditorPlugin, "InyokaEdit.PluginInterface")
+// Version suffix: Plugins built against older interface are rejected
+Q_DECLARE_INTERFACE(IEditorPlugin, "InyokaEdit.PluginInterface/2")
 
 #endif  // APPLICATION_IEDITORPLUGIN_H_
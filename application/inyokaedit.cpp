@@ -28,6 +28,7 @@
 
 #include <QComboBox>
 #include <QDesktopServices>
+#include <QFileDialog>
 #include <QGridLayout>
 #include <QKeyEvent>
 #include <QLibraryInfo>
@@ -37,8 +38,8 @@
 #include <QSplitter>
 #include <QTextBlock>
 #include <QTimer>
+#include <QtConcurrent>
 #include <QToolButton>
-#include <QToolTip>
 
 #ifdef USEQTWEBKIT
 #include <QtWebKitWidgets/QWebView>
@@ -50,15 +51,28 @@
 #include <QWebEngineHistory>
 #endif
 
+#include "./articlescanner.h"
+#include "./diagnostics.h"
 #include "./download.h"
 #include "./fileoperations.h"
+#include "./filesearchpanel.h"
 #include "./ieditorplugin.h"
+#include "./ispellchecker.h"
+#include "./librarypanel.h"
+#include "./livesyntaxcheck.h"
 #include "./parser/parser.h"
 #include "./plugins.h"
+#include "./previewcache.h"
+#ifdef NOPREVIEW
+#include "./previewserver.h"
+#endif
+#include "./renderservice.h"
 #include "./settings.h"
 #include "./session.h"
+#include "./syntaxpanel.h"
 #include "./templates/templates.h"
 #include "./texteditor.h"
+#include "./trace/trace.h"
 #include "./upload.h"
 #include "./utils.h"
 #include "./xmlparser.h"
@@ -77,9 +91,12 @@ InyokaEdit::InyokaEdit(const QDir &userDataDir, const QDir &sharePath,
     m_bOpenFileAfterStart(false),
     m_bEditorScrolling(false),
     m_bWebviewScrolling(false),
-    m_bReloadPreviewBlocked(false) {
-  m_pUi->setupUi(this);
-
+    m_bPreviewStatsPending(false),
+    m_bConfirmPreview(false),
+    m_bReloadPreviewBlocked(false),
+    m_bStartupFinished(false),
+    m_nStartupPhase(0) {
+  m_startupTimer.start();
   if (!sharePath.exists()) {
     QMessageBox::warning(nullptr, QStringLiteral("Warning"),
                          QStringLiteral("App share folder not found!"));
@@ -97,13 +114,18 @@ InyokaEdit::InyokaEdit(const QDir &userDataDir, const QDir &sharePath,
     m_bOpenFileAfterStart = true;  // Checked in setupEditor()
   }
 
+  this->loadCommunityData();  // Before ui, loaded in background
+  m_pUi->setupUi(this);
+  this->startupPhase("Ui");
+
   // After definition of StylesAndImagesDir AND m_tmpPreviewImgDir!
   this->createObjects();
+  this->startupPhase("Objects");
   this->setupEditor();
   this->createActions();
   this->createMenus();
-  this->createXmlMenus();
   this->setUnifiedTitleAndToolBarOnMac(true);
+  this->startupPhase("Editor");
 
   if (!QFile(m_UserDataDir.absolutePath() + "/community/" +
              m_pSettings->getInyokaCommunity()).exists()) {
@@ -120,13 +142,16 @@ InyokaEdit::InyokaEdit(const QDir &userDataDir, const QDir &sharePath,
     m_pFileOperations->loadFile(sArg, true);
   }
 
-  m_pPlugins->loadPlugins(m_pSettings->getGuiLanguage());
-  this->updateEditorSettings();
   this->deleteAutoSaveBackups();
   m_pCurrentEditor->setFocus();
+
+  // Plugins, XML menus and preview after window is shown
+  QTimer::singleShot(0, this, &InyokaEdit::finishStartup);
 }
 
 InyokaEdit::~InyokaEdit() {
+  delete m_pPreviewCache;
+  m_pPreviewCache = nullptr;
   delete m_pUi;
   m_pUi = nullptr;
 }
@@ -134,7 +159,8 @@ InyokaEdit::~InyokaEdit() {
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-void InyokaEdit::createObjects() {
+// Settings and start of loading community data (worker thread)
+void InyokaEdit::loadCommunityData() {
   m_pSettings = new Settings(this, m_sSharePath);
   qDebug() << "Inyoka Community:" << m_pSettings->getInyokaCommunity();
   if (m_pSettings->getInyokaCommunity().isEmpty() ||
@@ -149,16 +175,24 @@ void InyokaEdit::createObjects() {
                              "the application."));
     exit(-2);
   }
+
+  const QString sCommunity(m_pSettings->getInyokaCommunity());
+  const QString sSharePath(m_sSharePath);
+  const QString sUserDataDir(m_UserDataDir.absolutePath());
+  m_futureTemplates = QtConcurrent::run([=]() {
+    return new Templates(sCommunity, sSharePath, sUserDataDir);
+  });
+}
+
+// ----------------------------------------------------------------------------
+
+void InyokaEdit::createObjects() {
   connect(m_pSettings, &Settings::changeLang,
           this, &InyokaEdit::loadLanguage);
   connect(this, &InyokaEdit::updateUiLang,
           m_pSettings, &Settings::updateUiLang);
   this->loadLanguage(m_pSettings->getGuiLanguage());
 
-  // Has to be created before parser
-  m_pTemplates = new Templates(m_pSettings->getInyokaCommunity(),
-                               m_sSharePath, m_UserDataDir.absolutePath());
-
   m_pSession = new Session(this, m_pSettings->getInyokaHash());
 
   m_pDownloadModule = new Download(this, m_pSession,
@@ -169,15 +203,21 @@ void InyokaEdit::createObjects() {
   m_pUploadModule = new Upload(this, m_pSession, m_pSettings->getInyokaUrl(),
                                m_pSettings->getInyokaConstructionArea());
 
-  m_pParser = new Parser(m_sSharePath, m_tmpPreviewImgDir,
-                         m_pSettings->getInyokaUrl(),
-                         m_pSettings->getCheckLinks(),
-                         m_pTemplates,
-                         m_pSettings->getInyokaCommunity(),
-                         m_pSettings->getPygmentize());
-  connect(m_pParser, &Parser::hightlightSyntaxError,
-          this, &InyokaEdit::highlightSyntaxError);
-
+  // Objects independent of community data are created while it is still
+  // loading (web view takes longest)
+  m_pPreviewCache = new PreviewCache(m_UserDataDir.absolutePath() +
+                                     "/previewcache");
+#ifdef NOPREVIEW
+  // External browser gets preview from memory and is notified about changes
+  m_pPreviewServer = new PreviewServer(
+                       QStringList() << m_sSharePath + "/community"
+                       << m_UserDataDir.absolutePath() + "/community"
+                       << m_tmpPreviewImgDir.absolutePath(), this);
+  if (!m_pPreviewServer->listen()) {
+    delete m_pPreviewServer;
+    m_pPreviewServer = nullptr;  // Fallback: Temporary file
+  }
+#endif
   m_pDocumentTabs = new QTabWidget;
   m_pDocumentTabs->setTabPosition(QTabWidget::North);
   m_pDocumentTabs->setTabsClosable(true);
@@ -185,37 +225,10 @@ void InyokaEdit::createObjects() {
   // Attention: Currently tab order is fixed (same as m_pListEditors)
   m_pDocumentTabs->setMovable(false);
 
-  m_pFileOperations = new FileOperations(this, m_pDocumentTabs, m_pSettings,
-                                         m_sPreviewFile,
-                                         m_UserDataDir.absolutePath(),
-                                         m_pTemplates->getListTplMacrosALL());
-  m_pCurrentEditor = m_pFileOperations->getCurrentEditor();
-
-  connect(m_pFileOperations, &FileOperations::callPreview,
-          this, &InyokaEdit::previewInyokaPage);
-  connect(m_pFileOperations, &FileOperations::modifiedDoc,
-          this, &InyokaEdit::setWindowModified);
-  connect(m_pFileOperations, &FileOperations::changedCurrentEditor,
-          this, &InyokaEdit::setCurrentEditor);
-
-  m_pPlugins = new Plugins(this, m_pCurrentEditor,
-                           m_pSettings->getDisabledPlugins(),
-                           m_UserDataDir,
-                           m_sSharePath);
-  connect(m_pSettings, &Settings::changeLang, m_pPlugins, &Plugins::changeLang);
-  connect(m_pPlugins, &Plugins::addMenuToolbarEntries,
-          this, &InyokaEdit::addPluginsButtons);
-  connect(m_pPlugins, &Plugins::availablePlugins,
-          m_pSettings, &Settings::availablePlugins);
-
-  this->setCurrentEditor();
-
 #ifdef USEQTWEBKIT
   m_pWebview = new QWebView(this);
   connect(m_pWebview->page(), &QWebPage::scrollRequested,
           this, &InyokaEdit::syncScrollbarsWebview);
-  connect(m_pFileOperations, &FileOperations::movedEditorScrollbar,
-          this, &InyokaEdit::syncScrollbarsEditor);
 
   m_pWebview->settings()->setDefaultTextEncoding(QStringLiteral("utf-8"));
 #endif
@@ -230,8 +243,6 @@ void InyokaEdit::createObjects() {
 
   connect(m_pWebview->page(), &QWebEnginePage::scrollPositionChanged,
           this, &InyokaEdit::syncScrollbarsWebview);
-  connect(m_pFileOperations, &FileOperations::movedEditorScrollbar,
-          this, &InyokaEdit::syncScrollbarsEditor);
 #endif
 #ifndef NOPREVIEW
   m_pWebview->installEventFilter(this);
@@ -240,6 +251,102 @@ void InyokaEdit::createObjects() {
   m_pUtils = new Utils(this);
   connect(m_pUtils, &Utils::setWindowsUpdateCheck,
           m_pSettings, &Settings::setWindowsCheckUpdate);
+
+  m_pDiagnostics = new Diagnostics(this);
+
+  // Has to be loaded before parser
+  m_pTemplates = m_futureTemplates.result();
+  m_pTemplates->showErrors();
+  this->startupPhase("Community data");
+
+  m_pParser = new Parser(m_sSharePath, m_tmpPreviewImgDir,
+                         m_pSettings->getInyokaUrl(),
+                         m_pSettings->getCheckLinks(),
+                         m_pTemplates,
+                         m_pSettings->getInyokaCommunity(),
+                         m_pSettings->getPygmentize());
+  // Syntax check runs in background, independent from preview
+  m_pLiveSyntaxCheck = new LiveSyntaxCheck(m_pParser->getSyntaxCheck(), this);
+  connect(m_pLiveSyntaxCheck, &LiveSyntaxCheck::checked,
+          this, &InyokaEdit::highlightSyntaxError);
+
+  m_pFileOperations = new FileOperations(this, m_pDocumentTabs, m_pSettings,
+                                         m_sPreviewFile,
+                                         m_UserDataDir.absolutePath(),
+                                         m_pTemplates->getListTplMacrosALL());
+  m_pCurrentEditor = m_pFileOperations->getCurrentEditor();
+
+  connect(m_pFileOperations, &FileOperations::callPreview,
+          this, &InyokaEdit::previewInyokaPage);
+  connect(m_pFileOperations, &FileOperations::modifiedDoc,
+          this, &InyokaEdit::setWindowModified);
+  connect(m_pFileOperations, &FileOperations::modifiedDoc,
+          this, [this](bool bModified) {
+    if (!bModified) {  // Saved: Persist preview of modified text
+      m_pPreviewCache->flushPending(m_pFileOperations->getCurrentFile(),
+                                    m_pCurrentEditor->toPlainText());
+    }
+  });
+  connect(m_pFileOperations, &FileOperations::changedCurrentEditor,
+          this, &InyokaEdit::setCurrentEditor);
+#ifndef NOPREVIEW
+  connect(m_pFileOperations, &FileOperations::movedEditorScrollbar,
+          this, &InyokaEdit::syncScrollbarsEditor);
+#endif
+
+  m_pPlugins = new Plugins(this, m_pCurrentEditor,
+                           m_pSettings->getDisabledPlugins(),
+                           m_UserDataDir,
+                           m_sSharePath,
+                           new RenderService(m_pParser, m_pTemplates, this));
+  connect(m_pSettings, &Settings::changeLang, m_pPlugins, &Plugins::changeLang);
+  connect(m_pPlugins, &Plugins::addMenuToolbarEntries,
+          this, &InyokaEdit::addPluginsButtons);
+  connect(m_pPlugins, &Plugins::availablePlugins,
+          m_pSettings, &Settings::availablePlugins);
+
+  this->setCurrentEditor();
+
+  m_pSyntaxPanel = new SyntaxPanel(this);
+  this->addDockWidget(Qt::BottomDockWidgetArea, m_pSyntaxPanel);
+  m_pSyntaxPanel->hide();
+  connect(m_pSyntaxPanel, &SyntaxPanel::jumpToPosition,
+          this, [this](const int nPos) {
+    QTextCursor cursor(m_pCurrentEditor->textCursor());
+    const int nLast = m_pCurrentEditor->document()->characterCount() - 1;
+    cursor.setPosition(qMin(nPos, nLast));
+    m_pCurrentEditor->setTextCursor(cursor);
+    m_pCurrentEditor->setFocus();
+  });
+
+  m_pFileSearchPanel = new FileSearchPanel(m_pFileOperations,
+                                           m_UserDataDir.absolutePath() +
+                                           "/searchindex", this);
+  this->addDockWidget(Qt::BottomDockWidgetArea, m_pFileSearchPanel);
+  this->tabifyDockWidget(m_pSyntaxPanel, m_pFileSearchPanel);
+  m_pFileSearchPanel->hide();
+  connect(m_pFileSearchPanel, &FileSearchPanel::showMatch,
+          this, [this](TextEditor *pEditor, const int nPos,
+                       const int nLength) {
+    m_pDocumentTabs->setCurrentWidget(pEditor);
+    QTextCursor cursor(pEditor->textCursor());
+    const int nLast = pEditor->document()->characterCount() - 1;
+    cursor.setPosition(qMin(nPos, nLast));
+    cursor.setPosition(qMin(nPos + nLength, nLast), QTextCursor::KeepAnchor);
+    pEditor->setTextCursor(cursor);
+    pEditor->setFocus();
+  });
+
+  // Scanner is not part of Parser (parser benchmark is built without it)
+  const ArticleScanner scanner(m_pParser->getTplTranslations(),
+                               m_pParser->getPictureTranslations());
+  m_pLibraryPanel = new LibraryPanel(scanner,
+                                     m_UserDataDir.absolutePath() +
+                                     "/library", m_pFileOperations,
+                                     m_pSettings, this);
+  this->addDockWidget(Qt::BottomDockWidgetArea, m_pLibraryPanel);
+  this->tabifyDockWidget(m_pSyntaxPanel, m_pLibraryPanel);
+  m_pLibraryPanel->hide();
 }
 
 // ----------------------------------------------------------------------------
@@ -249,6 +356,57 @@ void InyokaEdit::setCurrentEditor() {
   m_pPlugins->setCurrentEditor(m_pCurrentEditor);
   m_pPlugins->setEditorlist(m_pFileOperations->getEditors());
   m_pUploadModule->setEditor(m_pCurrentEditor, m_pCurrentEditor->getFileName());
+  m_pLiveSyntaxCheck->setEditor(m_pCurrentEditor);
+  if (nullptr != m_pLibraryPanel) {  // Created after first editor
+    m_pLibraryPanel->setCurrentFile(m_pCurrentEditor->getFileName());
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+// Called from event loop, i.e. main window is already visible
+void InyokaEdit::finishStartup() {
+  this->startupPhase("Window shown");
+
+  m_pPlugins->loadPlugins(m_pSettings->getGuiLanguage());
+  this->setCurrentEditor();
+  this->updateEditorSettings();
+  this->startupPhase("Plugins");
+
+  this->createXmlMenus();
+  this->startupPhase("XML menus");
+
+  m_bStartupFinished = true;
+#ifndef NOPREVIEW
+  // Show loaded file or an empty website after start
+  this->previewInyokaPage();
+#else
+  if (m_bOpenFileAfterStart) {
+    this->previewInyokaPage();
+  }
+#endif
+  this->startupPhase("Preview");
+
+  // Next event loop cycle: Pending events processed, input is handled
+  QTimer::singleShot(0, this, [this]() {
+    this->startupPhase("Interactive");
+  });
+}
+
+// ----------------------------------------------------------------------------
+
+// Startup timeline in debug log: Time since start and duration of phase
+void InyokaEdit::startupPhase(const char *sPhase) {
+  const qint64 nElapsed = m_startupTimer.nsecsElapsed();
+  const qint64 nDuration = nElapsed - m_nStartupPhase;
+  m_nStartupPhase = nElapsed;
+  qDebug().nospace() << "Startup: " << sPhase << " at "
+                     << nElapsed / 1000000 << " ms (+"
+                     << nDuration / 1000000 << " ms)";
+  if (Trace::isEnabled()) {
+    Trace::complete("startup", sPhase, Trace::now() - nDuration, nDuration);
+  }
 }
 
 // ----------------------------------------------------------------------------
@@ -285,13 +443,6 @@ void InyokaEdit::setupEditor() {
   connect(m_pFileOperations, &FileOperations::newEditor,
           this, &InyokaEdit::updateEditorSettings);
 
-#ifndef NOPREVIEW
-  // Show an empty website after start
-  if (!m_bOpenFileAfterStart) {
-    this->previewInyokaPage();
-  }
-#endif
-
   connect(m_pDownloadModule, &Download::sendArticleText,
           this, &InyokaEdit::displayArticleText);
 
@@ -357,6 +508,11 @@ void InyokaEdit::createActions() {
   m_pUi->openAct->setShortcuts(QKeySequence::Open);
   connect(m_pUi->openAct, &QAction::triggered,
           this, &InyokaEdit::openFile);
+  // Open article of library by title
+  m_pUi->openFromLibraryAct->setShortcut(
+        QKeySequence(QStringLiteral("Ctrl+Shift+O")));
+  connect(m_pUi->openFromLibraryAct, &QAction::triggered,
+          m_pLibraryPanel, &LibraryPanel::showTitleSearch);
   // Save file
   m_pUi->saveAct->setShortcuts(QKeySequence::Save);
   connect(m_pUi->saveAct, &QAction::triggered,
@@ -397,6 +553,15 @@ void InyokaEdit::createActions() {
   m_pUi->findPreviousAct->setShortcuts(QKeySequence::FindPrevious);
   connect(m_pUi->findPreviousAct, &QAction::triggered,
           m_pFileOperations, &FileOperations::triggeredFindPrevious);
+  // Find in open documents and files
+  m_pUi->searchFilesAct->setShortcut(
+        QKeySequence(QStringLiteral("Ctrl+Shift+F")));
+  connect(m_pUi->searchFilesAct, &QAction::triggered, this, [this]() {
+    const QString sSelected(m_pCurrentEditor->textCursor().selectedText());
+    m_pFileSearchPanel->showSearch(
+          sSelected.contains(QChar::ParagraphSeparator) ? QString()
+                                                        : sSelected);
+  });
 
   // Cut
   m_pUi->cutAct->setShortcuts(QKeySequence::Cut);
@@ -445,6 +610,21 @@ void InyokaEdit::createActions() {
   connect(m_pUi->deleteTempImagesAct, &QAction::triggered,
           this, &InyokaEdit::deleteTempImages);
 
+  // Show parse stage timings of last previews
+  connect(m_pUi->showDiagnosticsAct, &QAction::triggered,
+          m_pDiagnostics, &Diagnostics::show);
+
+  // Show / hide list of syntax errors
+  m_pUi->toolsMenu->insertAction(m_pUi->showDiagnosticsAct,
+                                 m_pSyntaxPanel->toggleViewAction());
+  // Show / hide article library
+  m_pUi->toolsMenu->insertAction(m_pUi->showDiagnosticsAct,
+                                 m_pLibraryPanel->toggleViewAction());
+
+  // Save recorded trace events (Chrome trace format)
+  connect(m_pUi->exportTraceAct, &QAction::triggered,
+          this, &InyokaEdit::exportTrace);
+
   // Show settings dialog
   connect(m_pUi->preferencesAct, &QAction::triggered,
           m_pSettings, &Settings::showSettingsDialog);
@@ -798,15 +978,61 @@ void InyokaEdit::openFile() {
 
 // Call parser
 void InyokaEdit::previewInyokaPage() {
+  if (!m_bStartupFinished) {
+    return;  // First preview is generated by finishStartup()
+  }
 #ifndef NOPREVIEW
   m_pWebview->history()->clear();  // Clear history (clicked links)
 #endif
 
-  QString sRetHTML(QLatin1String(""));
-  sRetHTML = m_pParser->genOutput(m_pFileOperations->getCurrentFile(),
-                                  m_pCurrentEditor->document(),
-                                  m_pSettings->getSyntaxCheck());
+  const QString sFile(m_pFileOperations->getCurrentFile());
+  const QString sText(m_pCurrentEditor->toPlainText());
+  ParsedBody body;
+
+  // Unmodified file (just opened): Show cached preview immediately and
+  // confirm it by parsing afterwards (see loadPreviewFinished())
+  if (!m_bConfirmPreview && !m_pCurrentEditor->document()->isModified() &&
+      m_pPreviewCache->lookup(sFile, sText, &body)) {
+    qDebug() << "Showing cached preview:" << sFile;
+    m_bConfirmPreview = true;
+    m_CachedPreview = body;
+    m_bPreviewStatsPending = false;
+    this->writePreview(m_pParser->wrapBody(sFile, body));
+    return;
+  }
+
+  const bool bConfirm(m_bConfirmPreview);
+  m_bConfirmPreview = false;
+  body = m_pParser->genBody(sFile, m_pCurrentEditor->document());
+  const QString sRetHTML(m_pParser->wrapBody(sFile, body));
+  if (bConfirm && body.sContent == m_CachedPreview.sContent &&
+      body.sTags == m_CachedPreview.sTags) {
+    qDebug() << "Cached preview confirmed:" << sFile;
+    return;
+  }
+  // Only saved text will be opened again, modified text is written on save
+  if (m_pCurrentEditor->document()->isModified()) {
+    m_pPreviewCache->storePending(sFile, sText, body);
+  } else {
+    m_pPreviewCache->store(sFile, sText, body);
+  }
+
+  // Parser stages are measured by parser, write / load is measured here
+  m_bPreviewStatsPending = ParseStatistics::isEnabled();
+  if (m_bPreviewStatsPending) {
+    m_previewStatistics.timestamp = QDateTime::currentDateTime();
+    m_previewStatistics.sFile = m_pFileOperations->getCurrentFile();
+    m_previewStatistics.nLines = m_pCurrentEditor->document()->blockCount();
+    m_previewStatistics.listStages = m_pParser->getStageTimings();
+    m_previewStatistics.listCounters = ParseStatistics::getCounters();
+    m_previewStageTimer.start();
+  }
+  this->writePreview(sRetHTML);
+}
+
+// ----------------------------------------------------------------------------
 
+void InyokaEdit::writePreview(const QString &sRetHTML) {
   // File for temporary html output
   QFile tmphtmlfile(m_sPreviewFile);
 
@@ -816,6 +1042,7 @@ void InyokaEdit::previewInyokaPage() {
                          tr("Could not create temporary HTML file!"));
     qWarning() << "Could not create temporary HTML file:"
                << m_sPreviewFile;
+    m_bPreviewStatsPending = false;
     return;
   }
 
@@ -830,6 +1057,7 @@ void InyokaEdit::previewInyokaPage() {
   // Write HTML code into output file
   tmpoutputstream << sRetHTML;
   tmphtmlfile.close();
+  this->addPreviewStage(QStringLiteral("Write"));
 
   // Store scroll position
 #ifdef USEQTWEBKIT
@@ -841,12 +1069,28 @@ void InyokaEdit::previewInyokaPage() {
 
 #ifdef NOPREVIEW
   static bool bOpenedBrowser = false;
+  if (nullptr != m_pPreviewServer) {
+    // Folder of previewed article, which changes with editor or file name
+    m_pPreviewServer->setArticleFile(m_pFileOperations->getCurrentFile());
+    m_pPreviewServer->publish(sRetHTML);
+  }
   if (!bOpenedBrowser) {
-    QDesktopServices::openUrl(
-          QUrl::fromLocalFile(
-            QFileInfo(tmphtmlfile).absoluteFilePath()));
+    if (nullptr != m_pPreviewServer) {
+      QDesktopServices::openUrl(m_pPreviewServer->getUrl());
+    } else {
+      QDesktopServices::openUrl(
+            QUrl::fromLocalFile(
+              QFileInfo(tmphtmlfile).absoluteFilePath()));
+    }
     bOpenedBrowser = true;
   }
+  if (m_bPreviewStatsPending) {
+    m_bPreviewStatsPending = false;
+    m_pDiagnostics->addPreview(m_previewStatistics);
+  }
+  if (m_bConfirmPreview) {
+    QTimer::singleShot(0, this, &InyokaEdit::previewInyokaPage);
+  }
 #else
   m_pWebview->load(
         QUrl::fromLocalFile(
@@ -854,51 +1098,53 @@ void InyokaEdit::previewInyokaPage() {
 #endif
 }
 
+// ----------------------------------------------------------------------------
+
+void InyokaEdit::addPreviewStage(const QString &sStage) {
+  if (m_bPreviewStatsPending) {
+    m_previewStatistics.listStages << qMakePair(
+                                        sStage,
+                                        m_previewStageTimer.nsecsElapsed());
+    m_previewStageTimer.restart();
+  }
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-void InyokaEdit::highlightSyntaxError(const QPair<int, QString> &error) {
+void InyokaEdit::highlightSyntaxError(const QList<SyntaxError> &listErrors) {
   QList<QTextEdit::ExtraSelection> extras;
   QTextEdit::ExtraSelection selection;
 
   selection.format.setBackground(m_colorSyntaxError);
-  selection.format.setProperty(QTextFormat::FullWidthSelection, true);
-
-  extras.clear();
-  if (-1 != error.first) {
-    QTextCursor initialCur = m_pCurrentEditor->textCursor();
-    selection.cursor = m_pCurrentEditor->textCursor();
-    selection.cursor.setPosition(error.first);
-    selection.cursor.clearSelection();
-    extras << selection;
-    m_pCurrentEditor->setTextCursor(selection.cursor);
-
-    QFontMetrics fm1(QToolTip::font());
-    QFontMetrics fm2(m_pSettings->getEditorFont());
-    QPoint cur = m_pCurrentEditor->cursorRect().topLeft();
-    cur.setY(cur.y() + m_pCurrentEditor->viewport()->mapToGlobal(
-          m_pCurrentEditor->pos()).y() - fm1.height() - fm2.height() - 10);
-    cur.setX(cur.x() + m_pCurrentEditor->viewport()->mapToGlobal(
-          m_pCurrentEditor->pos()).x());
-    QString sError(error.second);
-    if ("OPEN_PAR_MISSING" == sError) {
-      sError = tr("Opening parenthesis missing!");
-    } else if ("CLOSE_PAR_MISSING" == sError) {
-      sError = tr("Closing parenthesis missing!");
-    } else if (sError.startsWith(QLatin1String("UNKNOWN_TPL|"))) {
-      sError = sError.remove(QStringLiteral("UNKNOWN_TPL|"));
-      sError = tr("Unknown template:") + " " + sError;
-    } else {
-      qWarning() << "Unknown syntax error code: " + sError;
-      sError = tr("Syntax error");
+
+  // Keep inline spell check markers
+  const QList<QTextEdit::ExtraSelection> listOld(
+        m_pCurrentEditor->extraSelections());
+  for (const auto &old : listOld) {
+    if (old.format.hasProperty(ISpellChecker::m_cMARKERPROPERTY)) {
+      extras << old;
     }
-    QToolTip::showText(cur, sError);
+  }
 
-    // Reset cursor to initial position to not disturb writing
-    m_pCurrentEditor->setTextCursor(initialCur);
+  const int nLast = m_pCurrentEditor->document()->characterCount() - 1;
+  for (const auto &error : listErrors) {
+    selection.cursor = QTextCursor(m_pCurrentEditor->document());
+    selection.cursor.setPosition(qBound(0, error.nPos, nLast));
+    // Errors without length (e.g. missing end of table row): whole line
+    selection.format.setProperty(QTextFormat::FullWidthSelection,
+                                 error.nLength <= 0);
+    if (error.nLength > 0) {
+      selection.cursor.setPosition(qBound(0, error.nPos + error.nLength,
+                                          nLast),
+                                   QTextCursor::KeepAnchor);
+    }
+    extras << selection;
   }
 
   m_pCurrentEditor->setExtraSelections(extras);
+  // Panel is only opened by user (tools menu); error count is shown in title
+  m_pSyntaxPanel->setErrors(listErrors, m_pCurrentEditor->document());
 }
 
 // ----------------------------------------------------------------------------
@@ -1051,6 +1297,16 @@ void InyokaEdit::displayArticleText(const QString &sArticleText,
 #ifndef NOPREVIEW
 // Wait until loading has finished
 void InyokaEdit::loadPreviewFinished(const bool bSuccess) {
+  if (m_bPreviewStatsPending) {
+    this->addPreviewStage(QStringLiteral("Load"));
+    m_bPreviewStatsPending = false;
+    m_pDiagnostics->addPreview(m_previewStatistics);
+  }
+  if (m_bConfirmPreview) {
+    // Cached preview is visible, parse current text in next event loop
+    QTimer::singleShot(0, this, &InyokaEdit::previewInyokaPage);
+  }
+
   if (bSuccess) {
     // Enable / disbale back button
     if (m_pWebview->history()->canGoBack()) {
@@ -1105,9 +1361,23 @@ void InyokaEdit::clickedLink(const QUrl &newUrl) {
 // ----------------------------------------------------------------------------
 
 void InyokaEdit::updateEditorSettings() {
+  quint32 nTimedPreview(m_pSettings->getTimedPreview());
+#ifdef NOPREVIEW
+  if (nullptr != m_pPreviewServer) {
+    nTimedPreview = 0;  // No meta refresh, browser is notified by server
+  }
+#endif
   m_pParser->updateSettings(m_pSettings->getInyokaUrl(),
                             m_pSettings->getCheckLinks(),
-                            m_pSettings->getTimedPreview());
+                            nTimedPreview);
+  // Everything with influence on parsed body invalidates cached previews
+  m_pPreviewCache->setVersion(
+        QByteArrayLiteral(APP_VERSION) +
+        m_pSettings->getInyokaCommunity().toUtf8() + '\n' +
+        m_pSettings->getInyokaUrl().toUtf8() + '\n' +
+        m_pSettings->getPygmentize().toUtf8() + '\n' +
+        QByteArray::number(m_pSettings->getCheckLinks()) + '\n' +
+        m_pTemplates->getVersion(true));
 
   if (m_pSettings->getPreviewHorizontal()) {
     m_pWidgetSplitter->setOrientation(Qt::Vertical);
@@ -1130,6 +1400,7 @@ void InyokaEdit::updateEditorSettings() {
                                     m_pSettings->getInyokaConstructionArea());
 
   m_pPlugins->setEditorlist(m_pFileOperations->getEditors());
+  m_pLiveSyntaxCheck->setEnabled(m_pSettings->getSyntaxCheck());
 
   m_colorSyntaxError = InyokaEdit::getHighlightErrorColor();
 
@@ -1247,6 +1518,30 @@ void InyokaEdit::deleteTempImages() {
   }
 }
 
+// ----------------------------------------------------------------------------
+
+void InyokaEdit::exportTrace() {
+  if (!Trace::isEnabled()) {
+    int nRet = QMessageBox::question(this, qApp->applicationName(),
+                                     tr("Tracing is not active. Do you want "
+                                        "to start recording now?"),
+                                     QMessageBox::Yes | QMessageBox::No);
+    if (QMessageBox::Yes == nRet) {
+      Trace::setEnabled(true);
+    }
+    return;
+  }
+
+  const QString sFile = QFileDialog::getSaveFileName(
+                          this, tr("Export trace"),
+                          m_UserDataDir.absolutePath() + "/trace.json",
+                          tr("Chrome trace") + " (*.json)");
+  if (!sFile.isEmpty() && !Trace::save(sFile)) {
+    QMessageBox::warning(this, qApp->applicationName(),
+                         tr("Could not save trace file!"));
+  }
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
@@ -1395,7 +1690,9 @@ void InyokaEdit::changeEvent(QEvent *pEvent) {
   if (nullptr != pEvent) {
     if (QEvent::LanguageChange == pEvent->type()) {
       m_pUi->retranslateUi(this);
-      this->createXmlMenus();
+      if (m_bStartupFinished) {  // Otherwise created by finishStartup()
+        this->createXmlMenus();
+      }
       emit updateUiLang();
     }
   }
@@ -1416,7 +1713,6 @@ void InyokaEdit::showSyntaxOverview() {
 #ifdef USEQTWEBENGINE
   auto *pWebview = new QWebEngineView();
 #endif
-  auto *pTextDocument = new QTextDocument(this);
 
   QFile OverviewFile(m_sSharePath + "/community/" +
                      m_pSettings->getInyokaCommunity() +
@@ -1432,30 +1728,18 @@ void InyokaEdit::showSyntaxOverview() {
     pLayout = nullptr;
     delete pWebview;
     pWebview = nullptr;
-    delete pTextDocument;
-    pTextDocument = nullptr;
     return;
   }
-  pTextDocument->setPlainText(in.readAll());
+  // Overview is a complete article: With paragraphs, but no page title
+  const QString sRet(m_pParser->genFragment(in.readAll(), true, true));
   OverviewFile.close();
 
-  QString sRet(m_pParser->genOutput(QLatin1String(""), pTextDocument));
-  sRet.remove(
-        QRegularExpression(QStringLiteral("<h1 class=\"pagetitle\">.*</h1>"),
-                           QRegularExpression::DotMatchesEverythingOption));
-  sRet.remove(
-        QRegularExpression(QStringLiteral("<p class=\"meta\">.*</p>"),
-                           QRegularExpression::DotMatchesEverythingOption));
-  sRet.replace(QLatin1String("</style>"),
-               QLatin1String("#page table{margin:0px;}</style>"));
-  pTextDocument->setPlainText(sRet);
-
   pLayout->setContentsMargins(2, 2, 2, 2);
   pLayout->setSpacing(0);
   pLayout->addWidget(pWebview);
   pDialog->setWindowTitle(tr("Syntax overview"));
 
-  pWebview->setHtml(pTextDocument->toPlainText(),
+  pWebview->setHtml(sRet,
                     QUrl::fromLocalFile(m_UserDataDir.absolutePath() + "/"));
   pDialog->show();
 }
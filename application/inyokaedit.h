@@ -29,9 +29,14 @@
 
 #include <QAction>  // Cannot use forward declaration (since Qt 6)
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFuture>
 #include <QMainWindow>
 #include <QTranslator>
 
+#include "./parser/parser.h"
+#include "./parser/parsestatistics.h"
+
 class QComboBox;
 class QFile;
 class QSplitter;
@@ -43,12 +48,18 @@ class QWebView;
 class QWebEngineView;
 #endif
 
+class Diagnostics;
 class Download;
 class FileOperations;
-class Parser;
+class FileSearchPanel;
+class LibraryPanel;
+class LiveSyntaxCheck;
 class Plugins;
+class PreviewCache;
+class PreviewServer;
 class Settings;
 class Session;
+class SyntaxPanel;
 class Templates;
 class TextEditor;
 class Upload;
@@ -93,7 +104,8 @@ class InyokaEdit : public QMainWindow {
     void insertMacro(const QString &sInsert);
     void dropdownXmlChanged(int nIndex);
     void deleteTempImages();
-    void highlightSyntaxError(const QPair<int, QString> &error);
+    void exportTrace();
+    void highlightSyntaxError(const QList<SyntaxError> &listErrors);
     static QColor getHighlightErrorColor();
     // Preview
     void previewInyokaPage();
@@ -108,7 +120,10 @@ class InyokaEdit : public QMainWindow {
 #endif
 
  private:
+    void loadCommunityData();
     void createObjects();
+    void finishStartup();
+    void startupPhase(const char *sPhase);
     void createActions();
     void createMenus();
     void setupEditor();
@@ -117,6 +132,8 @@ class InyokaEdit : public QMainWindow {
     void deleteAutoSaveBackups();
     void readSettings();
     void writeSettings();
+    void addPreviewStage(const QString &sStage);
+    void writePreview(const QString &sRetHTML);
     static auto switchTranslator(
         QTranslator *translator,
         const QString &sFile,
@@ -126,16 +143,23 @@ class InyokaEdit : public QMainWindow {
     QTranslator m_translator;  // App translations
     QTranslator m_translatorQt;  // Qt translations
     QString m_sCurrLang;
+    QFuture<Templates *> m_futureTemplates;
     Templates *m_pTemplates{};
     FileOperations *m_pFileOperations{};
     TextEditor *m_pCurrentEditor{};
     Plugins *m_pPlugins{};
     Parser *m_pParser{};
+    PreviewCache *m_pPreviewCache{};
     Settings *m_pSettings{};
     Session *m_pSession{};
     Download *m_pDownloadModule{};
     Upload *m_pUploadModule{};
     Utils *m_pUtils{};
+    Diagnostics *m_pDiagnostics{};
+    SyntaxPanel *m_pSyntaxPanel{};
+    FileSearchPanel *m_pFileSearchPanel{};
+    LibraryPanel *m_pLibraryPanel{};
+    LiveSyntaxCheck *m_pLiveSyntaxCheck{};
     QSplitter *m_pWidgetSplitter{};
     QTabWidget *m_pDocumentTabs{};
     QPoint m_WebviewScrollPosition;
@@ -145,6 +169,9 @@ class InyokaEdit : public QMainWindow {
 #ifdef USEQTWEBENGINE
     QWebEngineView *m_pWebview{};
 #endif
+#ifdef NOPREVIEW
+    PreviewServer *m_pPreviewServer{};
+#endif
 
     QList<QAction *> m_OpenTemplateFilesActions;
 
@@ -162,10 +189,18 @@ class InyokaEdit : public QMainWindow {
     QColor m_colorSyntaxError;
     QDir m_tmpPreviewImgDir;
     QTimer *m_pPreviewTimer;
+    PreviewStatistics m_previewStatistics;
+    QElapsedTimer m_previewStageTimer;
+    bool m_bPreviewStatsPending;
+    ParsedBody m_CachedPreview;
+    bool m_bConfirmPreview;
     bool m_bOpenFileAfterStart;
     bool m_bEditorScrolling;
     bool m_bWebviewScrolling;
     bool m_bReloadPreviewBlocked;
+    bool m_bStartupFinished;
+    QElapsedTimer m_startupTimer;
+    qint64 m_nStartupPhase;
 };
 
 #endif  // APPLICATION_INYOKAEDIT_H_
@@ -0,0 +1,62 @@
+/**
+ * \file irenderservice.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Interface definition for application services shared with plugins.
+ */
+// clazy:excludeall=copyable-polymorphic
+
+#ifndef APPLICATION_IRENDERSERVICE_H_
+#define APPLICATION_IRENDERSERVICE_H_
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+class Templates;
+
+/**
+ * \class IRenderService
+ * \brief Parser and community data of application, handed to each plugin
+ *
+ * Plugins must not create own Templates or Parser objects; both are loaded
+ * only once per process by the application.
+ */
+class IRenderService {
+ public:
+    virtual ~IRenderService() {}
+
+    // Loaded community data (read only, lifetime of application)
+    virtual const Templates *getTemplates() const = 0;
+    // Macro name and keywords (see Templates::getMacroDefinitions()), so that
+    // plugins do not have to link the templates sources for it
+    virtual QList<QPair<QString, QStringList>> getMacroDefinitions() const = 0;
+    // Complete HTML page of Inyoka markup; can be called from any thread
+    virtual QString render(const QString &sRawText,
+                           const QString &sFileName = QString()) = 0;
+    // Snippet only (see Parser::genFragment()); can be called from any thread
+    virtual QString renderFragment(const QString &sFragment,
+                                   const bool bWithStyle) = 0;
+};
+
+#endif  // APPLICATION_IRENDERSERVICE_H_
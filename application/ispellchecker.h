@@ -0,0 +1,65 @@
+/**
+ * \file ispellchecker.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Interface definition for spell checking without GUI.
+ */
+// clazy:excludeall=copyable-polymorphic
+
+#ifndef APPLICATION_ISPELLCHECKER_H_
+#define APPLICATION_ISPELLCHECKER_H_
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QTextFormat>
+#include <QtPlugin>
+
+/**
+ * \class ISpellChecker
+ * \brief Optional second interface of a spell checker plugin
+ *
+ * initPlugin() has to be called before (parent and editor may be nullptr).
+ */
+class ISpellChecker {
+ public:
+    virtual ~ISpellChecker() {}
+
+    // Format property of inline spell check markers (editor extra
+    // selections); other users of setExtraSelections() have to keep them
+    static const int m_cMARKERPROPERTY = QTextFormat::UserProperty + 1;
+    // IID of spell checker plugin (Q_PLUGIN_METADATA), for headless loading
+    static constexpr const char *m_cPLUGINIID = "InyokaEdit.spellchecker";
+
+    // Load dictionaries, call once from main thread
+    virtual bool initSpellCheck() = 0;
+    // Unknown words of text (position, word); thread safe
+    virtual QList<QPair<int, QString>> checkText(const QString &sText) = 0;
+    // Suggestions for an unknown word; thread safe
+    virtual QStringList getSuggestions(const QString &sWord) = 0;
+};
+
+// Version suffix: Plugins built against older interface are rejected
+Q_DECLARE_INTERFACE(ISpellChecker, "InyokaEdit.SpellCheckInterface/2")
+
+#endif  // APPLICATION_ISPELLCHECKER_H_
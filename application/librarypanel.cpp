@@ -0,0 +1,307 @@
+/**
+ * \file librarypanel.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Browse articles of library folder, open by title, backlinks, broken links.
+ */
+
+#include "./librarypanel.h"
+
+#include <QDebug>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QTabWidget>
+#include <QTextCursor>
+#include <QToolButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include "./fileoperations.h"
+#include "./settings.h"
+#include "./texteditor.h"
+
+LibraryPanel::LibraryPanel(const ArticleScanner &scanner,
+                           const QString &sIndexDir,
+                           FileOperations *pFileOperations,
+                           Settings *pSettings, QWidget *pParent)
+  : QDockWidget(pParent),
+    m_pLibrary(new ArticleLibrary(scanner, sIndexDir, this)),
+    m_pFileOperations(pFileOperations),
+    m_pSettings(pSettings),
+    m_pDirEdit(new QLineEdit(this)),
+    m_pDirButton(new QToolButton(this)),
+    m_pUpdateButton(new QToolButton(this)),
+    m_pStatusLabel(new QLabel(this)),
+    m_pFilterEdit(new QLineEdit(this)),
+    m_pTabs(new QTabWidget(this)) {
+  this->setObjectName(QStringLiteral("LibraryPanel"));
+  this->setWindowTitle(tr("Article library"));
+
+  m_pDirEdit->setReadOnly(true);
+  m_pDirEdit->setPlaceholderText(tr("Select folder with articles"));
+  m_pDirButton->setText(QStringLiteral("..."));
+  m_pUpdateButton->setText(tr("Update"));
+  m_pFilterEdit->setPlaceholderText(tr("Find title..."));
+  m_pFilterEdit->setClearButtonEnabled(true);
+
+  m_pArticleTree = this->createTree(QStringList() << tr("Page")
+                                    << tr("Title"));
+  m_pTagTree = this->createTree(QStringList() << tr("Tag / page")
+                                << tr("Title"));
+  m_pTagTree->setRootIsDecorated(true);
+  m_pBacklinkTree = this->createTree(QStringList() << tr("Page")
+                                     << tr("Title"));
+  m_pBrokenTree = this->createTree(QStringList() << tr("Page")
+                                   << tr("Link") << tr("Problem"));
+  m_pTabs->addTab(m_pArticleTree, tr("Articles"));
+  m_pTabs->addTab(m_pTagTree, tr("Tags"));
+  m_pTabs->addTab(m_pBacklinkTree, tr("Backlinks"));
+  m_pTabs->addTab(m_pBrokenTree, tr("Broken links"));
+
+  auto *pDirLayout = new QHBoxLayout();
+  pDirLayout->addWidget(m_pDirEdit, 1);
+  pDirLayout->addWidget(m_pDirButton);
+  pDirLayout->addWidget(m_pUpdateButton);
+
+  auto *pWidget = new QWidget(this);
+  auto *pLayout = new QVBoxLayout(pWidget);
+  pLayout->addLayout(pDirLayout);
+  pLayout->addWidget(m_pStatusLabel);
+  pLayout->addWidget(m_pFilterEdit);
+  pLayout->addWidget(m_pTabs);
+  this->setWidget(pWidget);
+
+  connect(m_pDirButton, &QToolButton::clicked,
+          this, &LibraryPanel::selectDir);
+  connect(m_pUpdateButton, &QToolButton::clicked,
+          this, &LibraryPanel::updateLibrary);
+  connect(m_pFilterEdit, &QLineEdit::textChanged,
+          this, &LibraryPanel::fillArticles);
+  connect(m_pFilterEdit, &QLineEdit::returnPressed, this, [this]() {
+    this->activatedItem(m_pArticleTree->topLevelItem(0));
+  });
+  connect(m_pLibrary, &ArticleLibrary::updated,
+          this, &LibraryPanel::updatedLibrary);
+
+  const QString sDir(m_pSettings->getLibraryDir());
+  if (!sDir.isEmpty() && QFileInfo(sDir).isDir()) {
+    m_pDirEdit->setText(sDir);
+    m_pLibrary->setDir(sDir);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+auto LibraryPanel::createTree(const QStringList &sListHeader) -> QTreeWidget* {
+  auto *pTree = new QTreeWidget(this);
+  pTree->setColumnCount(sListHeader.size());
+  pTree->setHeaderLabels(sListHeader);
+  pTree->setRootIsDecorated(false);
+  pTree->header()->setStretchLastSection(true);
+  connect(pTree, &QTreeWidget::itemActivated,
+          this, &LibraryPanel::activatedItem);
+  return pTree;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void LibraryPanel::showTitleSearch() {
+  this->show();
+  this->raise();
+  m_pTabs->setCurrentWidget(m_pArticleTree);
+  m_pFilterEdit->setFocus();
+  m_pFilterEdit->selectAll();
+  if (m_pLibrary->getDir().isEmpty()) {
+    this->selectDir();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void LibraryPanel::setCurrentFile(const QString &sFile) {
+  m_sCurrentFile = QFileInfo(sFile).absoluteFilePath();
+  this->fillBacklinks();
+}
+
+// ----------------------------------------------------------------------------
+
+void LibraryPanel::selectDir() {
+  const QString sDir(QFileDialog::getExistingDirectory(
+                       this, tr("Select library folder"),
+                       m_pDirEdit->text()));
+  if (sDir.isEmpty()) {
+    return;
+  }
+  m_pDirEdit->setText(sDir);
+  m_pSettings->setLibraryDir(sDir);
+  m_pLibrary->setDir(sDir);
+  m_pStatusLabel->setText(tr("Updating library..."));
+}
+
+// ----------------------------------------------------------------------------
+
+void LibraryPanel::updateLibrary() {
+  if (m_pLibrary->getDir().isEmpty()) {
+    return;
+  }
+  m_pLibrary->update();
+  m_pStatusLabel->setText(tr("Updating library..."));
+}
+
+// ----------------------------------------------------------------------------
+
+void LibraryPanel::updatedLibrary(const int nChanged) {
+  Q_UNUSED(nChanged)
+  const int nArticles = m_pLibrary->getFiles().size();
+  if (m_pLibrary->isUpdating()) {
+    m_pStatusLabel->setText(tr("Updating library..."));
+  } else {
+    m_pStatusLabel->setText(tr("%1 articles").arg(nArticles));
+  }
+  this->fillArticles();
+  this->fillTags();
+  this->fillBacklinks();
+  this->fillBrokenLinks();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void LibraryPanel::fillArticles() {
+  m_pArticleTree->clear();
+  const QStringList sListFiles(m_pLibrary->findTitle(m_pFilterEdit->text()));
+  for (const auto &sFile : sListFiles) {
+    m_pArticleTree->addTopLevelItem(this->createItem(sFile));
+  }
+  m_pArticleTree->resizeColumnToContents(0);
+}
+
+// ----------------------------------------------------------------------------
+
+void LibraryPanel::fillTags() {
+  m_pTagTree->clear();
+  const QMap<QString, QStringList> mapTags(m_pLibrary->getTags());
+  for (auto it = mapTags.constBegin(); it != mapTags.constEnd(); ++it) {
+    auto *pTagItem = new QTreeWidgetItem(m_pTagTree);
+    pTagItem->setText(0, it.key() + " (" +
+                      QString::number(it.value().size()) + ")");
+    for (const auto &sFile : it.value()) {
+      pTagItem->addChild(this->createItem(sFile));
+    }
+  }
+  m_pTagTree->resizeColumnToContents(0);
+}
+
+// ----------------------------------------------------------------------------
+
+void LibraryPanel::fillBacklinks() {
+  m_pBacklinkTree->clear();
+  if (m_sCurrentFile.isEmpty()) {
+    return;
+  }
+  const QStringList sListFiles(m_pLibrary->getBacklinks(m_sCurrentFile));
+  for (const auto &sFile : sListFiles) {
+    m_pBacklinkTree->addTopLevelItem(this->createItem(sFile));
+  }
+  m_pBacklinkTree->resizeColumnToContents(0);
+  m_pTabs->setTabText(m_pTabs->indexOf(m_pBacklinkTree),
+                      tr("Backlinks") + " (" +
+                      QString::number(sListFiles.size()) + ")");
+}
+
+// ----------------------------------------------------------------------------
+
+void LibraryPanel::fillBrokenLinks() {
+  m_pBrokenTree->clear();
+  const QList<LibraryLink> listBroken(m_pLibrary->getBrokenLinks());
+  for (const auto &link : listBroken) {
+    QTreeWidgetItem *pItem = this->createItem(link.sFile);
+    pItem->setText(1, link.sLink);
+    pItem->setText(2, LibraryPanel::getLinkErrorText(link.sCode));
+    pItem->setData(0, Qt::UserRole + 1, link.sLink);
+    m_pBrokenTree->addTopLevelItem(pItem);
+  }
+  m_pBrokenTree->resizeColumnToContents(0);
+  m_pBrokenTree->resizeColumnToContents(1);
+  m_pTabs->setTabText(m_pTabs->indexOf(m_pBrokenTree),
+                      tr("Broken links") + " (" +
+                      QString::number(listBroken.size()) + ")");
+}
+
+// ----------------------------------------------------------------------------
+
+auto LibraryPanel::createItem(
+    const QString &sFile) const -> QTreeWidgetItem* {
+  auto *pItem = new QTreeWidgetItem();
+  pItem->setText(0, m_pLibrary->getPageName(sFile));
+  pItem->setText(1, m_pLibrary->getTitle(sFile));
+  pItem->setToolTip(0, sFile);
+  pItem->setData(0, Qt::UserRole, sFile);
+  return pItem;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void LibraryPanel::activatedItem(QTreeWidgetItem *pItem) {
+  if (nullptr == pItem) {
+    return;
+  }
+  const QString sFile(pItem->data(0, Qt::UserRole).toString());
+  if (sFile.isEmpty()) {
+    return;  // Tag
+  }
+
+  TextEditor *pEditor = m_pFileOperations->showFile(sFile);
+  if (nullptr == pEditor) {
+    return;
+  }
+  // Select broken link
+  const QString sLink(pItem->data(0, Qt::UserRole + 1).toString());
+  if (!sLink.isEmpty()) {
+    pEditor->moveCursor(QTextCursor::Start);
+    pEditor->find(sLink);
+  }
+  pEditor->setFocus();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto LibraryPanel::getLinkErrorText(const QString &sCode) -> QString {
+  if ("PAGE_MISSING" == sCode) {
+    return tr("Page not found in library");
+  }
+  if ("SECTION_MISSING" == sCode) {
+    return tr("Section not found in linked page");
+  }
+  if ("IMAGE_MISSING" == sCode) {
+    return tr("Image not found next to article");
+  }
+  qWarning() << "Unknown link error code: " + sCode;
+  return tr("Broken link");
+}
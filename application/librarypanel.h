@@ -0,0 +1,94 @@
+/**
+ * \file librarypanel.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for article library panel.
+ */
+
+#ifndef APPLICATION_LIBRARYPANEL_H_
+#define APPLICATION_LIBRARYPANEL_H_
+
+#include <QDockWidget>
+
+#include "./articlelibrary.h"
+
+class QLabel;
+class QLineEdit;
+class QTabWidget;
+class QToolButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+class FileOperations;
+class Settings;
+
+/**
+ * \class LibraryPanel
+ * \brief Articles of library folder by title and tag, backlinks of current
+ *        document and offline report of broken links
+ */
+class LibraryPanel : public QDockWidget {
+  Q_OBJECT
+
+ public:
+    LibraryPanel(const ArticleScanner &scanner, const QString &sIndexDir,
+                 FileOperations *pFileOperations, Settings *pSettings,
+                 QWidget *pParent = nullptr);
+
+    void showTitleSearch();
+    static auto getLinkErrorText(const QString &sCode) -> QString;
+
+ public slots:
+    void setCurrentFile(const QString &sFile);
+    void updateLibrary();
+
+ private slots:
+    void selectDir();
+    void updatedLibrary(const int nChanged);
+    void fillArticles();
+    void activatedItem(QTreeWidgetItem *pItem);
+
+ private:
+    void fillTags();
+    void fillBacklinks();
+    void fillBrokenLinks();
+    auto createItem(const QString &sFile) const -> QTreeWidgetItem*;
+    auto createTree(const QStringList &sListHeader) -> QTreeWidget*;
+
+    ArticleLibrary *m_pLibrary;
+    FileOperations *m_pFileOperations;
+    Settings *m_pSettings;
+    QString m_sCurrentFile;
+
+    QLineEdit *m_pDirEdit;
+    QToolButton *m_pDirButton;
+    QToolButton *m_pUpdateButton;
+    QLabel *m_pStatusLabel;
+    QLineEdit *m_pFilterEdit;
+    QTabWidget *m_pTabs;
+    QTreeWidget *m_pArticleTree;
+    QTreeWidget *m_pTagTree;
+    QTreeWidget *m_pBacklinkTree;
+    QTreeWidget *m_pBrokenTree;
+};
+
+#endif  // APPLICATION_LIBRARYPANEL_H_
@@ -0,0 +1,204 @@
+/**
+ * \file livesyntaxcheck.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Syntax check of editor in background with cached results per block.
+ */
+
+#include "./livesyntaxcheck.h"
+
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include "./texteditor.h"
+#include "./trace/trace.h"
+
+LiveSyntaxCheck::LiveSyntaxCheck(const SyntaxCheck &syntaxCheck,
+                                 QObject *pParent)
+  : QObject(pParent),
+    m_syntaxCheck(syntaxCheck),
+    m_pCheckedDoc(nullptr),
+    m_pTimer(new QTimer(this)),
+    m_bEnabled(false),
+    m_bChanged(false) {
+  m_pTimer->setSingleShot(true);
+  m_pTimer->setInterval(m_cCHECKDELAY);
+  connect(m_pTimer, &QTimer::timeout,
+          this, &LiveSyntaxCheck::startCheck);
+  connect(&m_watcher, &QFutureWatcher<LiveSyntaxResult>::finished,
+          this, &LiveSyntaxCheck::finishedCheck);
+}
+
+LiveSyntaxCheck::~LiveSyntaxCheck() {
+  // Worker is using this object
+  m_watcher.waitForFinished();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void LiveSyntaxCheck::setEditor(TextEditor *pEditor) {
+  QObject::disconnect(m_contentsConnection);
+  m_pEditor = pEditor;
+  m_listCache.clear();
+  m_bChanged = true;
+  if (!m_bEnabled || m_pEditor.isNull()) {
+    return;
+  }
+
+  for (int i = 0; i < m_pEditor->document()->blockCount(); i++) {
+    m_listCache << CachedSyntaxLine();
+  }
+  m_contentsConnection = connect(m_pEditor->document(),
+                                 &QTextDocument::contentsChange,
+                                 this, &LiveSyntaxCheck::changedContents);
+  m_pTimer->start();
+}
+
+// ----------------------------------------------------------------------------
+
+void LiveSyntaxCheck::setEnabled(const bool bEnabled) {
+  if (bEnabled == m_bEnabled) {
+    return;
+  }
+  m_bEnabled = bEnabled;
+  if (!m_bEnabled) {
+    m_pTimer->stop();
+    emit this->checked(QList<SyntaxError>());
+  }
+  this->setEditor(m_pEditor);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void LiveSyntaxCheck::changedContents(int nPosition, int nCharsRemoved,
+                                      int nCharsAdded) {
+  Q_UNUSED(nCharsRemoved)
+  if (m_pEditor.isNull()) {
+    return;
+  }
+  const QTextDocument *pDoc = m_pEditor->document();
+  const int nFirst = pDoc->findBlock(nPosition).blockNumber();
+  const int nLast = pDoc->findBlock(
+                      qMin(nPosition + nCharsAdded,
+                           pDoc->characterCount() - 1)).blockNumber();
+  // Changed blocks nFirst..nOldLast are replaced by nFirst..nLast
+  const int nOldLast = nLast - (pDoc->blockCount() - m_listCache.size());
+
+  if (nFirst < 0 || nLast < nFirst || nOldLast < nFirst - 1 ||
+      nOldLast >= m_listCache.size()) {
+    m_listCache.clear();
+    for (int i = 0; i < pDoc->blockCount(); i++) {
+      m_listCache << CachedSyntaxLine();
+    }
+  } else {
+    m_listCache.erase(m_listCache.begin() + nFirst,
+                      m_listCache.begin() + nOldLast + 1);
+    for (int i = nFirst; i <= nLast; i++) {
+      m_listCache.insert(i, CachedSyntaxLine());
+    }
+  }
+
+  m_bChanged = true;
+  m_pTimer->start();
+}
+
+// ----------------------------------------------------------------------------
+
+void LiveSyntaxCheck::startCheck() {
+  if (!m_bEnabled || m_pEditor.isNull()) {
+    return;
+  }
+  if (m_watcher.isRunning()) {
+    m_pTimer->start();
+    return;
+  }
+
+  // Copy of text; only blocks without valid cache entry are scanned
+  QStringList sListLines;
+  const QTextDocument *pDoc = m_pEditor->document();
+  for (QTextBlock block = pDoc->begin(); block.isValid();
+       block = block.next()) {
+    sListLines << block.text();
+  }
+
+  m_pCheckedDoc = m_pEditor->document();
+  m_bChanged = false;
+  const QList<CachedSyntaxLine> listCache(m_listCache);
+  m_watcher.setFuture(QtConcurrent::run([this, sListLines, listCache]() {
+    return this->checkLines(sListLines, listCache);
+  }));
+}
+
+// ----------------------------------------------------------------------------
+
+void LiveSyntaxCheck::finishedCheck() {
+  // Outdated, changes are checked again
+  if (m_bChanged || m_pEditor.isNull() ||
+      m_pEditor->document() != m_pCheckedDoc) {
+    return;
+  }
+
+  const LiveSyntaxResult result(m_watcher.result());
+  m_listCache = result.listCache;
+  emit this->checked(result.listErrors);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+// Runs in worker thread; balance of brackets is combined from cached lines
+auto LiveSyntaxCheck::checkLines(
+    const QStringList &sListLines,
+    QList<CachedSyntaxLine> listCache) const -> LiveSyntaxResult {
+  TraceSpan span("syntaxcheck", "checkLines");
+  LiveSyntaxResult result;
+  QList<SyntaxBracket> listStack;
+  int nState = 0;
+  int nOffset = 0;
+
+  if (listCache.size() != sListLines.size()) {
+    listCache.clear();
+    for (int i = 0; i < sListLines.size(); i++) {
+      listCache << CachedSyntaxLine();
+    }
+  }
+
+  for (int i = 0; i < sListLines.size(); i++) {
+    if (nState != listCache.at(i).nStartState) {
+      listCache[i].nStartState = nState;
+      listCache[i].line = m_syntaxCheck.checkLine(sListLines.at(i), nState);
+    }
+    const SyntaxLine &line = listCache.at(i).line;
+    SyntaxCheck::appendLine(line, nOffset, &listStack, &result.listErrors);
+    nState = line.nEndState;
+    nOffset += sListLines.at(i).size() + 1;
+  }
+  SyntaxCheck::finish(nState, qMax(0, nOffset - 1), &listStack,
+                      &result.listErrors);
+
+  result.listCache = listCache;
+  return result;
+}
@@ -0,0 +1,101 @@
+/**
+ * \file livesyntaxcheck.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for syntax check of editor in background.
+ */
+
+#ifndef APPLICATION_LIVESYNTAXCHECK_H_
+#define APPLICATION_LIVESYNTAXCHECK_H_
+
+#include <QFutureWatcher>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+
+#include "./syntaxcheck.h"
+
+class QTextDocument;
+class QTimer;
+
+class TextEditor;
+
+// Result of one block and state it was checked with (-1: not checked)
+struct CachedSyntaxLine {
+  int nStartState = -1;
+  SyntaxLine line;
+};
+
+struct LiveSyntaxResult {
+  QList<SyntaxError> listErrors;
+  QList<CachedSyntaxLine> listCache;
+};
+
+/**
+ * \class LiveSyntaxCheck
+ * \brief Syntax check of current editor in a worker thread
+ *
+ * Started after typing paused, independent from preview. Results of
+ * unchanged blocks are cached; only changed blocks (and following blocks
+ * with changed start state) are scanned again.
+ */
+class LiveSyntaxCheck : public QObject {
+  Q_OBJECT
+
+ public:
+    explicit LiveSyntaxCheck(const SyntaxCheck &syntaxCheck,
+                             QObject *pParent = nullptr);
+    ~LiveSyntaxCheck();
+
+    void setEditor(TextEditor *pEditor);
+    void setEnabled(const bool bEnabled);
+
+ signals:
+    void checked(const QList<SyntaxError> &listErrors);
+
+ private slots:
+    void changedContents(int nPosition, int nCharsRemoved, int nCharsAdded);
+    void startCheck();
+    void finishedCheck();
+
+ private:
+    auto checkLines(
+        const QStringList &sListLines,
+        QList<CachedSyntaxLine> listCache) const -> LiveSyntaxResult;
+
+    // Delay after last change before document is checked (ms)
+    static const int m_cCHECKDELAY = 500;
+
+    const SyntaxCheck m_syntaxCheck;
+    QPointer<TextEditor> m_pEditor;
+    QTextDocument *m_pCheckedDoc;
+    QTimer *m_pTimer;
+    QMetaObject::Connection m_contentsConnection;
+    QFutureWatcher<LiveSyntaxResult> m_watcher;
+    bool m_bEnabled;
+    bool m_bChanged;  // Document changed since check was started
+    // One entry per block of current document
+    QList<CachedSyntaxLine> m_listCache;
+};
+
+#endif  // APPLICATION_LIVESYNTAXCHECK_H_
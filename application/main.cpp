@@ -40,12 +40,18 @@
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QDebug>
+#include <QLoggingCategory>
 #include <QtGlobal>
 #include <QTime>
 #include <QTextStream>
 #include <QStandardPaths>
 
+#include "./batchrenderer.h"
+#include "./batchspellchecker.h"
 #include "./inyokaedit.h"
+#include "./parser/parsestatistics.h"
+#include "./renderserver.h"
+#include "./trace/trace.h"
 
 static QFile logfile;
 static QTextStream out(&logfile);
@@ -58,6 +64,16 @@ void LoggingHandler(QtMsgType type,
 // ----------------------------------------------------------------------------
 
 auto main(int argc, char *argv[]) -> int {
+  // Headless rendering does not need a display
+  for (int i = 1; i < argc; i++) {
+    if ((0 == qstrcmp(argv[i], "--render") ||
+         0 == qstrcmp(argv[i], "--spellcheck") ||
+         0 == qstrcmp(argv[i], "--serve")) &&
+        qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+      qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+  }
+
   QApplication app(argc, argv);
   app.setApplicationName(QStringLiteral(APP_NAME));
   app.setApplicationVersion(QStringLiteral(APP_VERSION));
@@ -76,6 +92,55 @@ auto main(int argc, char *argv[]) -> int {
   QCommandLineOption enableDebug(QStringLiteral("debug"),
                                  QStringLiteral("Enable debug mode"));
   cmdparser.addOption(enableDebug);
+  QCommandLineOption enableTrace(QStringLiteral("trace"),
+                                 QStringLiteral("Record trace events "
+                                                "(Tools > Export trace)"));
+  cmdparser.addOption(enableTrace);
+  QCommandLineOption cmdRender(QStringLiteral("render"),
+                               QString::fromLatin1(
+                                 "Render files / folders to HTML without "
+                                 "GUI (see --output, --jobs)"));
+  cmdparser.addOption(cmdRender);
+  QCommandLineOption cmdOutput(QStringList() << QStringLiteral("o") <<
+                               QStringLiteral("output"),
+                               QStringLiteral("Output folder for --render"),
+                               QStringLiteral("Path to folder"),
+                               QStringLiteral("."));
+  cmdparser.addOption(cmdOutput);
+  QCommandLineOption cmdSpellcheck(QStringLiteral("spellcheck"),
+                                   QString::fromLatin1(
+                                     "Spell check files / folders without "
+                                     "GUI (see --report, --jobs)"));
+  cmdparser.addOption(cmdSpellcheck);
+  QCommandLineOption cmdReport(QStringLiteral("report"),
+                               QString::fromLatin1(
+                                 "Report file for --spellcheck "
+                                 "(default: stdout)"),
+                               QStringLiteral("file"));
+  cmdparser.addOption(cmdReport);
+  QCommandLineOption cmdJobs(QStringList() << QStringLiteral("j") <<
+                             QStringLiteral("jobs"),
+                             QString::fromLatin1(
+                               "Number of threads for --render / "
+                               "--spellcheck / --serve (default: number "
+                               "of cores)"),
+                             QStringLiteral("n"), QStringLiteral("0"));
+  cmdparser.addOption(cmdJobs);
+  QCommandLineOption cmdWatch(QStringLiteral("watch"),
+                              QString::fromLatin1(
+                                "Keep running with --render and rebuild "
+                                "changed files"));
+  cmdparser.addOption(cmdWatch);
+  QCommandLineOption cmdServe(QStringLiteral("serve"),
+                              QString::fromLatin1(
+                                "Run without GUI and answer render / check "
+                                "requests on a local socket (see --socket)"));
+  cmdparser.addOption(cmdServe);
+  QCommandLineOption cmdSocket(QStringLiteral("socket"),
+                               QStringLiteral("Socket name for --serve"),
+                               QStringLiteral("name"),
+                               QStringLiteral("inyokaedit"));
+  cmdparser.addOption(cmdSocket);
   QCommandLineOption cmdShare(QStringList() << QStringLiteral("s") <<
                               QStringLiteral("share"),
                               QString::fromLatin1(
@@ -84,7 +149,9 @@ auto main(int argc, char *argv[]) -> int {
                               QStringLiteral("Path to folder"));
   cmdparser.addOption(cmdShare);
   cmdparser.addPositionalArgument(QStringLiteral("file"),
-                                  QStringLiteral("File to be opened"));
+                                  QStringLiteral("File to be opened (or "
+                                                 "files / folders to be "
+                                                 "rendered / checked)"));
   cmdparser.process(app);
 
   // User data directory
@@ -108,6 +175,47 @@ auto main(int argc, char *argv[]) -> int {
                  + app.applicationName().toLower();
   }
 
+  if (cmdparser.isSet(cmdRender)) {
+    // Messages to console instead of debug.log (used by running GUI)
+    if (!cmdparser.isSet(enableDebug)) {
+      QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+    }
+    BatchRenderer renderer(sSharePath, userDataDir);
+    const int nFailed = renderer.render(cmdparser.positionalArguments(),
+                                        cmdparser.value(cmdOutput),
+                                        cmdparser.value(cmdJobs).toInt());
+    if (cmdparser.isSet(cmdWatch)) {
+      renderer.watch(cmdparser.positionalArguments(),
+                     cmdparser.value(cmdOutput),
+                     cmdparser.value(cmdJobs).toInt());
+      return app.exec();
+    }
+    return 0 == nFailed ? 0 : 1;
+  }
+
+  if (cmdparser.isSet(cmdSpellcheck)) {
+    if (!cmdparser.isSet(enableDebug)) {
+      QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+    }
+    BatchSpellChecker spellchecker(sSharePath, userDataDir);
+    const int nFailed = spellchecker.check(cmdparser.positionalArguments(),
+                                           cmdparser.value(cmdReport),
+                                           cmdparser.value(cmdJobs).toInt());
+    return 0 == nFailed ? 0 : 1;
+  }
+
+  if (cmdparser.isSet(cmdServe)) {
+    if (!cmdparser.isSet(enableDebug)) {
+      QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+    }
+    RenderServer server(sSharePath, userDataDir);
+    if (!server.listen(cmdparser.value(cmdSocket),
+                       cmdparser.value(cmdJobs).toInt())) {
+      return 1;
+    }
+    return app.exec();
+  }
+
   const QString sDebugFile(QStringLiteral("debug.log"));
   if (!userDataDir.exists()) {
     // Create folder including possible parent directories (mkPATH)!
@@ -119,6 +227,9 @@ auto main(int argc, char *argv[]) -> int {
   } else if (cmdparser.isSet(enableDebug)) {  // -s overwrites debug path!
     qWarning() << "DEBUG is enabled!";
   }
+  // Log parse stage timings of each preview
+  ParseStatistics::setEnabled(cmdparser.isSet(enableDebug));
+  Trace::setEnabled(cmdparser.isSet(enableTrace));
 
   const QStringList sListArgs = cmdparser.positionalArguments();
   QString sArg(QLatin1String(""));
@@ -30,52 +30,28 @@
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
-#include <QMessageBox>
 #include <QRegularExpression>
 #include <QTextDocument>
 
+#include "./parsestatistics.h"
+
 Macros::Macros(const QString &sSharePath,
-               const QDir &tmpImgDir)
+               const QDir &tmpImgDir,
+               const QList<QPair<QString, QStringList>> &listDefinitions)
   : m_sSharePath(sSharePath),
     m_tmpImgDir(tmpImgDir) {
-  QFile fiMacros(QStringLiteral(":/macros.conf"));
-  if (!fiMacros.open(QIODevice::ReadOnly)) {
-    qWarning() << "Could not open macros.conf";
-    QMessageBox::warning(nullptr, QStringLiteral("Error"),
-                         QStringLiteral("Could not open macros.conf"));
-  } else {
-    QTextStream in(&fiMacros);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    // Since Qt 6 UTF-8 is used by default
-    in.setCodec("UTF-8");
-#endif
-    QString tmpLine;
-    QStringList tmpList;
-    MACRO tmpMacro;
-
-    while (!in.atEnd()) {
-      tmpLine = in.readLine().trimmed();
-      if (!tmpLine.startsWith(QLatin1String("Code")) &&
-          !tmpLine.trimmed().isEmpty()) {
-        tmpList = tmpLine.split(QStringLiteral("="));
-        if (2 == tmpList.size()) {
-          tmpMacro.name = tmpList[0].trimmed();
-          tmpMacro.translations.clear();
-          const QStringList tmpList2(tmpList[1].split(QStringLiteral(",")));
-          if ("Template" != tmpMacro.name) {
-            for (const auto &s : tmpList2) {
-              tmpMacro.translations << s.trimmed();
-            }
-            m_listMacros << tmpMacro;
-          } else {
-            for (const auto &s : tmpList2) {
-              m_sListTplTranslations << s.trimmed();
-            }
-          }
-        }
-      }
+  MACRO tmpMacro;
+  for (const auto &definition : listDefinitions) {
+    if ("Code" == definition.first) {
+      continue;
+    }
+    if ("Template" != definition.first) {
+      tmpMacro.name = definition.first;
+      tmpMacro.translations = definition.second;
+      m_listMacros << tmpMacro;
+    } else {
+      m_sListTplTranslations << definition.second;
     }
-    fiMacros.close();
   }
 }
 
@@ -116,6 +92,17 @@ auto Macros::getTplTranslations() const -> QStringList {
   return m_sListTplTranslations;
 }
 
+// ----------------------------------------------------------------------------
+
+auto Macros::getPictureTranslations() const -> QStringList {
+  for (const auto &macro : qAsConst(m_listMacros)) {
+    if ("Picture" == macro.name) {
+      return macro.translations;
+    }
+  }
+  return QStringList();
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
@@ -128,6 +115,7 @@ void Macros::replaceAnchors(QTextDocument *pRawDoc, const QString &sTrans) {
   QString sAnchor;
 
   while ((match = regex.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     sAnchor = match.captured();
     nIndex = match.capturedStart();
     // qDebug() << sAnchor;
@@ -170,6 +158,7 @@ void Macros::replaceAttachments(QTextDocument *pRawDoc, const QString &sTrans) {
   QString sMacro;
 
   while ((match = findMacro.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     sMacro = match.captured(0);
     nIndex = match.capturedStart();
     sMacro.remove("[[" + sTrans + "(", Qt::CaseInsensitive);
@@ -204,6 +193,7 @@ void Macros::replaceDates(QTextDocument *pRawDoc, const QString &sTrans) {
   bool bConversionOk;
 
   while ((match = findMacro.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     sMacro = match.captured(0);
     nIndex = match.capturedStart();
     sMacro.remove("[[" + sTrans + "(", Qt::CaseInsensitive);
@@ -270,6 +260,7 @@ void Macros::replacePictures(QTextDocument *pRawDoc,
   int nIndex = 0;
   QRegularExpressionMatch match;
   while ((match = findImages.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
     QString sTmpImage = match.captured();
     sTmpImage.remove("[[" + sTrans + "(", Qt::CaseInsensitive);
@@ -396,6 +387,7 @@ void Macros::replaceTableOfContents(QTextDocument *pRawDoc,
   int nIndex = 0;
   QRegularExpressionMatch match;
   while ((match = findMacro.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
     sMacro = match.captured(0);
     sMacro.remove("[[" + sTrans + "(", Qt::CaseInsensitive);
@@ -454,6 +446,7 @@ void Macros::replaceSpan(QTextDocument *pRawDoc, const QString &sTrans) {
   int nIndex = 0;
   QRegularExpressionMatch match;
   while ((match = findMacro.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
     sMacro = match.captured(0);
     sMacro.remove("[[" + sTrans + "(", Qt::CaseInsensitive);
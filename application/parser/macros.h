@@ -28,6 +28,8 @@
 #define APPLICATION_PARSER_MACROS_H_
 
 #include <QDir>
+#include <QList>
+#include <QPair>
 #include <QString>
 #include <QStringList>
 
@@ -40,12 +42,14 @@ struct MACRO {
 
 class Macros {
  public:
-    Macros(const QString &sSharePath, const QDir &tmpImgDir);
+    Macros(const QString &sSharePath, const QDir &tmpImgDir,
+           const QList<QPair<QString, QStringList>> &listDefinitions);
     void startParsing(QTextDocument *pRawDoc,
                       const QString &sCurrentFile,
                       const QString &sCommunity,
                       QStringList &sListHeadlines);
     auto getTplTranslations() const -> QStringList;
+    auto getPictureTranslations() const -> QStringList;
 
  private:
     static void replaceAnchors(QTextDocument *pRawDoc, const QString &sTrans);
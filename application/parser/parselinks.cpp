@@ -30,6 +30,8 @@
 #include <QTextDocument>
 
 #include "./parselinks.h"
+#include "./parsestatistics.h"
+#include "../trace/trace.h"
 #include "../utils.h"
 
 ParseLinks::ParseLinks(const QString &sUrlToWiki,
@@ -82,6 +84,7 @@ void ParseLinks::replaceUrls(QTextDocument *pRawDoc) {
   QString sLink;
 
   while ((match = findUrl.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
     sLink = match.captured();
 
@@ -118,6 +121,7 @@ void ParseLinks::replaceHyperlinks(QTextDocument *pRawDoc) {
   int nSpace;
 
   while ((match = findHyperlink.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
 
     // Found end of link
@@ -167,9 +171,11 @@ void ParseLinks::replaceInyokaWikiLinks(QTextDocument *pRawDoc) {
   int nLength;
   QString sLink;
   QString sLinkURL;
-  bool bIsOnline(Utils::getOnlineState());
+  // Online check is a network request, only needed for link check
+  bool bIsOnline(m_bCheckLinks && Utils::getOnlineState());
 
   while ((match = findInyokaWikiLink.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
 
     // Found end of link
@@ -198,9 +204,11 @@ void ParseLinks::replaceInyokaWikiLinks(QTextDocument *pRawDoc) {
 
           m_sLinkClassAddition = QLatin1String("");
           if (bIsOnline && m_bCheckLinks) {
+            ParseStatistics::count(ParseStatistics::NETWORKCHECKS);
             m_NWreply = m_NWAManager->get(
                           QNetworkRequest(
                             QUrl(sLinkURL + "/a/export/meta/")));
+            Trace::asyncReply(m_NWreply, "network", "Check link");
             QEventLoop loop;  // Workaround getting synchron reply
             connect(m_NWreply, &QNetworkReply::finished,
                     &loop, &QEventLoop::quit);
@@ -223,9 +231,11 @@ void ParseLinks::replaceInyokaWikiLinks(QTextDocument *pRawDoc) {
           sLinkURL = m_sWikiUrl + "/"
                      + sLink.mid(0, sLink.indexOf(QLatin1String(":")));
           if (bIsOnline && m_bCheckLinks) {
+            ParseStatistics::count(ParseStatistics::NETWORKCHECKS);
             m_NWreply = m_NWAManager->get(
                           QNetworkRequest(
                             QUrl(sLinkURL + "/a/export/meta/")));
+            Trace::asyncReply(m_NWreply, "network", "Check link");
             QEventLoop loop;
             connect(m_NWreply, &QNetworkReply::finished,
                     &loop, &QEventLoop::quit);
@@ -283,6 +293,7 @@ void ParseLinks::replaceInterwikiLinks(QTextDocument *pRawDoc) {
   QRegularExpression findInterwikiLink(sPattern);
   // qDebug() << sPattern;
   while ((match = findInterwikiLink.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
 
     // Found end of link
@@ -363,6 +374,7 @@ void ParseLinks::replaceAnchorLinks(QTextDocument *pRawDoc) {
   int nSplit;
 
   while ((match = findAnchorLink.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
 
     // Found end of link
@@ -412,6 +424,7 @@ void ParseLinks::replaceKnowledgeBoxLinks(QTextDocument *pRawDoc) {
   QString sLink;
 
   while ((match = findKnowledgeBoxLink.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
     sLink = match.captured();
     // qDebug() << sLink;
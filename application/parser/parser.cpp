@@ -24,11 +24,13 @@
  * Parse plain text with inyoka syntax into html code.
  */
 
+#include <QCoreApplication>
 #include <QMessageBox>
 #include <QProcess>
 #include <QRegularExpression>
 #include <QTextBlock>
 #include <QTextDocument>
+#include <QThread>
 
 #include "./macros.h"
 #include "./parser.h"
@@ -37,12 +39,14 @@
 #endif
 #include "./parselinks.h"
 #include "./parselist.h"
+#include "./parsestatistics.h"
 #include "./parsetable.h"
 #include "./parsetemplates.h"
 #include "./parsetextformats.h"
 #include "./parsetxtmap.h"
 #include "../syntaxcheck.h"
 #include "../templates/templates.h"
+#include "../trace/trace.h"
 
 Parser::Parser(const QString &sSharePath,
                const QDir &tmpImgDir,
@@ -59,9 +63,14 @@ Parser::Parser(const QString &sSharePath,
     m_pTemplates(pTemplates),
     m_sCommunity(sCommunity),
     m_sPygmentize(sPygmentize),
-    m_nTimedPreview(0) {
+    m_nTimedPreview(0),
+    m_bMeasureStages(false),
+    m_bMeasuring(false),
+    m_bPygmentizeChecked(false),
+    m_bPygmentize(false) {
   Q_UNUSED(pParent)
-  m_pMacros = new Macros(m_sSharePath, m_tmpImgDir);
+  m_pMacros = new Macros(m_sSharePath, m_tmpImgDir,
+                         m_pTemplates->getMacroDefinitions());
 
   m_pTemplateParser = new ParseTemplates(
                         m_pMacros->getTplTranslations(),
@@ -81,6 +90,8 @@ Parser::Parser(const QString &sSharePath,
 }
 
 Parser::~Parser() {
+  delete m_pRawText;
+  m_pRawText = nullptr;
   if (nullptr != m_pLinkParser) {
     delete m_pLinkParser;
     m_pLinkParser = nullptr;
@@ -105,37 +116,87 @@ void Parser::updateSettings(const QString &sInyokaUrl, const bool bCheckLinks,
 // ----------------------------------------------------------------------------
 
 auto Parser::genOutput(const QString &sActFile,
-                       QTextDocument *pRawDocument,
-                       const bool bSyntaxCheck) -> QString {
+                       QTextDocument *pRawDocument) -> QString {
+  const ParsedBody body(this->genBody(sActFile, pRawDocument));
+  const QString sHtml(this->wrapBody(sActFile, body));
+  this->finishStage("Output");
+  return sHtml;
+}
+
+// ----------------------------------------------------------------------------
+
+auto Parser::genBody(const QString &sActFile,
+                     QTextDocument *pRawDocument) -> ParsedBody {
   qDebug() << "Parsing...";
+  TraceSpan span("parser", "genBody");
+  m_bMeasuring = m_bMeasureStages || ParseStatistics::isEnabled() ||
+                 Trace::isEnabled();
+  if (m_bMeasuring) {
+    ParseStatistics::resetCounters();
+    m_listStageTimings.clear();
+    m_stageTimer.start();
+  }
+
   // Need a copy otherwise text in editor will be changed
+  delete m_pRawText;
   m_pRawText = pRawDocument->clone();
   m_sCurrentFile = sActFile;
   Parser::removeComments(m_pRawText);
+  this->finishStage("Comments");
+
+  this->parseRawText(true);
+
+  ParsedBody body;
+  body.sTags = this->generateTags(m_pRawText);
+  body.sContent = m_pRawText->toPlainText();
+  return body;
+}
+
+// ----------------------------------------------------------------------------
+
+auto Parser::genFragment(const QString &sFragment, const bool bWithStyle,
+                         const bool bParagraphs) -> QString {
+  TraceSpan span("parser", "genFragment");
+  m_bMeasuring = false;  // Keep stage timings of last complete page
+
+  delete m_pRawText;
+  m_pRawText = new QTextDocument(sFragment);
+  m_sCurrentFile.clear();
+  Parser::removeComments(m_pRawText);
+  this->parseRawText(bParagraphs);
 
-  if (bSyntaxCheck) {
-    QPair<int, QString> ret = SyntaxCheck::checkInyokaSyntax(
-          m_pRawText,
-          m_pTemplates->getListTplNamesINY(),
-          m_pTemplates->getListSmilies(),
-          m_pMacros->getTplTranslations());
-    emit this->hightlightSyntaxError(ret);
+  if (!bWithStyle) {
+    return m_pRawText->toPlainText();
   }
+  QString sHtml(this->getFragmentShell());
+  return sHtml.replace(QLatin1String("%content%"), m_pRawText->toPlainText());
+}
+
+// ----------------------------------------------------------------------------
 
+// Stages shared by complete page and fragment
+void Parser::parseRawText(const bool bParagraphs) {
   m_sListNoTranslate.clear();
   this->filterEscapedChars(m_pRawText);  // Before everything
   this->filterNoTranslate(m_pRawText);   // Before replaceCodeblocks()
   this->replaceCodeblocks(m_pRawText);
+  this->finishStage("Codeblocks");
 
   m_pTemplateParser->startParsing(m_pRawText, m_sCurrentFile);
+  this->finishStage("Templates");
 
   QStringList sListHeadlines;
   sListHeadlines = Parser::replaceHeadlines(m_pRawText);  // Returns TOC list
+  this->finishStage("Headlines");
   ParseTable::startParsing(m_pRawText);
+  this->finishStage("Tables");
   m_pMacros->startParsing(m_pRawText, m_sCurrentFile,
                           m_sCommunity, sListHeadlines);
+  this->finishStage("Macros");
   ParseList::startParsing(m_pRawText);
+  this->finishStage("Lists");
   m_pLinkParser->startParsing(m_pRawText);
+  this->finishStage("Links");
 
   Parser::replaceHorLines(m_pRawText);  // Before smilies, because of -- smiley
 
@@ -144,6 +205,7 @@ auto Parser::genOutput(const QString &sActFile,
                                  m_pTemplates->getListFormatEnd(),
                                  m_pTemplates->getListFormatHtmlStart(),
                                  m_pTemplates->getListFormatHtmlEnd());
+  this->finishStage("Textformats");
 
   // Replace smilies
   ParseTxtMap::startParsing(m_pRawText,
@@ -162,19 +224,58 @@ auto Parser::genOutput(const QString &sActFile,
                             m_sSharePath,
                             m_sCommunity);
 #endif
+  this->finishStage("Maps");
 
   Parser::replaceQuotes(m_pRawText);
-  Parser::generateParagraphs(m_pRawText);
+  if (bParagraphs) {
+    Parser::generateParagraphs(m_pRawText);
+    this->finishStage("Paragraphs");
+  }
   Parser::replaceFootnotes(m_pRawText);
+  this->finishStage("Footnotes");
 
   this->reinstertNoTranslate(m_pRawText);
+}
 
+// ----------------------------------------------------------------------------
+
+// Preview template without page title, meta data and tags (built once)
+auto Parser::getFragmentShell() -> QString {
+  if (m_sFragmentShell.isEmpty()) {
+    const QRegularExpression::PatternOptions options(
+          QRegularExpression::DotMatchesEverythingOption |
+          QRegularExpression::InvertedGreedinessOption);
+    QString sShell(m_pTemplates->getPreviewTemplate());
+    sShell.remove(QRegularExpression(
+                    QStringLiteral("<h1 class=\"pagetitle\">.*</h1>"),
+                    options));
+    sShell.remove(QRegularExpression(
+                    QStringLiteral("<p class=\"meta\">.*</p>"), options));
+    sShell.replace(QLatin1String("%folder%"),
+                   m_sSharePath + "/community/" + m_sCommunity + "/web");
+    sShell.remove(QStringLiteral("%filename%"));
+    sShell.remove(QStringLiteral("%date%"));
+    sShell.remove(QStringLiteral("%time%"));
+    sShell.remove(QStringLiteral("%tags%"));
+    sShell.remove(QStringLiteral("%refresh%"));
+    sShell.replace(QLatin1String("</style>"),
+                   QLatin1String("#page table{margin:0px;}</style>"));
+    m_sFragmentShell = sShell;
+  }
+  return m_sFragmentShell;
+}
+
+// ----------------------------------------------------------------------------
+
+// Outer layer: Only volatile data (date, time), body stays cacheable
+auto Parser::wrapBody(const QString &sActFile,
+                      const ParsedBody &body) const -> QString {
   // File name
   QString sFilename;
-  if (m_sCurrentFile.isEmpty()) {
+  if (sActFile.isEmpty()) {
     sFilename = QStringLiteral("Untitled");
   } else {
-    QFileInfo fi(m_sCurrentFile);
+    QFileInfo fi(sActFile);
     sFilename = fi.baseName();
     sFilename.replace(QLatin1String("_"), QLatin1String(" "));
   }
@@ -194,10 +295,9 @@ auto Parser::genOutput(const QString &sActFile,
                     QLatin1String("%time%"),
                     QTime::currentTime().toString(
           QStringLiteral("hh:mm")));
-  sTemplateCopy = sTemplateCopy.replace(QLatin1String("%tags%"),
-                                        this->generateTags(m_pRawText));
+  sTemplateCopy = sTemplateCopy.replace(QLatin1String("%tags%"), body.sTags);
   sTemplateCopy = sTemplateCopy.replace(QLatin1String("%content%"),
-                                        m_pRawText->toPlainText());
+                                        body.sContent);
   QString sRefresh(QLatin1String(""));
   if (m_nTimedPreview > 0) {
     sRefresh = "<meta http-equiv=\"refresh\" content=\"" +
@@ -207,6 +307,59 @@ auto Parser::genOutput(const QString &sActFile,
   return sTemplateCopy;
 }
 
+// ----------------------------------------------------------------------------
+
+auto Parser::checkSyntax(
+    const QTextDocument *pRawDocument) const -> QList<SyntaxError> {
+  TraceSpan span("parser", "checkSyntax");
+  return this->getSyntaxCheck().check(pRawDocument->toPlainText());
+}
+
+// ----------------------------------------------------------------------------
+
+auto Parser::getSyntaxCheck() const -> SyntaxCheck {
+  return SyntaxCheck(m_pTemplates->getListTplNamesINY(),
+                     m_pTemplates->getListSmilies(),
+                     m_pMacros->getTplTranslations());
+}
+
+// ----------------------------------------------------------------------------
+
+auto Parser::getTplTranslations() const -> QStringList {
+  return m_pMacros->getTplTranslations();
+}
+
+auto Parser::getPictureTranslations() const -> QStringList {
+  return m_pMacros->getPictureTranslations();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void Parser::setMeasureStages(const bool bMeasure) {
+  m_bMeasureStages = bMeasure;
+  m_listStageTimings.clear();
+}
+
+auto Parser::getStageTimings() const -> QList<QPair<QString, qint64>> {
+  return m_listStageTimings;
+}
+
+auto Parser::getUsedTemplates() const -> QStringList {
+  return m_pTemplateParser->getUsedTemplates();
+}
+
+void Parser::finishStage(const char *sStage) {
+  if (m_bMeasuring) {
+    const qint64 nElapsed = m_stageTimer.nsecsElapsed();
+    m_listStageTimings << qMakePair(QString::fromLatin1(sStage), nElapsed);
+    if (Trace::isEnabled()) {
+      Trace::complete("parser", sStage, Trace::now() - nElapsed, nElapsed);
+    }
+    m_stageTimer.restart();
+  }
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 /*
@@ -234,6 +387,7 @@ void Parser::replaceTemplates(QTextDocument *pRawDoc) {
     findTemplate.setPattern(sRegExp);
 
     while ((match = findTemplate.match(sDoc, nIndex)).hasMatch()) {
+      ParseStatistics::count(ParseStatistics::REGEXMATCHES);
       nIndex = match.capturedStart();
       sMacro = match.captured(0);
       // qDebug() << "CAPTURED:" << sMacro;
@@ -317,6 +471,7 @@ void Parser::replaceCodeblocks(QTextDocument *pRawDoc) {
     QRegularExpressionMatch match;
 
     while ((match = findTemplate.match(sDoc, nIndex)).hasMatch()) {
+      ParseStatistics::count(ParseStatistics::REGEXMATCHES);
       nIndex = match.capturedStart();
       bool bFormated = false;
       QString sMacro = match.captured(0);
@@ -405,36 +560,35 @@ void Parser::replaceCodeblocks(QTextDocument *pRawDoc) {
 
 auto Parser::highlightCode(const QString &sLanguage,
                            const QString &sCode) -> QString {
-  static bool bChecked(false);
-  static bool bPygmentize(false);
-  static QFile sPygmentize(m_sPygmentize);
-  if (!bChecked) {
-    bChecked = true;
+  // Checked per parser instance (parsers may run in parallel threads)
+  const QFile sPygmentize(m_sPygmentize);
+  if (!m_bPygmentizeChecked) {
+    m_bPygmentizeChecked = true;
     if (sPygmentize.exists()) {
-      bPygmentize = true;
+      m_bPygmentize = true;
       qDebug() << "Pygmentize found:" << sPygmentize.fileName();
     } else {
       qDebug() << "Pygmentize NOT found:" << sPygmentize.fileName();
     }
   }
 
-  if (bPygmentize) {
+  if (m_bPygmentize) {
     QProcess procPygmentize;
     QProcess procEcho;
+    ParseStatistics::count(ParseStatistics::PROCESSES, 2);
+    TraceSpan span("process", "pygmentize");
 
     // Workaround for passing stdin string with code to pygmentize
     procEcho.setStandardOutputProcess(&procPygmentize);
     procEcho.start(QStringLiteral("echo"), QStringList() << sCode);
     if (!procEcho.waitForStarted()) {
-      QMessageBox::critical(nullptr, QStringLiteral("Pygments error"),
-                            QStringLiteral("Could not start echo."));
+      Parser::showPygmentsError(QStringLiteral("Could not start echo."));
       qCritical() << "Pygments error: Could not start echo.";
       procEcho.kill();
       return sCode;
     }
     if (!procEcho.waitForFinished()) {
-      QMessageBox::critical(nullptr, QStringLiteral("Pygments error"),
-                            QStringLiteral("Error while using echo."));
+      Parser::showPygmentsError(QStringLiteral("Error while using echo."));
       qCritical() << "Pygments error: While using echo.";
       procEcho.kill();
       return sCode;
@@ -447,15 +601,14 @@ auto Parser::highlightCode(const QString &sLanguage,
                          QStringLiteral("-O") << QStringLiteral("noclasses"));
 
     if (!procPygmentize.waitForStarted()) {
-      QMessageBox::critical(nullptr, QStringLiteral("Pygments error"),
-                            QStringLiteral("Could not start pygmentize."));
+      Parser::showPygmentsError(QStringLiteral("Could not start pygmentize."));
       qCritical() << "Error while starting pygmentize - waitForStarted";
       procPygmentize.kill();
       return sCode;
     }
     if (!procPygmentize.waitForFinished()) {
-      QMessageBox::critical(nullptr, QStringLiteral("Pygments error"),
-                            QStringLiteral("Error while using pygmentize."));
+      Parser::showPygmentsError(
+            QStringLiteral("Error while using pygmentize."));
       qCritical() << "Error while executing pygmentize - waitForFinished";
       procPygmentize.kill();
       return sCode;
@@ -467,6 +620,16 @@ auto Parser::highlightCode(const QString &sLanguage,
   return sCode;
 }
 
+// ----------------------------------------------------------------------------
+
+void Parser::showPygmentsError(const QString &sMessage) {
+  // No message box if rendering headless in worker threads
+  if (QThread::currentThread() == QCoreApplication::instance()->thread()) {
+    QMessageBox::critical(nullptr, QStringLiteral("Pygments error"),
+                          sMessage);
+  }
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
@@ -480,6 +643,7 @@ void Parser::filterEscapedChars(QTextDocument *pRawDoc) {
   unsigned int nNoTranslate;
 
   while ((match = pattern.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
     sEscChar = match.captured(0);
     if ("\\\\" != sEscChar) {
@@ -534,6 +698,7 @@ void Parser::filterNoTranslate(QTextDocument *pRawDoc) {
     QRegularExpressionMatch match;
 
     while ((match = patternFormat.match(sDoc, nIndex)).hasMatch()) {
+      ParseStatistics::count(ParseStatistics::REGEXMATCHES);
       nIndex = match.capturedStart();
       QString sFormatedText = match.captured();
       m_sListNoTranslate << sFormatedText;
@@ -588,7 +753,6 @@ void Parser::replaceHorLines(QTextDocument *pRawDoc) {
 
 auto Parser::generateTags(QTextDocument *pRawDoc) -> QString {
   QString sDoc(pRawDoc->toPlainText());
-  QString sLine;
   QString sTags(QLatin1String(""));
   QStringList sListTags;
 
@@ -596,22 +760,12 @@ auto Parser::generateTags(QTextDocument *pRawDoc) -> QString {
   for (QTextBlock block = pRawDoc->firstBlock();
        block.isValid() && !(pRawDoc->lastBlock() < block);
        block = block.next()) {
-    if (block.text().trimmed().startsWith(QLatin1String("#tag:")) ||
-        block.text().trimmed().startsWith(QLatin1String("# tag:"))) {
-      sLine = block.text();
-      sTags = block.text().trimmed();
-      sTags.remove(QStringLiteral("#tag:"));
-      sTags.remove(QStringLiteral("# tag:"));
-      sTags = sTags.trimmed();
-      QStringList sListElements = sTags.split(QStringLiteral(","));
-      sListTags << sListElements;
-      sDoc.replace(sLine, QLatin1String(""));
+    if (Parser::parseTags(block.text(), &sListTags)) {
+      sDoc.replace(block.text(), QLatin1String(""));
     }
   }
 
-  sTags.clear();
   for (int i = 0; i < sListTags.size(); i++) {
-    sListTags[i].remove(QStringLiteral(" "));
     sTags += " <a href=\"" + m_sInyokaUrl + "/Wiki/Tags?tag="
              + sListTags[i] + "\">" + sListTags[i] + "</a>";
     if (i < sListTags.size() - 1) {
@@ -623,6 +777,24 @@ auto Parser::generateTags(QTextDocument *pRawDoc) -> QString {
   return sTags;
 }
 
+// ----------------------------------------------------------------------------
+
+// Appends tags of a "#tag:" line (without spaces), false for other lines
+auto Parser::parseTags(const QString &sLine, QStringList *pListTags) -> bool {
+  QString sTags(sLine.trimmed());
+  if (!sTags.startsWith(QLatin1String("#tag:")) &&
+      !sTags.startsWith(QLatin1String("# tag:"))) {
+    return false;
+  }
+  sTags.remove(QStringLiteral("#tag:"));
+  sTags.remove(QStringLiteral("# tag:"));
+  const QStringList sListElements(sTags.trimmed().split(QStringLiteral(",")));
+  for (auto sTag : sListElements) {
+    *pListTags << sTag.remove(QStringLiteral(" "));
+  }
+  return true;
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
@@ -637,6 +809,7 @@ void Parser::replaceFlags(QTextDocument *pRawDoc) {
   QRegularExpressionMatch match;
 
   while ((match = findFlag.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
     sHtml.clear();
     sCountry = match.captured(1);
@@ -730,10 +903,8 @@ void Parser::removeComments(QTextDocument *pRawDoc) {
 // ----------------------------------------------------------------------------
 
 auto Parser::replaceHeadlines(QTextDocument *pRawDoc) -> QStringList {
-  static const quint8 MAXHEAD = 5;
   QString sDoc(QLatin1String(""));
   QString sLine;
-  QString sTmp(QLatin1String(""));
   QString sLink(QLatin1String(""));
   quint8 nHeadlineLevel;
   QStringList slistHeadlines;
@@ -742,66 +913,22 @@ auto Parser::replaceHeadlines(QTextDocument *pRawDoc) -> QStringList {
   for (QTextBlock block = pRawDoc->firstBlock();
        block.isValid() && !(pRawDoc->lastBlock() < block);
        block = block.next()) {
-    // Order is important! First level 5, 4, 3, 2, 1
-    for (int i = MAXHEAD; i >= 0; i--) {
-      sLine = block.text();
-      sTmp.fill('=', i);
-      if (0 == i) {
-        sDoc += sLine + "\n";
-        break;
-      }
-      if (sLine.trimmed().startsWith(sTmp) &&
-          sLine.trimmed().endsWith(sTmp) &&
-          sLine.trimmed().length() > (i*2)) {
-        nHeadlineLevel = static_cast<quint8>(i);
-      } else {
-        continue;
-      }
-
-      // Remove first and last "="
-      sLine.remove(0, sLine.indexOf(sTmp) + sTmp.length());
-      sLine.remove(sLine.lastIndexOf(sTmp), sLine.length());
-      sLine = sLine.trimmed();
-
-      switch (nHeadlineLevel) {
-        case 1:
-          sTmp = "##1##" + sLine;
-          break;
-        case 2:
-          sTmp = "##2##" + sLine;
-          break;
-        case 3:
-          sTmp = "##3##" + sLine;
-          break;
-        case 4:
-          sTmp = "##4##" + sLine;
-          break;
-        case 5:
-          sTmp = "##5##" + sLine;
-          break;
-        default:
-          qWarning() << "Found strange formated headline:" << sLine;
-      }
-      slistHeadlines << sTmp;  // Used for table of contents
-
-      // Replace characters for valid link
-      sLink = sLine;
-      sLink.replace(QLatin1String(" "), QLatin1String("-"));
-      sLink.replace(QStringLiteral("Ä"), QLatin1String("Ae"));
-      sLink.replace(QStringLiteral("Ü"), QLatin1String("Ue"));
-      sLink.replace(QStringLiteral("Ö"), QLatin1String("Oe"));
-      sLink.replace(QStringLiteral("ä"), QLatin1String("ae"));
-      sLink.replace(QStringLiteral("ü"), QLatin1String("ue"));
-      sLink.replace(QStringLiteral("ö"), QLatin1String("oe"));
-
-      // HeadlineLevel + 1 !
-      sLine = "<h" + QString::number(nHeadlineLevel+1) + " id=\"" +
-              sLink + "\">" + sLine + " <a href=\"#" + sLink +
-              "\" class=\"headerlink\"> &para;</a></h" +
-              QString::number(nHeadlineLevel+1) + ">\n";
-      sDoc += sLine;
-      break;
+    sLine = block.text();
+    if (!Parser::parseHeadline(sLine, &nHeadlineLevel, &sLine)) {
+      sDoc += sLine + "\n";
+      continue;
     }
+
+    // Used for table of contents
+    slistHeadlines << "##" + QString::number(nHeadlineLevel) + "##" + sLine;
+    sLink = Parser::getHeadlineAnchor(sLine);
+
+    // HeadlineLevel + 1 !
+    sLine = "<h" + QString::number(nHeadlineLevel+1) + " id=\"" +
+            sLink + "\">" + sLine + " <a href=\"#" + sLink +
+            "\" class=\"headerlink\"> &para;</a></h" +
+            QString::number(nHeadlineLevel+1) + ">\n";
+    sDoc += sLine;
   }
   // qDebug() << "HEADLINES:" << slistHeadlines;
 
@@ -809,6 +936,48 @@ auto Parser::replaceHeadlines(QTextDocument *pRawDoc) -> QStringList {
   return slistHeadlines;
 }
 
+// ----------------------------------------------------------------------------
+
+// Level (1 - 5) and text of "= Headline =" lines, false for other lines
+auto Parser::parseHeadline(const QString &sLine, quint8 *pLevel,
+                           QString *pHeadline) -> bool {
+  static const quint8 MAXHEAD = 5;
+  const QString sTrimmed(sLine.trimmed());
+
+  // Order is important! First level 5, 4, 3, 2, 1
+  for (int i = MAXHEAD; i > 0; i--) {
+    const QString sTmp(i, '=');
+    if (!sTrimmed.startsWith(sTmp) || !sTrimmed.endsWith(sTmp) ||
+        sTrimmed.length() <= (i*2)) {
+      continue;
+    }
+
+    // Remove first and last "="
+    QString sHeadline(sLine);
+    sHeadline.remove(0, sHeadline.indexOf(sTmp) + sTmp.length());
+    sHeadline.remove(sHeadline.lastIndexOf(sTmp), sHeadline.length());
+    *pLevel = static_cast<quint8>(i);
+    *pHeadline = sHeadline.trimmed();
+    return true;
+  }
+  return false;
+}
+
+// ----------------------------------------------------------------------------
+
+// Replace characters for valid link
+auto Parser::getHeadlineAnchor(const QString &sHeadline) -> QString {
+  QString sLink(sHeadline);
+  sLink.replace(QLatin1String(" "), QLatin1String("-"));
+  sLink.replace(QStringLiteral("Ä"), QLatin1String("Ae"));
+  sLink.replace(QStringLiteral("Ü"), QLatin1String("Ue"));
+  sLink.replace(QStringLiteral("Ö"), QLatin1String("Oe"));
+  sLink.replace(QStringLiteral("ä"), QLatin1String("ae"));
+  sLink.replace(QStringLiteral("ü"), QLatin1String("ue"));
+  sLink.replace(QStringLiteral("ö"), QLatin1String("oe"));
+  return sLink;
+}
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
@@ -827,6 +996,7 @@ void Parser::replaceFootnotes(QTextDocument *pRawDoc) {
   QRegularExpressionMatch match;
 
   while ((match = findMacro.match(sDoc, nIndex)).hasMatch()) {
+    ParseStatistics::count(ParseStatistics::REGEXMATCHES);
     nIndex = match.capturedStart();
     nCount++;
 
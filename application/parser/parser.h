@@ -28,9 +28,14 @@
 #define APPLICATION_PARSER_PARSER_H_
 
 #include <QDir>
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
 #include <QString>
 #include <QStringList>
 
+#include "../syntaxcheck.h"
+
 class QTextDocument;
 
 class Macros;
@@ -38,6 +43,15 @@ class ParseLinks;
 class ParseTemplates;
 class Templates;
 
+/**
+ * \struct ParsedBody
+ * \brief Parsed article without volatile parts (date, time) of template
+ */
+struct ParsedBody {
+  QString sContent;
+  QString sTags;
+};
+
 /**
  * \class Parser
  * \brief Main parser module.
@@ -53,19 +67,48 @@ class Parser : public QObject {
     ~Parser();
 
     // Starts generating HTML-code
-    QString genOutput(const QString &sActFile, QTextDocument *pRawDocument,
-                      const bool bSyntaxCheck = false);
+    QString genOutput(const QString &sActFile, QTextDocument *pRawDocument);
+    // genOutput() in two steps: Parsing (cacheable) and preview template
+    auto genBody(const QString &sActFile,
+                 QTextDocument *pRawDocument) -> ParsedBody;
+    auto wrapBody(const QString &sActFile,
+                  const ParsedBody &body) const -> QString;
+    // Snippet as body HTML only (no page template and tags);
+    // bWithStyle: Stylesheet shell of preview template around snippet,
+    // bParagraphs: Text blocks as paragraphs like in a complete article
+    auto genFragment(const QString &sFragment, const bool bWithStyle,
+                     const bool bParagraphs) -> QString;
+    // Syntax check only (all errors, sorted by position)
+    auto checkSyntax(
+        const QTextDocument *pRawDocument) const -> QList<SyntaxError>;
+    // Checker with community templates, e.g. for background check of editor
+    auto getSyntaxCheck() const -> SyntaxCheck;
+    // Localized macro names, e.g. for ArticleScanner (library index)
+    auto getTplTranslations() const -> QStringList;
+    auto getPictureTranslations() const -> QStringList;
+    // Duration of each parsing stage (nsecs) of last genOutput() call;
+    // always measured if ParseStatistics are enabled
+    void setMeasureStages(const bool bMeasure);
+    auto getStageTimings() const -> QList<QPair<QString, qint64>>;
+    // Templates used by last genOutput() call (dependencies for build cache)
+    auto getUsedTemplates() const -> QStringList;
+
+    // Same line syntax as used by replaceHeadlines() and generateTags()
+    static auto parseHeadline(const QString &sLine, quint8 *pLevel,
+                              QString *pHeadline) -> bool;
+    static auto getHeadlineAnchor(const QString &sHeadline) -> QString;
+    static auto parseTags(const QString &sLine,
+                          QStringList *pListTags) -> bool;
 
  public slots:
     void updateSettings(const QString &sInyokaUrl, const bool bCheckLinks,
                         const quint32 nTimedPreview);
 
- signals:
-    void hightlightSyntaxError(const QPair<int, QString>);
-
  private:
     // void replaceTemplates(QTextDocument *pRawDoc);
 
+    void parseRawText(const bool bParagraphs);
+    auto getFragmentShell() -> QString;
     void filterEscapedChars(QTextDocument *pRawDoc);
     void filterNoTranslate(QTextDocument *pRawDoc);
     void replaceCodeblocks(QTextDocument *pRawDoc);
@@ -84,6 +127,8 @@ class Parser : public QObject {
     auto generateTags(QTextDocument *pRawDoc) -> QString;
     auto highlightCode(const QString &sLanguage,
                        const QString &sCode) -> QString;
+    static void showPygmentsError(const QString &sMessage);
+    void finishStage(const char *sStage);
 
     // Text from editor
     QTextDocument *m_pRawText;
@@ -97,11 +142,19 @@ class Parser : public QObject {
     const QDir m_tmpImgDir;
     QString m_sInyokaUrl;
     QString m_sCurrentFile;
+    QString m_sFragmentShell;
     Templates *m_pTemplates;
     Macros *m_pMacros;
     const QString m_sCommunity;
     const QString m_sPygmentize;
     quint32 m_nTimedPreview;
+
+    bool m_bMeasureStages;
+    bool m_bMeasuring;
+    QElapsedTimer m_stageTimer;
+    QList<QPair<QString, qint64>> m_listStageTimings;
+    bool m_bPygmentizeChecked;
+    bool m_bPygmentize;
 };
 
 #endif  // APPLICATION_PARSER_PARSER_H_
@@ -23,6 +23,7 @@ HEADERS     += $$PWD/parser.h \
                $$PWD/parselinks.h \
                $$PWD/parselist.h \
                $$PWD/parsetable.h \
+               $$PWD/parsestatistics.h \
                $$PWD/parsetemplates.h \
                $$PWD/parsetextformats.h \
                $$PWD/parsetxtmap.h \
@@ -34,6 +35,7 @@ SOURCES     += $$PWD/parser.cpp \
                $$PWD/parselinks.cpp \
                $$PWD/parselist.cpp \
                $$PWD/parsetable.cpp \
+               $$PWD/parsestatistics.cpp \
                $$PWD/parsetemplates.cpp \
                $$PWD/parsetextformats.cpp \
                $$PWD/parsetxtmap.cpp \
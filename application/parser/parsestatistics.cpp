@@ -0,0 +1,77 @@
+/**
+ * \file parsestatistics.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Parser statistics: Counters for template invocations, regular expression
+ * matches, network checks and started processes.
+ */
+
+#include "./parsestatistics.h"
+
+#include <QCoreApplication>
+
+std::atomic<bool> ParseStatistics::m_bEnabled(false);
+thread_local qint64 ParseStatistics::m_nCounters[NUMCOUNTERS] = {};
+
+void ParseStatistics::setEnabled(const bool bEnabled) {
+  m_bEnabled.store(bEnabled, std::memory_order_relaxed);
+}
+
+// ----------------------------------------------------------------------------
+
+void ParseStatistics::resetCounters() {
+  for (auto &nCounter : m_nCounters) {
+    nCounter = 0;
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+auto ParseStatistics::getCounters() -> QVector<qint64> {
+  QVector<qint64> listCounters;
+  listCounters.reserve(NUMCOUNTERS);
+  for (const auto nCounter : m_nCounters) {
+    listCounters << nCounter;
+  }
+  return listCounters;
+}
+
+// ----------------------------------------------------------------------------
+
+auto ParseStatistics::getCounterName(const int nCounter) -> QString {
+  switch (nCounter) {
+    case TEMPLATES:
+      return QCoreApplication::translate("ParseStatistics",
+                                         "Template invocations");
+    case REGEXMATCHES:
+      return QCoreApplication::translate("ParseStatistics",
+                                         "Regular expression matches");
+    case NETWORKCHECKS:
+      return QCoreApplication::translate("ParseStatistics",
+                                         "Network link checks");
+    case PROCESSES:
+      return QCoreApplication::translate("ParseStatistics",
+                                         "Started processes");
+    default:
+      return QString();
+  }
+}
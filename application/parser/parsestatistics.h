@@ -0,0 +1,77 @@
+/**
+ * \file parsestatistics.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for parser statistics (counters, preview timings).
+ */
+
+#ifndef APPLICATION_PARSER_PARSESTATISTICS_H_
+#define APPLICATION_PARSER_PARSESTATISTICS_H_
+
+#include <QDateTime>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+
+/**
+ * \struct PreviewStatistics
+ * \brief Timings and counters of one generated preview
+ */
+struct PreviewStatistics {
+  QDateTime timestamp;
+  QString sFile;
+  int nLines;
+  QList<QPair<QString, qint64>> listStages;  // Stage name, duration (nsecs)
+  QVector<qint64> listCounters;  // Index = ParseStatistics::COUNTER
+};
+
+/**
+ * \class ParseStatistics
+ * \brief Cheap per thread counters, only updated if statistics are enabled
+ */
+class ParseStatistics {
+ public:
+    enum COUNTER {TEMPLATES, REGEXMATCHES, NETWORKCHECKS, PROCESSES,
+                  NUMCOUNTERS};
+
+    static void setEnabled(const bool bEnabled);
+    static inline auto isEnabled() -> bool {
+      return m_bEnabled.load(std::memory_order_relaxed);
+    }
+    static inline void count(const COUNTER counter, const qint64 n = 1) {
+      if (ParseStatistics::isEnabled()) {
+        m_nCounters[counter] += n;
+      }
+    }
+    static void resetCounters();
+    static auto getCounters() -> QVector<qint64>;
+    static auto getCounterName(const int nCounter) -> QString;
+
+ private:
+    static std::atomic<bool> m_bEnabled;
+    static thread_local qint64 m_nCounters[NUMCOUNTERS];
+};
+
+#endif  // APPLICATION_PARSER_PARSESTATISTICS_H_
@@ -30,6 +30,7 @@
 #include <QRegularExpression>
 #include <QTextDocument>
 
+#include "./parsestatistics.h"
 #include "./provisionaltplparser.h"
 
 ParseTemplates::ParseTemplates(const QStringList &sListTransTpl,
@@ -60,6 +61,7 @@ ParseTemplates::ParseTemplates(const QStringList &sListTransTpl,
 void ParseTemplates::startParsing(QTextDocument *pRawDoc,
                                   const QString &sCurrentFile) {
   m_sCurrentFile = sCurrentFile;
+  m_sListUsedTemplates.clear();
 
   QStringList sListTplRegExp;
   QStringList sListTrans;
@@ -81,6 +83,7 @@ void ParseTemplates::startParsing(QTextDocument *pRawDoc,
     int nPos = 0;
 
     while ((match = findTemplate.match(sDoc, nPos)).hasMatch()) {
+      ParseStatistics::count(ParseStatistics::REGEXMATCHES);
       QString sMacro = match.captured(0);
       QString sBackupMacro = sMacro;
       if (sMacro.startsWith("[[" + sListTrans[k], Qt::CaseInsensitive)) {
@@ -199,6 +202,12 @@ void ParseTemplates::startParsing(QTextDocument *pRawDoc,
       }
 
       // qDebug() << "TPL:" << sListArguments;
+      ParseStatistics::count(ParseStatistics::TEMPLATES);
+      if (!sListArguments.isEmpty() &&
+          !m_sListUsedTemplates.contains(sListArguments[0],
+                                         Qt::CaseInsensitive)) {
+        m_sListUsedTemplates << sListArguments[0];
+      }
       sMacro = m_pProvTplTarser->parseTpl(sListArguments, m_sCurrentFile);
       if (sMacro.isEmpty()) {
         sMacro = sBackupMacro;
@@ -212,3 +221,9 @@ void ParseTemplates::startParsing(QTextDocument *pRawDoc,
 
   pRawDoc->setPlainText(sDoc);
 }
+
+// ----------------------------------------------------------------------------
+
+auto ParseTemplates::getUsedTemplates() const -> QStringList {
+  return m_sListUsedTemplates;
+}
@@ -49,12 +49,15 @@ class ParseTemplates {
                    const QString &sCommunity);
 
     void startParsing(QTextDocument *pRawDoc, const QString &sCurrentFile);
+    // Template names found by last startParsing() call
+    auto getUsedTemplates() const -> QStringList;
 
  private:
     ProvisionalTplParser *m_pProvTplTarser;
     QStringList m_sListTransTpl;
     QStringList m_sListTplNames;
     QString m_sCurrentFile;
+    QStringList m_sListUsedTemplates;
 };
 
 #endif  // APPLICATION_PARSER_PARSETEMPLATES_H_
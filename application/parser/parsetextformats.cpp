@@ -29,6 +29,8 @@
 #include <QRegularExpression>
 #include <QTextDocument>
 
+#include "./parsestatistics.h"
+
 ParseTextformats::ParseTextformats() = default;
 
 void ParseTextformats::startParsing(QTextDocument *pRawDoc,
@@ -63,6 +65,7 @@ void ParseTextformats::startParsing(QTextDocument *pRawDoc,
         nIndex = 0;
         QRegularExpressionMatch match;
         while ((match = patternTextformat.match(sDoc, nIndex)).hasMatch()) {
+          ParseStatistics::count(ParseStatistics::REGEXMATCHES);
           QString sCap(match.captured(1));
           nIndex = match.capturedStart();
           nLength = match.capturedLength();
@@ -88,6 +91,7 @@ void ParseTextformats::startParsing(QTextDocument *pRawDoc,
         nIndex = 0;
         QRegularExpressionMatch match;
         while ((match = patternTextformat.match(sDoc, nIndex)).hasMatch()) {
+          ParseStatistics::count(ParseStatistics::REGEXMATCHES);
           QString sCap(match.captured(1));
           nIndex = match.capturedStart();
           nLength = match.capturedLength();
@@ -125,6 +129,7 @@ void ParseTextformats::startParsing(QTextDocument *pRawDoc,
         nIndex = 0;
         QRegularExpressionMatch match;
         while ((match = patternTextformat.match(sDoc, nIndex)).hasMatch()) {
+          ParseStatistics::count(ParseStatistics::REGEXMATCHES);
           QString sCap(match.captured(1));
           nIndex = match.capturedStart();
           nLength = match.capturedLength();
@@ -29,21 +29,36 @@
 #include <QApplication>
 #include <QDebug>
 #include <QIcon>
+#include <QJsonObject>
 #include <QPluginLoader>
+#include <QtConcurrent>
 
 #include "./texteditor.h"
+#include "./trace/trace.h"
 
 Plugins::Plugins(QWidget *pParent, TextEditor *pEditor,
                  const QStringList &sListDisabledPlugins,
                  const QDir &userDataDir, const QString &sSharePath,
-                 QObject *pObj)
+                 IRenderService *pRenderService, QObject *pObj)
   : m_pParent(pParent),
     m_pEditor(pEditor),
     m_sListDisabledPlugins(sListDisabledPlugins),
     m_userDataDir(userDataDir),
-    m_sSharePath(sSharePath) {
+    m_sSharePath(sSharePath),
+    m_pRenderService(pRenderService),
+    m_bInstancesCreated(false) {
   Q_UNUSED(pObj)
-  QStringList sListAvailablePlugins;
+
+  // Reading and linking plugin libraries does not need the main thread
+  m_futurePluginFiles = QtConcurrent::run(
+                           &Plugins::loadLibraries,
+                           Plugins::getPluginDirs(userDataDir, sSharePath));
+}
+
+// ----------------------------------------------------------------------------
+
+auto Plugins::getPluginDirs(const QDir &userDataDir,
+                            const QString &sSharePath) -> QList<QDir> {
   QList<QDir> listPluginsDir;
 
   // If share folder start parameter is used
@@ -55,7 +70,7 @@ Plugins::Plugins(QWidget *pParent, TextEditor *pEditor,
     }
   }
   // Plugins in user folder
-  pluginsDir.setPath(m_userDataDir.absolutePath());
+  pluginsDir.setPath(userDataDir.absolutePath());
   if (pluginsDir.cd(QStringLiteral("plugins"))) {
     if (!listPluginsDir.contains(pluginsDir)) {
       listPluginsDir << pluginsDir;
@@ -76,33 +91,99 @@ Plugins::Plugins(QWidget *pParent, TextEditor *pEditor,
       listPluginsDir << pluginsDir;
     }
   }
+  return listPluginsDir;
+}
 
-  // Look for available plugins
-  for (const auto &dir : qAsConst(listPluginsDir)) {
-    qDebug() << "Plugins folder:" << dir.absolutePath();
+// ----------------------------------------------------------------------------
+
+// Headless use: Only the library with matching IID is loaded (the meta data
+// is read without loading the other libraries)
+auto Plugins::loadPlugin(const QString &sIid,
+                         const QStringList &sListDisabledPlugins,
+                         const QDir &userDataDir,
+                         const QString &sSharePath) -> QObject* {
+  const QList<QDir> listPluginsDir(Plugins::getPluginDirs(userDataDir,
+                                                          sSharePath));
+  for (const auto &dir : listPluginsDir) {
     const QStringList entryList(dir.entryList(QDir::Files));
     for (const auto &sFile : entryList) {
-      qDebug() << "Plugin file:" << sFile;
       QPluginLoader loader(dir.absoluteFilePath(sFile));
+      if (loader.metaData().value(QStringLiteral("IID")).toString() != sIid) {
+        continue;
+      }
+      qDebug() << "Plugin file:" << loader.fileName();
       QObject *pPlugin = loader.instance();
-      if (pPlugin) {
-        IEditorPlugin *piPlugin = qobject_cast<IEditorPlugin *>(pPlugin);
-
-        if (piPlugin) {
-          // Check for duplicates
-          if (sListAvailablePlugins.contains(piPlugin->getPluginName())) {
-            qDebug() << "             ... skipping duplicate file!";
-            continue;
-          }
-          sListAvailablePlugins << piPlugin->getPluginName();
-          m_listPlugins << piPlugin;
-          m_listPluginObjects << pPlugin;
-        } else {
-          qWarning() << "           ... invalid IEditorPlugin file!";
+      auto *piPlugin = qobject_cast<IEditorPlugin *>(pPlugin);
+      if (nullptr == piPlugin) {
+        qWarning() << "Plugin cannot be loaded:" << sFile
+                   << loader.errorString();
+        continue;
+      }
+      if (sListDisabledPlugins.contains(piPlugin->getPluginName())) {
+        qDebug() << "Disabled plugin:" << piPlugin->getPluginName();
+        return nullptr;
+      }
+      return pPlugin;
+    }
+  }
+  return nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+// Worker thread: Library stays loaded after loader is destroyed, so
+// instance() in main thread only has to create the plugin object
+auto Plugins::loadLibraries(const QList<QDir> &listPluginsDir) -> QStringList {
+  TraceSpan span("plugins", "loadLibraries");
+  QStringList sListFiles;
+  for (const auto &dir : listPluginsDir) {
+    qDebug() << "Plugins folder:" << dir.absolutePath();
+    const QStringList entryList(dir.entryList(QDir::Files));
+    for (const auto &sFile : entryList) {
+      QPluginLoader loader(dir.absoluteFilePath(sFile));
+      if (loader.load()) {
+        sListFiles << loader.fileName();
+      } else {
+        qWarning() << "Plugin cannot be loaded:" << sFile
+                   << loader.errorString();
+      }
+    }
+  }
+  return sListFiles;
+}
+
+// ----------------------------------------------------------------------------
+
+void Plugins::createInstances() {
+  if (m_bInstancesCreated) {
+    return;
+  }
+  m_bInstancesCreated = true;
+
+  QStringList sListAvailablePlugins;
+  const QStringList sListFiles(m_futurePluginFiles.result());
+  for (const auto &sFile : sListFiles) {
+    qDebug() << "Plugin file:" << sFile;
+    QPluginLoader loader(sFile);
+    QObject *pPlugin = loader.instance();
+    if (pPlugin) {
+      IEditorPlugin *piPlugin = qobject_cast<IEditorPlugin *>(pPlugin);
+
+      if (piPlugin) {
+        // Check for duplicates
+        if (sListAvailablePlugins.contains(piPlugin->getPluginName())) {
+          qDebug() << "             ... skipping duplicate file!";
+          continue;
         }
+        sListAvailablePlugins << piPlugin->getPluginName();
+        m_listPlugins << piPlugin;
+        m_listPluginObjects << pPlugin;
       } else {
-        qWarning() << "           ... plugin cannot be loaded!";
+        qWarning() << "           ... invalid IEditorPlugin file!";
       }
+    } else {
+      qWarning() << "           ... plugin cannot be loaded!";
     }
   }
 }
@@ -111,6 +192,7 @@ Plugins::Plugins(QWidget *pParent, TextEditor *pEditor,
 // ----------------------------------------------------------------------------
 
 void Plugins::loadPlugins(const QString &sLang) {
+  this->createInstances();
   m_PluginMenuEntries.clear();
   m_PluginToolbarEntries.clear();
 
@@ -122,7 +204,8 @@ void Plugins::loadPlugins(const QString &sLang) {
     }
 
     m_listPlugins.at(i)->initPlugin(m_pParent, m_pEditor,
-                                    m_userDataDir, m_sSharePath);
+                                    m_userDataDir, m_sSharePath,
+                                    m_pRenderService);
     m_listPlugins.at(i)->installTranslator(sLang);
 
     QString sMenu(m_listPlugins.at(i)->getCaption());
@@ -29,10 +29,12 @@
 
 #include <QAction>  // Cannot use forward declaration (since Qt 6)
 #include <QDir>
+#include <QFuture>
 #include <QList>
 
 #include "./ieditorplugin.h"  // Cannot use forward declaration (since Qt 6)
 
+class IRenderService;
 class TextEditor;
 
 class Plugins : public QObject {
@@ -41,10 +43,17 @@ class Plugins : public QObject {
  public:
     Plugins(QWidget *pParent, TextEditor *pEditor,
             const QStringList &sListDisabledPlugins, const QDir &userDataDir,
-            const QString &sSharePath, QObject *pObj = nullptr);
+            const QString &sSharePath, IRenderService *pRenderService,
+            QObject *pObj = nullptr);
+    // Create and initialize plugins (libraries are loaded in background)
     void loadPlugins(const QString &sLang);
     void setCurrentEditor(TextEditor *pEditor);
     void setEditorlist(const QList<TextEditor *> &listEditors);
+    // Load and create only the plugin with given IID, if not disabled
+    static auto loadPlugin(const QString &sIid,
+                           const QStringList &sListDisabledPlugins,
+                           const QDir &userDataDir,
+                           const QString &sSharePath) -> QObject*;
 
  public slots:
     void changeLang(const QString &sLang);
@@ -56,11 +65,20 @@ class Plugins : public QObject {
                                QList<QAction *> MenueEntries);
 
  private:
+    static auto getPluginDirs(const QDir &userDataDir,
+                              const QString &sSharePath) -> QList<QDir>;
+    static auto loadLibraries(
+        const QList<QDir> &listPluginsDir) -> QStringList;
+    void createInstances();
+
     QWidget *m_pParent;
     TextEditor *m_pEditor;
     QStringList m_sListDisabledPlugins;
     const QDir m_userDataDir;
     const QString m_sSharePath;
+    IRenderService *m_pRenderService;
+    QFuture<QStringList> m_futurePluginFiles;
+    bool m_bInstancesCreated;
 
     QList<IEditorPlugin *> m_listPlugins;
     QList<QObject *> m_listPluginObjects;
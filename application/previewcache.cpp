@@ -0,0 +1,171 @@
+/**
+ * \file previewcache.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Store and restore parsed preview of opened files.
+ */
+
+#include "./previewcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include "./parser/parser.h"
+
+PreviewCache::PreviewCache(const QString &sCacheDir)
+  : m_sCacheDir(sCacheDir) {
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewCache::setVersion(const QByteArray &baVersion) {
+  m_baVersion = baVersion;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto PreviewCache::lookup(const QString &sFile, const QString &sText,
+                          ParsedBody *pBody) const -> bool {
+  if (sFile.isEmpty()) {
+    return false;
+  }
+  QFile cacheFile(this->entryFile(sFile));
+  if (!cacheFile.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  QDataStream in(&cacheFile);
+  in.setVersion(QDataStream::Qt_5_9);
+  quint32 nMagic = 0;
+  quint32 nVersion = 0;
+  QByteArray baKey;
+  in >> nMagic >> nVersion >> baKey;
+  if (nMagic != m_cMAGIC || nVersion != m_cVERSION ||
+      baKey != this->key(sText)) {
+    return false;  // Outdated, will be overwritten by next store()
+  }
+
+  ParsedBody body;
+  in >> body.sContent >> body.sTags;
+  if (in.status() != QDataStream::Ok) {
+    qWarning() << "Corrupt preview cache:" << cacheFile.fileName();
+    return false;
+  }
+  *pBody = body;
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewCache::store(const QString &sFile, const QString &sText,
+                         const ParsedBody &body) {
+  if (sFile.isEmpty()) {
+    return;
+  }
+  QDir dir;
+  if (!dir.mkpath(m_sCacheDir)) {
+    qWarning() << "Could not create preview cache folder:" << m_sCacheDir;
+    return;
+  }
+
+  QSaveFile cacheFile(this->entryFile(sFile));
+  if (!cacheFile.open(QIODevice::WriteOnly)) {
+    qWarning() << "Could not write preview cache:" << cacheFile.fileName();
+    return;
+  }
+  QDataStream out(&cacheFile);
+  out.setVersion(QDataStream::Qt_5_9);
+  out << m_cMAGIC << m_cVERSION << this->key(sText)
+      << body.sContent << body.sTags;
+  if (!cacheFile.commit()) {
+    qWarning() << "Could not write preview cache:" << cacheFile.fileName();
+    return;
+  }
+  this->evict();
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewCache::storePending(const QString &sFile, const QString &sText,
+                                const ParsedBody &body) {
+  m_sPendingFile = sFile;
+  m_baPendingKey = this->key(sText);
+  m_sPendingContent = body.sContent;
+  m_sPendingTags = body.sTags;
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewCache::flushPending(const QString &sFile, const QString &sText) {
+  if (m_sPendingFile.isEmpty() || sFile != m_sPendingFile) {
+    return;
+  }
+  if (this->key(sText) == m_baPendingKey) {
+    ParsedBody body;
+    body.sContent = m_sPendingContent;
+    body.sTags = m_sPendingTags;
+    this->store(sFile, sText, body);
+  }
+  m_sPendingFile.clear();
+  m_baPendingKey.clear();
+  m_sPendingContent.clear();
+  m_sPendingTags.clear();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto PreviewCache::entryFile(const QString &sFile) const -> QString {
+  return m_sCacheDir + "/" + QCryptographicHash::hash(
+        sFile.toUtf8(), QCryptographicHash::Sha1).toHex() + ".cache";
+}
+
+// ----------------------------------------------------------------------------
+
+auto PreviewCache::key(const QString &sText) const -> QByteArray {
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(sText.toUtf8());
+  hash.addData(m_baVersion);
+  return hash.result();
+}
+
+// ----------------------------------------------------------------------------
+
+// One entry per file, so the folder grows with each previewed file
+void PreviewCache::evict() const {
+  // Newest first
+  const QFileInfoList listEntries(QDir(m_sCacheDir).entryInfoList(
+                                    QStringList() << QStringLiteral("*.cache"),
+                                    QDir::Files, QDir::Time));
+  qint64 nSize = 0;
+  for (int i = 0; i < listEntries.size(); i++) {
+    nSize += listEntries.at(i).size();
+    if (i >= m_cMAXENTRIES || nSize > m_cMAXSIZE) {
+      QFile::remove(listEntries.at(i).absoluteFilePath());
+    }
+  }
+}
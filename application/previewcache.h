@@ -0,0 +1,76 @@
+/**
+ * \file previewcache.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for on-disk cache of parsed preview.
+ */
+
+#ifndef APPLICATION_PREVIEWCACHE_H_
+#define APPLICATION_PREVIEWCACHE_H_
+
+#include <QByteArray>
+#include <QString>
+
+struct ParsedBody;
+
+/**
+ * \class PreviewCache
+ * \brief Parsed body of each opened file, shown instantly on next open
+ *
+ * Entries are keyed by file content and version of community data and
+ * settings. Volatile parts (date, time) are not cached, see
+ * Parser::wrapBody().
+ */
+class PreviewCache {
+ public:
+    explicit PreviewCache(const QString &sCacheDir);
+
+    void setVersion(const QByteArray &baVersion);
+    auto lookup(const QString &sFile, const QString &sText,
+                ParsedBody *pBody) const -> bool;
+    void store(const QString &sFile, const QString &sText,
+               const ParsedBody &body);
+    // Modified text: Kept in memory and only written, if it gets saved
+    void storePending(const QString &sFile, const QString &sText,
+                      const ParsedBody &body);
+    void flushPending(const QString &sFile, const QString &sText);
+
+ private:
+    auto entryFile(const QString &sFile) const -> QString;
+    auto key(const QString &sText) const -> QByteArray;
+    void evict() const;
+
+    static const quint32 m_cMAGIC = 0x494E5950;  // "INYP"
+    static const quint32 m_cVERSION = 1;
+    // Least recently stored entries are removed above these limits
+    static const int m_cMAXENTRIES = 500;
+    static const qint64 m_cMAXSIZE = 50 * 1024 * 1024;  // Bytes
+
+    const QString m_sCacheDir;
+    QByteArray m_baVersion;
+    QString m_sPendingFile;
+    QByteArray m_baPendingKey;
+    QString m_sPendingContent;
+    QString m_sPendingTags;
+};
+
+#endif  // APPLICATION_PREVIEWCACHE_H_
@@ -0,0 +1,284 @@
+/**
+ * \file previewserver.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Minimal HTTP server on localhost: preview page, live reload events and
+ * local files referenced by the preview.
+ */
+
+#include "./previewserver.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMimeDatabase>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUuid>
+
+PreviewServer::PreviewServer(const QStringList &sListRoots, QObject *pParent)
+  : QObject(pParent),
+    m_pServer(nullptr),
+    m_pKeepAliveTimer(nullptr),
+    m_sBase("/" + QString::fromLatin1(
+              QUuid::createUuid().toRfc4122().toHex()) + "/"),
+    m_nVersion(0) {
+  for (const auto &sRoot : sListRoots) {
+    const QString sCanonical(QFileInfo(sRoot).canonicalFilePath());
+    if (!sCanonical.isEmpty()) {
+      m_sListRoots << sCanonical;
+    }
+  }
+
+  QFile scriptFile(QStringLiteral(":/livereload.js"));
+  if (scriptFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    m_sScript = QString::fromUtf8(scriptFile.readAll());
+    scriptFile.close();
+  } else {
+    qWarning() << "Could not open live reload script:"
+               << scriptFile.fileName();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+auto PreviewServer::listen() -> bool {
+  m_pServer = new QTcpServer(this);
+  if (!m_pServer->listen(QHostAddress::LocalHost)) {
+    qWarning() << "Preview server could not be started:"
+               << m_pServer->errorString();
+    return false;
+  }
+  connect(m_pServer, &QTcpServer::newConnection,
+          this, &PreviewServer::newConnection);
+
+  // Comment lines keep event streams open and detect closed browser tabs
+  m_pKeepAliveTimer = new QTimer(this);
+  connect(m_pKeepAliveTimer, &QTimer::timeout,
+          this, &PreviewServer::keepAlive);
+  m_pKeepAliveTimer->start(15000);
+
+  qDebug() << "Preview server:" << this->getUrl();
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+auto PreviewServer::getUrl() const -> QUrl {
+  if (nullptr == m_pServer) {
+    return QUrl();
+  }
+  return QUrl("http://127.0.0.1:" + QString::number(m_pServer->serverPort()) +
+              m_sBase);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void PreviewServer::publish(const QString &sHtml) {
+  if (sHtml == m_sHtml && !m_baPage.isEmpty()) {
+    return;  // Nothing changed, browser keeps current page
+  }
+  m_sHtml = sHtml;
+  m_nVersion++;
+  m_baPage = this->injectScript(sHtml);
+
+  const QByteArray baEvent("data: " + QByteArray::number(m_nVersion) +
+                           "\n\n");
+  for (auto *pSocket : qAsConst(m_EventClients)) {
+    pSocket->write(baEvent);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewServer::setArticleFile(const QString &sFile) {
+  // Not yet saved article ("Untitled") has no folder
+  const QFileInfo fi(sFile);
+  m_sArticleDir = fi.isFile() ? fi.absoluteDir().canonicalPath() : QString();
+}
+
+// ----------------------------------------------------------------------------
+
+auto PreviewServer::injectScript(const QString &sHtml) const -> QByteArray {
+  QString sScript(m_sScript);
+  sScript.replace(QLatin1String("%VERSION%"), QString::number(m_nVersion));
+  sScript.replace(QLatin1String("%BASE%"), m_sBase);
+  sScript = "<script>\n" + sScript + "</script>\n";
+
+  QString sPage(sHtml);
+  const int nHead = sPage.indexOf(QLatin1String("</head>"), 0,
+                                  Qt::CaseInsensitive);
+  if (nHead >= 0) {
+    sPage.insert(nHead, sScript);
+  } else {
+    sPage.prepend(sScript);
+  }
+  return sPage.toUtf8();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void PreviewServer::newConnection() {
+  while (m_pServer->hasPendingConnections()) {
+    QTcpSocket *pSocket = m_pServer->nextPendingConnection();
+    connect(pSocket, &QTcpSocket::readyRead,
+            this, &PreviewServer::readRequest);
+    connect(pSocket, &QTcpSocket::disconnected,
+            this, &PreviewServer::disconnected);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewServer::readRequest() {
+  auto *pSocket = qobject_cast<QTcpSocket *>(sender());
+  if (nullptr == pSocket || m_EventClients.contains(pSocket)) {
+    return;
+  }
+
+  const QByteArray baRequest(m_Requests.take(pSocket) + pSocket->readAll());
+  if (!baRequest.contains("\r\n\r\n")) {
+    if (baRequest.size() > m_cMAXHEADER) {
+      PreviewServer::sendResponse(pSocket, "431 Request Header Fields Too "
+                                  "Large", "text/plain", QByteArray(), false);
+    } else {
+      m_Requests.insert(pSocket, baRequest);  // Wait for rest of header
+    }
+    return;
+  }
+
+  // Only request line is needed: "GET /path HTTP/1.1"
+  const QList<QByteArray> listRequest(
+        baRequest.left(baRequest.indexOf("\r\n")).split(' '));
+  if (listRequest.size() != 3 ||
+      (listRequest[0] != "GET" && listRequest[0] != "HEAD")) {
+    PreviewServer::sendResponse(pSocket, "405 Method Not Allowed",
+                                "text/plain", QByteArray(), false);
+    return;
+  }
+  const bool bHead(listRequest[0] == "HEAD");
+  QString sPath(QUrl::fromPercentEncoding(listRequest[1]));
+  sPath = sPath.left(sPath.indexOf('?'));
+
+  if (sPath == m_sBase || sPath + "/" == m_sBase) {
+    this->sendPage(pSocket, bHead);
+  } else if (sPath == m_sBase + "events") {
+    this->startEvents(pSocket);
+  } else {
+    this->sendFile(pSocket, sPath, bHead);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewServer::disconnected() {
+  auto *pSocket = qobject_cast<QTcpSocket *>(sender());
+  if (nullptr == pSocket) {
+    return;
+  }
+  m_Requests.remove(pSocket);
+  m_EventClients.removeAll(pSocket);
+  pSocket->deleteLater();
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewServer::keepAlive() {
+  for (auto *pSocket : qAsConst(m_EventClients)) {
+    pSocket->write(": ping\n\n");
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void PreviewServer::sendPage(QTcpSocket *pSocket, const bool bHead) {
+  PreviewServer::sendResponse(pSocket, "200 OK", "text/html; charset=utf-8",
+                              m_baPage, bHead);
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewServer::sendFile(QTcpSocket *pSocket, const QString &sPath,
+                             const bool bHead) {
+  const QFileInfo fi(sPath);
+  QFile file(fi.canonicalFilePath());
+  if (!fi.isFile() || !this->isAllowed(fi.canonicalFilePath()) ||
+      !file.open(QIODevice::ReadOnly)) {
+    PreviewServer::sendResponse(pSocket, "404 Not Found", "text/plain",
+                                QByteArray(), bHead);
+    return;
+  }
+  const QByteArray baType(QMimeDatabase().mimeTypeForFile(fi).name().toUtf8());
+  PreviewServer::sendResponse(pSocket, "200 OK", baType, file.readAll(),
+                              bHead);
+  file.close();
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewServer::startEvents(QTcpSocket *pSocket) {
+  m_EventClients << pSocket;
+  // Current version: Browser updates if page was loaded before last change
+  pSocket->write("HTTP/1.1 200 OK\r\n"
+                 "Content-Type: text/event-stream\r\n"
+                 "Cache-Control: no-store\r\n"
+                 "Connection: keep-alive\r\n\r\n"
+                 "retry: 1000\n"
+                 "data: " + QByteArray::number(m_nVersion) + "\n\n");
+}
+
+// ----------------------------------------------------------------------------
+
+void PreviewServer::sendResponse(QTcpSocket *pSocket,
+                                 const QByteArray &baStatus,
+                                 const QByteArray &baType,
+                                 const QByteArray &baBody, const bool bHead) {
+  pSocket->write("HTTP/1.1 " + baStatus + "\r\n"
+                 "Content-Type: " + baType + "\r\n"
+                 "Content-Length: " + QByteArray::number(baBody.size()) +
+                 "\r\n"
+                 "Cache-Control: no-store\r\n"
+                 "Connection: close\r\n\r\n");
+  if (!bHead) {
+    pSocket->write(baBody);
+  }
+  pSocket->disconnectFromHost();  // After pending data has been written
+}
+
+// ----------------------------------------------------------------------------
+
+auto PreviewServer::isAllowed(const QString &sPath) const -> bool {
+  if (sPath.isEmpty()) {
+    return false;
+  }
+  for (const auto &sRoot : m_sListRoots) {
+    if (sPath.startsWith(sRoot + "/")) {
+      return true;
+    }
+  }
+  return !m_sArticleDir.isEmpty() && sPath.startsWith(m_sArticleDir + "/");
+}
@@ -0,0 +1,96 @@
+/**
+ * \file previewserver.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for local HTTP server of preview (no integrated preview).
+ */
+
+#ifndef APPLICATION_PREVIEWSERVER_H_
+#define APPLICATION_PREVIEWSERVER_H_
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QUrl>
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+
+/**
+ * \class PreviewServer
+ * \brief Serve preview from memory and push new versions to the browser
+ *
+ * The page is reachable on localhost under a random path. Browsers are
+ * notified via Server-Sent Events only if the HTML changed and update the
+ * changed blocks in place (data/livereload.js). Local files referenced by
+ * the preview (community web files, images) are served from given folders
+ * and from the folder of the current article.
+ */
+class PreviewServer : public QObject {
+  Q_OBJECT
+
+ public:
+    explicit PreviewServer(const QStringList &sListRoots,
+                           QObject *pParent = nullptr);
+
+    auto listen() -> bool;
+    auto getUrl() const -> QUrl;
+    void publish(const QString &sHtml);
+    // Images next to the article (see Macros::replacePictures())
+    void setArticleFile(const QString &sFile);
+
+ private slots:
+    void newConnection();
+    void readRequest();
+    void disconnected();
+    void keepAlive();
+
+ private:
+    void sendPage(QTcpSocket *pSocket, const bool bHead);
+    void sendFile(QTcpSocket *pSocket, const QString &sPath,
+                  const bool bHead);
+    void startEvents(QTcpSocket *pSocket);
+    static void sendResponse(QTcpSocket *pSocket, const QByteArray &baStatus,
+                             const QByteArray &baType,
+                             const QByteArray &baBody, const bool bHead);
+    auto injectScript(const QString &sHtml) const -> QByteArray;
+    auto isAllowed(const QString &sPath) const -> bool;
+
+    static const int m_cMAXHEADER = 16 * 1024;
+
+    QStringList m_sListRoots;
+    QString m_sArticleDir;
+    QTcpServer *m_pServer;
+    QTimer *m_pKeepAliveTimer;
+    QString m_sBase;  // Random path: "/<token>/"
+    QString m_sScript;
+    QString m_sHtml;
+    QByteArray m_baPage;
+    quint64 m_nVersion;
+    QHash<QTcpSocket *, QByteArray> m_Requests;
+    QList<QTcpSocket *> m_EventClients;
+};
+
+#endif  // APPLICATION_PREVIEWSERVER_H_
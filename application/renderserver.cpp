@@ -0,0 +1,330 @@
+/**
+ * \file renderserver.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Keep community data and parsers loaded and answer requests of local
+ * clients (render, syntax check, spell check).
+ */
+
+#include "./renderserver.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QRunnable>
+#include <QTextDocument>
+#include <QThread>
+#include <QThreadStorage>
+#include <QtEndian>
+
+#include "./ieditorplugin.h"
+#include "./ispellchecker.h"
+#include "./parser/parser.h"
+#include "./plugins.h"
+#include "./settings.h"
+#include "./spellrenderservice.h"
+#include "./templates/templates.h"
+
+/**
+ * \class ServeTask
+ * \brief One request; answer is passed back to thread of server
+ */
+class ServeTask : public QRunnable {
+ public:
+    ServeTask(ServeContext *pContext, QObject *pServer, const int nClient,
+              const QJsonObject &request)
+      : m_pContext(pContext),
+        m_pServer(pServer),
+        m_nClient(nClient),
+        m_request(request) {
+    }
+
+    void run() override {
+      QJsonObject reply(this->process());
+      reply.insert(QStringLiteral("id"), m_request.value(QStringLiteral("id")));
+      QMetaObject::invokeMethod(
+            m_pServer, "sendReply", Qt::QueuedConnection,
+            Q_ARG(int, m_nClient),
+            Q_ARG(QByteArray,
+                  QJsonDocument(reply).toJson(QJsonDocument::Compact)));
+    }
+
+ private:
+    auto process() -> QJsonObject {
+      const QString sCommand(
+            m_request.value(QStringLiteral("command")).toString());
+      const QString sText(m_request.value(QStringLiteral("text")).toString());
+      QJsonObject reply;
+      reply.insert(QStringLiteral("ok"), true);
+
+      if (QLatin1String("spell") == sCommand) {
+        if (nullptr == m_pContext->pSpellChecker) {
+          return ServeTask::error(
+                QStringLiteral("Spell checker not available"));
+        }
+        const QList<QPair<int, QString>> listWords(
+              m_pContext->pSpellChecker->checkText(sText));
+        QJsonArray words;
+        for (const auto &word : qAsConst(listWords)) {
+          QJsonObject entry;
+          entry.insert(QStringLiteral("position"), word.first);
+          entry.insert(QStringLiteral("word"), word.second);
+          words << entry;
+        }
+        reply.insert(QStringLiteral("words"), words);
+        return reply;
+      }
+
+      QTextDocument doc;
+      doc.setPlainText(sText);
+      if (QLatin1String("render") == sCommand) {
+        reply.insert(QStringLiteral("html"),
+                     this->parser()->genOutput(
+                       m_request.value(QStringLiteral("file")).toString(),
+                       &doc));
+      } else if (QLatin1String("check") == sCommand) {
+        const QList<SyntaxError> listErrors(this->parser()->checkSyntax(&doc));
+        QJsonArray errors;
+        for (const auto &error : listErrors) {
+          QJsonObject entry;
+          entry.insert(QStringLiteral("position"), error.nPos);
+          entry.insert(QStringLiteral("length"), error.nLength);
+          entry.insert(QStringLiteral("error"), error.sCode);
+          if (!error.sArg.isEmpty()) {
+            entry.insert(QStringLiteral("argument"), error.sArg);
+          }
+          errors << entry;
+        }
+        reply.insert(QStringLiteral("errors"), errors);
+      } else {
+        return ServeTask::error("Unknown command: " + sCommand);
+      }
+      return reply;
+    }
+
+    auto parser() -> Parser* {
+      // Created once in each pool thread and kept for all requests
+      static QThreadStorage<Parser *> parsers;
+      if (!parsers.hasLocalData()) {
+        parsers.setLocalData(new Parser(m_pContext->sSharePath,
+                                        m_pContext->tmpImgDir,
+                                        m_pContext->sInyokaUrl, false,
+                                        m_pContext->pTemplates,
+                                        m_pContext->sCommunity,
+                                        m_pContext->sPygmentize));
+      }
+      return parsers.localData();
+    }
+
+    static auto error(const QString &sError) -> QJsonObject {
+      QJsonObject reply;
+      reply.insert(QStringLiteral("ok"), false);
+      reply.insert(QStringLiteral("error"), sError);
+      return reply;
+    }
+
+    ServeContext *m_pContext;
+    QObject *m_pServer;
+    const int m_nClient;
+    const QJsonObject m_request;
+};
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+RenderServer::RenderServer(const QString &sSharePath,
+                           const QDir &userDataDir, QObject *pParent)
+  : QObject(pParent),
+    m_UserDataDir(userDataDir),
+    m_pServer(nullptr),
+    m_nNextClient(0) {
+  // Same community, URL and pygmentize as configured for GUI
+  m_pSettings = new Settings(nullptr, sSharePath);
+  m_context.sSharePath = sSharePath;
+  m_context.tmpImgDir.setPath(m_UserDataDir.absolutePath() + "/tmpImages");
+  m_context.sInyokaUrl = m_pSettings->getInyokaUrl();
+  m_context.sCommunity = m_pSettings->getInyokaCommunity();
+  m_context.sPygmentize = m_pSettings->getPygmentize();
+  m_context.pTemplates = new Templates(m_context.sCommunity, sSharePath,
+                                       m_UserDataDir.absolutePath());
+  m_context.pSpellChecker = nullptr;
+  // Template keywords, so that the same words are checked as in GUI
+  m_pRenderService = new SpellRenderService(m_context.pTemplates);
+
+  // Spell checker plugin is used without GUI (no parent, no editor),
+  // other plugin libraries are not loaded
+  QObject *pPlugin = Plugins::loadPlugin(
+                       QString::fromLatin1(ISpellChecker::m_cPLUGINIID),
+                       m_pSettings->getDisabledPlugins(),
+                       m_UserDataDir, sSharePath);
+  if (nullptr != pPlugin) {
+    qobject_cast<IEditorPlugin *>(pPlugin)->initPlugin(
+          nullptr, nullptr, m_UserDataDir, sSharePath, m_pRenderService);
+    auto *pSpellChecker = qobject_cast<ISpellChecker *>(pPlugin);
+    if (nullptr != pSpellChecker && pSpellChecker->initSpellCheck()) {
+      m_context.pSpellChecker = pSpellChecker;
+    }
+  }
+  if (nullptr == m_context.pSpellChecker) {
+    qWarning() << "Spell checker not available";
+  }
+}
+
+RenderServer::~RenderServer() {
+  m_pool.waitForDone();
+  delete m_pRenderService;
+  m_pRenderService = nullptr;
+  delete m_context.pTemplates;
+  m_context.pTemplates = nullptr;
+  delete m_pSettings;
+  m_pSettings = nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto RenderServer::listen(const QString &sName, const int nJobs) -> bool {
+  QLocalSocket probe;
+  probe.connectToServer(sName);
+  if (probe.waitForConnected(500)) {
+    qWarning() << "Server is already running:" << sName;
+    return false;
+  }
+  QLocalServer::removeServer(sName);  // Left over by crashed instance
+
+  m_pServer = new QLocalServer(this);
+  m_pServer->setSocketOptions(QLocalServer::UserAccessOption);
+  if (!m_pServer->listen(sName)) {
+    qWarning() << "Could not listen on" << sName << m_pServer->errorString();
+    return false;
+  }
+  connect(m_pServer, &QLocalServer::newConnection,
+          this, &RenderServer::newConnection);
+
+  m_pool.setMaxThreadCount(nJobs > 0 ? nJobs : QThread::idealThreadCount());
+  // Threads and their parsers are kept between requests; idle threads
+  // expire and their parser is deleted by QThreadStorage
+  m_pool.setExpiryTimeout(m_cIDLETIMEOUT);
+  qInfo() << "Listening on" << m_pServer->fullServerName() << "with"
+          << m_pool.maxThreadCount() << "threads";
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void RenderServer::newConnection() {
+  while (m_pServer->hasPendingConnections()) {
+    QLocalSocket *pSocket = m_pServer->nextPendingConnection();
+    const int nClient = m_nNextClient++;
+    pSocket->setProperty("client", nClient);
+    m_Clients.insert(nClient, pSocket);
+    connect(pSocket, &QLocalSocket::readyRead,
+            this, &RenderServer::readRequests);
+    connect(pSocket, &QLocalSocket::disconnected,
+            this, &RenderServer::disconnected);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void RenderServer::readRequests() {
+  auto *pSocket = qobject_cast<QLocalSocket *>(sender());
+  if (nullptr == pSocket) {
+    return;
+  }
+  const int nClient = pSocket->property("client").toInt();
+  QByteArray baBuffer(m_Buffers.take(nClient) + pSocket->readAll());
+
+  // Frame: 32 bit big endian length + JSON request
+  while (baBuffer.size() >= 4) {
+    const quint32 nLength = qFromBigEndian<quint32>(
+                              reinterpret_cast<const uchar *>(
+                                baBuffer.constData()));
+    if (nLength > m_cMAXFRAME) {
+      qWarning() << "Request too large, closing connection:" << nLength;
+      pSocket->disconnectFromServer();
+      return;
+    }
+    if (static_cast<quint32>(baBuffer.size() - 4) < nLength) {
+      break;  // Wait for rest of frame
+    }
+    const QByteArray baRequest(baBuffer.mid(4, static_cast<int>(nLength)));
+    baBuffer.remove(0, 4 + static_cast<int>(nLength));
+
+    QJsonParseError parseError{};
+    const QJsonDocument doc(QJsonDocument::fromJson(baRequest, &parseError));
+    if (!doc.isObject()) {
+      this->sendReply(nClient, RenderServer::errorReply(
+                        QJsonValue(),
+                        "Invalid request: " + parseError.errorString()));
+      continue;
+    }
+    m_pool.start(new ServeTask(&m_context, this, nClient, doc.object()));
+  }
+
+  if (!baBuffer.isEmpty()) {
+    m_Buffers.insert(nClient, baBuffer);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void RenderServer::disconnected() {
+  auto *pSocket = qobject_cast<QLocalSocket *>(sender());
+  if (nullptr == pSocket) {
+    return;
+  }
+  // Answers of running requests are dropped (see sendReply())
+  const int nClient = pSocket->property("client").toInt();
+  m_Clients.remove(nClient);
+  m_Buffers.remove(nClient);
+  pSocket->deleteLater();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void RenderServer::sendReply(const int nClient, const QByteArray &baReply) {
+  QLocalSocket *pSocket = m_Clients.value(nClient, nullptr);
+  if (nullptr == pSocket) {
+    return;  // Client disconnected meanwhile
+  }
+  QByteArray baLength(4, '\0');
+  qToBigEndian<quint32>(static_cast<quint32>(baReply.size()),
+                        reinterpret_cast<uchar *>(baLength.data()));
+  pSocket->write(baLength + baReply);
+}
+
+// ----------------------------------------------------------------------------
+
+auto RenderServer::errorReply(const QJsonValue &id,
+                              const QString &sError) -> QByteArray {
+  QJsonObject reply;
+  reply.insert(QStringLiteral("id"), id);
+  reply.insert(QStringLiteral("ok"), false);
+  reply.insert(QStringLiteral("error"), sError);
+  return QJsonDocument(reply).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,104 @@
+/**
+ * \file renderserver.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for local render service (command line).
+ */
+
+#ifndef APPLICATION_RENDERSERVER_H_
+#define APPLICATION_RENDERSERVER_H_
+
+#include <QByteArray>
+#include <QDir>
+#include <QHash>
+#include <QJsonValue>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+class QLocalServer;
+class QLocalSocket;
+
+class IRenderService;
+class ISpellChecker;
+class Settings;
+class Templates;
+
+/**
+ * \struct ServeContext
+ * \brief Warm data shared by all requests
+ */
+struct ServeContext {
+  QString sSharePath;
+  QDir tmpImgDir;
+  QString sInyokaUrl;
+  QString sCommunity;
+  QString sPygmentize;
+  Templates *pTemplates;  // Only const getters are used
+  ISpellChecker *pSpellChecker;  // nullptr if not available, thread safe
+};
+
+/**
+ * \class RenderServer
+ * \brief Render, syntax and spell check requests over a local socket
+ *
+ * Each message is a 32 bit big endian length followed by UTF-8 JSON.
+ * Request: {"id": any, "command": "render" | "check" | "spell",
+ * "text": "...", "file": "optional name"}. Answers contain the same id,
+ * "ok" and "html", "errors" or "words" (or "error" if ok is false).
+ * Requests are processed in parallel, each thread keeps its own parser.
+ */
+class RenderServer : public QObject {
+  Q_OBJECT
+
+ public:
+    RenderServer(const QString &sSharePath, const QDir &userDataDir,
+                 QObject *pParent = nullptr);
+    ~RenderServer();
+
+    auto listen(const QString &sName, const int nJobs) -> bool;
+
+ private slots:
+    void newConnection();
+    void readRequests();
+    void disconnected();
+    void sendReply(const int nClient, const QByteArray &baReply);
+
+ private:
+    static auto errorReply(const QJsonValue &id,
+                           const QString &sError) -> QByteArray;
+
+    static const quint32 m_cMAXFRAME = 64 * 1024 * 1024;
+    static const int m_cIDLETIMEOUT = 5 * 60 * 1000;  // ms
+
+    const QDir m_UserDataDir;
+    Settings *m_pSettings;
+    IRenderService *m_pRenderService;  // For spell checker plugin
+    ServeContext m_context;
+    QThreadPool m_pool;
+    QLocalServer *m_pServer;
+    QHash<int, QLocalSocket *> m_Clients;
+    QHash<int, QByteArray> m_Buffers;
+    int m_nNextClient;
+};
+
+#endif  // APPLICATION_RENDERSERVER_H_
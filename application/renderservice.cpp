@@ -0,0 +1,104 @@
+/**
+ * \file renderservice.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Rendering service shared with plugins.
+ */
+
+#include "./renderservice.h"
+
+#include <QTextDocument>
+#include <QThread>
+
+#include "./parser/parser.h"
+#include "./templates/templates.h"
+
+RenderService::RenderService(Parser *pParser, const Templates *pTemplates,
+                             QObject *pParent)
+  : QObject(pParent),
+    m_pParser(pParser),
+    m_pTemplates(pTemplates) {
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto RenderService::getTemplates() const -> const Templates* {
+  return m_pTemplates;
+}
+
+auto RenderService::getMacroDefinitions() const
+    -> QList<QPair<QString, QStringList>> {
+  if (nullptr == m_pTemplates) {
+    return QList<QPair<QString, QStringList>>();
+  }
+  return m_pTemplates->getMacroDefinitions();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto RenderService::render(const QString &sRawText,
+                           const QString &sFileName) -> QString {
+  if (QThread::currentThread() == this->thread()) {
+    return this->renderLocal(sRawText, sFileName);
+  }
+
+  // Serialized by event loop of main thread
+  QString sHtml;
+  QMetaObject::invokeMethod(this, "renderLocal",
+                            Qt::BlockingQueuedConnection,
+                            Q_RETURN_ARG(QString, sHtml),
+                            Q_ARG(QString, sRawText),
+                            Q_ARG(QString, sFileName));
+  return sHtml;
+}
+
+auto RenderService::renderFragment(const QString &sFragment,
+                                   const bool bWithStyle) -> QString {
+  if (QThread::currentThread() == this->thread()) {
+    return this->renderFragmentLocal(sFragment, bWithStyle);
+  }
+
+  QString sHtml;
+  QMetaObject::invokeMethod(this, "renderFragmentLocal",
+                            Qt::BlockingQueuedConnection,
+                            Q_RETURN_ARG(QString, sHtml),
+                            Q_ARG(QString, sFragment),
+                            Q_ARG(bool, bWithStyle));
+  return sHtml;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+QString RenderService::renderLocal(const QString &sRawText,
+                                   const QString &sFileName) {
+  QTextDocument doc;
+  doc.setPlainText(sRawText);
+  return m_pParser->genOutput(sFileName, &doc);
+}
+
+QString RenderService::renderFragmentLocal(const QString &sFragment,
+                                           const bool bWithStyle) {
+  return m_pParser->genFragment(sFragment, bWithStyle, false);
+}
@@ -0,0 +1,68 @@
+/**
+ * \file renderservice.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for rendering service shared with plugins.
+ */
+
+#ifndef APPLICATION_RENDERSERVICE_H_
+#define APPLICATION_RENDERSERVICE_H_
+
+#include <QObject>
+
+#include "./irenderservice.h"
+
+class Parser;
+
+/**
+ * \class RenderService
+ * \brief Gives plugins access to parser and templates of main window
+ *
+ * Parser keeps state of the running conversion and belongs to the main
+ * thread. Calls from other threads are queued to it and block until done.
+ */
+class RenderService : public QObject, public IRenderService {
+  Q_OBJECT
+
+ public:
+    RenderService(Parser *pParser, const Templates *pTemplates,
+                  QObject *pParent = nullptr);
+
+    auto getTemplates() const -> const Templates* override;
+    auto getMacroDefinitions() const
+        -> QList<QPair<QString, QStringList>> override;
+    auto render(const QString &sRawText,
+                const QString &sFileName = QString()) -> QString override;
+    auto renderFragment(const QString &sFragment,
+                        const bool bWithStyle) -> QString override;
+
+ private:
+    Q_INVOKABLE QString renderLocal(const QString &sRawText,
+                                    const QString &sFileName);
+    Q_INVOKABLE QString renderFragmentLocal(const QString &sFragment,
+                                            const bool bWithStyle);
+
+    Parser *m_pParser;
+    const Templates *m_pTemplates;
+};
+
+#endif  // APPLICATION_RENDERSERVICE_H_
@@ -36,6 +36,8 @@
 #include <QUrl>
 #include <QUrlQuery>
 
+#include "./trace/trace.h"
+
 Session::Session(QWidget *pParent, const QString &sHash, QObject *pObj)
   : m_pParent(pParent),
     m_State(REQUTOKEN),
@@ -112,6 +114,7 @@ void Session::requestToken() {
 
   m_State = REQUTOKEN;
   QNetworkReply *pReply = m_pNwManager->get(request);
+  Trace::asyncReply(pReply, "network", "Request token");
   QEventLoop loop;
   connect(m_pNwManager, &QNetworkAccessManager::finished,
           &loop, &QEventLoop::quit);
@@ -238,6 +241,7 @@ void Session::requestLogin() {
 
   QNetworkReply *pReply = m_pNwManager->post(
                             request, params.query(QUrl::FullyEncoded).toUtf8());
+  Trace::asyncReply(pReply, "network", "Login");
   QEventLoop loop;
   connect(m_pNwManager, &QNetworkAccessManager::finished,
           &loop, &QEventLoop::quit);
@@ -97,6 +97,8 @@ void Settings::readSettings(const QString &sSharePath) {
   }
   m_LastOpenedDir.setPath(m_pSettings->value(QStringLiteral("LastOpenedDir"),
                                              sListPaths[0]).toString());
+  m_sLibraryDir = m_pSettings->value(QStringLiteral("LibraryDir"),
+                                     QString()).toString();
 
   m_bAutomaticImageDownload = m_pSettings->value(
                                 QStringLiteral("AutomaticImageDownload"),
@@ -272,6 +274,7 @@ void Settings::writeSettings(const QByteArray &WinGeometry,
 
   m_pSettings->setValue(QStringLiteral("LastOpenedDir"),
                         m_LastOpenedDir.absolutePath());
+  m_pSettings->setValue(QStringLiteral("LibraryDir"), m_sLibraryDir);
   m_pSettings->setValue(QStringLiteral("AutomaticImageDownload"),
                         m_bAutomaticImageDownload);
   m_pSettings->setValue(QStringLiteral("CheckLinks"), m_bCheckLinks);
@@ -420,6 +423,14 @@ void Settings::setLastOpenedDir(const QDir &LastDir) {
   m_LastOpenedDir = LastDir;
 }
 
+auto Settings::getLibraryDir() const -> QString {
+  return m_sLibraryDir;
+}
+
+void Settings::setLibraryDir(const QString &sLibraryDir) {
+  m_sLibraryDir = sLibraryDir;
+}
+
 auto Settings::getCheckLinks() const -> bool {
   return m_bCheckLinks;
 }
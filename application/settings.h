@@ -55,6 +55,7 @@ class Settings : public QObject {
                        const QByteArray &SplitterState = nullptr);
 
     void setLastOpenedDir(const QDir &LastDir);
+    void setLibraryDir(const QString &sLibraryDir);
 
     // General
     auto getGuiLanguage() const -> QString;
@@ -63,6 +64,7 @@ class Settings : public QObject {
     auto getAutomaticImageDownload() const -> bool;
     auto getPreviewHorizontal() const -> bool;
     auto getLastOpenedDir() const -> QDir;
+    auto getLibraryDir() const -> QString;
     auto getCheckLinks() const -> bool;
     auto getAutoSave() const -> quint32;
     auto getReloadPreviewKey() const -> qint32;
@@ -129,6 +131,7 @@ class Settings : public QObject {
     bool m_bSyntaxCheck{};
     bool m_bPreviewSplitHorizontal{};
     QDir m_LastOpenedDir;
+    QString m_sLibraryDir;
     bool m_bAutomaticImageDownload{};
     bool m_bCheckLinks{};
     quint32 m_nAutosave{};
@@ -0,0 +1,70 @@
+/**
+ * \file spellrenderservice.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Community data service of headless spell checking.
+ */
+
+#include "./spellrenderservice.h"
+
+#include <QDebug>
+
+#include "./templates/templates.h"
+
+SpellRenderService::SpellRenderService(const Templates *pTemplates)
+  : m_pTemplates(pTemplates) {
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto SpellRenderService::getTemplates() const -> const Templates* {
+  return m_pTemplates;
+}
+
+// ----------------------------------------------------------------------------
+
+auto SpellRenderService::getMacroDefinitions() const
+    -> QList<QPair<QString, QStringList>> {
+  return m_pTemplates->getMacroDefinitions();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto SpellRenderService::render(const QString &sRawText,
+                                const QString &sFileName) -> QString {
+  Q_UNUSED(sRawText)
+  Q_UNUSED(sFileName)
+  qWarning() << "Rendering not available for headless spell check";
+  return QString();
+}
+
+// ----------------------------------------------------------------------------
+
+auto SpellRenderService::renderFragment(const QString &sFragment,
+                                        const bool bWithStyle) -> QString {
+  Q_UNUSED(sFragment)
+  Q_UNUSED(bWithStyle)
+  qWarning() << "Rendering not available for headless spell check";
+  return QString();
+}
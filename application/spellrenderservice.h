@@ -0,0 +1,55 @@
+/**
+ * \file spellrenderservice.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for community data service of headless spell checking.
+ */
+
+#ifndef APPLICATION_SPELLRENDERSERVICE_H_
+#define APPLICATION_SPELLRENDERSERVICE_H_
+
+#include "./irenderservice.h"
+
+/**
+ * \class SpellRenderService
+ * \brief Community data for spell checker plugin without parser
+ *
+ * Template keywords are needed by the markup aware tokenizer of the plugin,
+ * rendering is not available (batch spell check, render server).
+ */
+class SpellRenderService : public IRenderService {
+ public:
+    explicit SpellRenderService(const Templates *pTemplates);
+
+    auto getTemplates() const -> const Templates* override;
+    auto getMacroDefinitions() const
+        -> QList<QPair<QString, QStringList>> override;
+    auto render(const QString &sRawText,
+                const QString &sFileName = QString()) -> QString override;
+    auto renderFragment(const QString &sFragment,
+                        const bool bWithStyle) -> QString override;
+
+ private:
+    const Templates *m_pTemplates;
+};
+
+#endif  // APPLICATION_SPELLRENDERSERVICE_H_
@@ -26,93 +26,213 @@
 
 #include "./syntaxcheck.h"
 
-#include <QMessageBox>
-#include <QRegularExpression>
-#include <QTextDocument>
+#include <algorithm>
 
-SyntaxCheck::SyntaxCheck(QObject *pParent) {
-  Q_UNUSED(pParent)
+SyntaxCheck::SyntaxCheck(const QStringList &sListTplMacros,
+                         const QStringList &sListSmilies,
+                         const QStringList &sListTplTrans)
+  : m_sListTplTrans(sListTplTrans) {
+  for (const auto &s : sListTplMacros) {
+    m_setTplMacros << s.toLower();
+  }
+  // Smilies are hiding parenthesis, e.g. :-)
+  for (const auto &s : sListSmilies) {
+    if (!s.isEmpty()) {
+      m_hashSmilies[s.at(0)] << s;
+    }
+  }
 }
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-auto SyntaxCheck::checkInyokaSyntax(
-    const QTextDocument *pRawDoc,
-    const QStringList &sListTplMacros,
-    const QStringList &sListSmilies,
-    const QStringList &sListTplTrans) -> QPair<int, QString> {
-  QPair<int, QString> ret(-1, QLatin1String(""));
-  ret = SyntaxCheck::checkParenthesis(pRawDoc, sListSmilies);
-  if (-1 == ret.first) {
-    ret = SyntaxCheck::checkKnownTemplates(pRawDoc, sListTplMacros,
-                                           sListTplTrans);
+auto SyntaxCheck::check(const QString &sDoc) const -> QList<SyntaxError> {
+  QList<SyntaxError> listErrors;
+  QList<SyntaxBracket> listStack;
+  int nState = 0;
+  int nStart = 0;
+  while (nStart <= sDoc.size()) {
+    int nEnd = sDoc.indexOf(QChar('\n'), nStart);
+    if (-1 == nEnd) {
+      nEnd = sDoc.size();
+    }
+    const SyntaxLine line(this->checkLine(sDoc.mid(nStart, nEnd - nStart),
+                                          nState));
+    SyntaxCheck::appendLine(line, nStart, &listStack, &listErrors);
+    nState = line.nEndState;
+    nStart = nEnd + 1;
   }
-
-  return ret;
+  SyntaxCheck::finish(nState, sDoc.size(), &listStack, &listErrors);
+  return listErrors;
 }
 
-// ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-auto SyntaxCheck::checkParenthesis(
-    const QTextDocument *pRawDoc,
-    const QStringList &sListSmilies) -> QPair<int, QString> {
-  QList<QChar> listParenthesis;
-  QList<qint32> listPos;
-  QString sDoc(pRawDoc->toPlainText());
-  QString sReplace(QLatin1String(""));
+auto SyntaxCheck::checkLine(const QString &sLine,
+                            const int nState) const -> SyntaxLine {
+  SyntaxLine ret;
+  ret.nEndState = nState;
 
-  // Replace smilies, since most of them are including open parenthesis
-  for (const auto &s : sListSmilies) {
-    sDoc = sDoc.replace(s, sReplace.fill('X', s.length()));
+  // Comments are removed by parser before everything else
+  if (sLine.startsWith(QLatin1String("##"))) {
+    return ret;
   }
-  // Replace left/right text alignment in tables
-  sDoc = sDoc.replace(QLatin1String("<(>"), sReplace.fill('X', 3));
-  sDoc = sDoc.replace(QLatin1String("<)>"), sReplace.fill('X', 3));
-
-  SyntaxCheck::filterMonotype(sDoc);
-
-  listParenthesis.clear();
-  QPair<int, QString> ret(-1, QLatin1String(""));
-  qint32 nCnt(-1);
-  for (const auto c : qAsConst(sDoc)) {
-    nCnt++;
-    if ('(' == c || '{' == c || '[' == c) {
-      listParenthesis.push_back(c);
-      listPos.push_back(nCnt);
-    } else if (')' == c || '}' == c || ']' == c) {
-      if (listParenthesis.isEmpty() ||
-          !SyntaxCheck::checkParenthesisPair(listParenthesis.last(), c)) {
-        ret.first = nCnt;
-        ret.second = QStringLiteral("OPEN_PAR_MISSING");
-        return ret;
+
+  if (0 != (nState & STATE_ROW) && sLine.trimmed().isEmpty()) {
+    SyntaxError error{0, 0, QStringLiteral("TABLE_ROW_NOT_CLOSED"),
+                      QString()};
+    ret.listErrors << error;
+    ret.nEndState &= ~STATE_ROW;
+    return ret;
+  }
+  const bool bRow = 0 == (nState & STATE_CODE) &&
+                    (0 != (nState & STATE_ROW) ||
+                     sLine.trimmed().startsWith(QLatin1String("||")));
+
+  const int nSize = sLine.size();
+  int i = 0;
+  while (i < nSize) {
+    // Content of code blocks is not checked
+    if (0 != (ret.nEndState & STATE_CODE)) {
+      const int nClose = sLine.indexOf(QLatin1String("}}}"), i);
+      if (-1 == nClose) {
+        break;
       }
-      listParenthesis.pop_back();
-      listPos.pop_back();
+      ret.listBrackets << SyntaxBracket{nClose, 3, QChar('}')};
+      ret.nEndState &= ~STATE_CODE;
+      i = nClose + 3;
+      continue;
     }
+
+    const QChar c(sLine.at(i));
+    if ('`' == c) {  // Monotype `` or `
+      const QString sMono(
+            SyntaxCheck::startsAt(sLine, i, QStringLiteral("``"))
+            ? QStringLiteral("``") : QStringLiteral("`"));
+      const int nClose = sLine.indexOf(sMono, i + sMono.size());
+      if (-1 != nClose) {
+        i = nClose + sMono.size();
+        continue;
+      }
+    } else if ('{' == c &&
+               SyntaxCheck::startsAt(sLine, i, QStringLiteral("{{{"))) {
+      ret.listBrackets << SyntaxBracket{i, 3, c};
+      // Content of parser templates is markup, everything else is code
+      if (!SyntaxCheck::startsAt(sLine, i + 3, QStringLiteral("#!")) ||
+          !this->checkTemplate(sLine, i, i + 5, true, &ret)) {
+        ret.nEndState |= STATE_CODE;
+      }
+      i += 3;
+      continue;
+    } else if ('}' == c &&
+               SyntaxCheck::startsAt(sLine, i, QStringLiteral("}}}"))) {
+      ret.listBrackets << SyntaxBracket{i, 3, c};
+      i += 3;
+      continue;
+    } else if ('[' == c &&
+               SyntaxCheck::startsAt(sLine, i, QStringLiteral("[["))) {
+      this->checkTemplate(sLine, i, i + 2, false, &ret);
+    } else if ('<' == c) {
+      // Left/right text alignment in tables
+      if (SyntaxCheck::startsAt(sLine, i, QStringLiteral("<(>")) ||
+          SyntaxCheck::startsAt(sLine, i, QStringLiteral("<)>"))) {
+        i += 3;
+        continue;
+      }
+      // Cell formating ||<...>
+      if (bRow && i >= 2 && '|' == sLine.at(i - 1) && '|' == sLine.at(i - 2)) {
+        const int nClose = sLine.indexOf(QChar('>'), i);
+        const int nCell = sLine.indexOf(QLatin1String("||"), i);
+        if (-1 == nClose || (-1 != nCell && nCell < nClose)) {
+          SyntaxError error{i, 1, QStringLiteral("TABLE_FORMAT_NOT_CLOSED"),
+                            QString()};
+          ret.listErrors << error;
+        } else {
+          i = nClose + 1;
+          continue;
+        }
+      }
+    }
+
+    bool bSmiley = false;
+    const QStringList sListSmilies(m_hashSmilies.value(c));
+    for (const auto &s : sListSmilies) {
+      if (SyntaxCheck::startsAt(sLine, i, s)) {
+        i += s.size();
+        bSmiley = true;
+        break;
+      }
+    }
+    if (bSmiley) {
+      continue;
+    }
+
+    if ('(' == c || '[' == c || '{' == c ||
+        ')' == c || ']' == c || '}' == c) {
+      ret.listBrackets << SyntaxBracket{i, 1, c};
+    }
+    i++;
   }
 
-  if (!listParenthesis.isEmpty()) {
-    ret.first = listPos.last();
-    ret.second = QStringLiteral("CLOSE_PAR_MISSING");
-    return ret;
+  // Table row may be continued in following lines until closed with ||
+  if (bRow) {
+    if (sLine.trimmed().endsWith(QLatin1String("||"))) {
+      ret.nEndState &= ~STATE_ROW;
+    } else {
+      ret.nEndState |= STATE_ROW;
+    }
   }
   return ret;
 }
 
-// ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-auto SyntaxCheck::checkParenthesisPair(const QChar cLeft,
-                                       const QChar cRight) -> bool {
-  if ('[' == cLeft && ']' == cRight) {
-    return true;
-  }
-  if ('(' == cLeft && ')' == cRight) {
-    return true;
-  }
-  if ('{' == cLeft && '}' == cRight) {
+// Template name of [[Vorlage(Name, ...)]] or {{{#!vorlage Name
+auto SyntaxCheck::checkTemplate(const QString &sLine, const int nStart,
+                                const int nPos, const bool bBlock,
+                                SyntaxLine *pLine) const -> bool {
+  for (const auto &sTrans : m_sListTplTrans) {
+    if (!SyntaxCheck::startsAt(sLine, nPos, sTrans, Qt::CaseInsensitive)) {
+      continue;
+    }
+    int nName = nPos + sTrans.size();
+    int nEnd = -1;
+    if (bBlock) {
+      if (nName >= sLine.size() || ' ' != sLine.at(nName)) {
+        continue;
+      }
+      while (nName < sLine.size() && ' ' == sLine.at(nName)) {
+        nName++;
+      }
+      nEnd = sLine.indexOf(QChar(' '), nName);
+    } else {
+      while (nName < sLine.size() && sLine.at(nName).isSpace()) {
+        nName++;
+      }
+      if (nName >= sLine.size() || '(' != sLine.at(nName)) {
+        continue;
+      }
+      nName++;
+      nEnd = sLine.indexOf(QChar(','), nName);
+      const int nClose = sLine.indexOf(QChar(')'), nName);
+      if (-1 == nEnd || (-1 != nClose && nClose < nEnd)) {
+        nEnd = nClose;
+      }
+      if (-1 == nEnd) {  // Not closed; reported as missing parenthesis
+        return true;
+      }
+    }
+    if (-1 == nEnd) {
+      nEnd = sLine.size();
+    }
+
+    QString sName(sLine.mid(nName, nEnd - nName));
+    sName = sName.remove(',').trimmed();
+    if (!sName.isEmpty() && !m_setTplMacros.contains(sName.toLower())) {
+      SyntaxError error{nStart, nEnd - nStart,
+                        QStringLiteral("UNKNOWN_TPL"), sName};
+      pLine->listErrors << error;
+    }
     return true;
   }
   return false;
@@ -121,102 +241,97 @@ auto SyntaxCheck::checkParenthesisPair(const QChar cLeft,
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-auto SyntaxCheck::checkKnownTemplates(
-    const QTextDocument *pRawDoc,
-    const QStringList &sListTplMacros,
-    const QStringList &sListTplTrans) -> QPair<int, QString> {
-  QStringList sListTplRegExp;
-  QStringList sListTrans;
-  for (const auto &s : sListTplTrans) {
-    sListTplRegExp << "\\{\\{\\{#!" + s + " .+\\}\\}\\}"
-                   << "\\[\\[" + s + "\\s*\\(.+\\)\\]\\]";
-    sListTrans << s << s;
+void SyntaxCheck::appendLine(const SyntaxLine &line, const int nOffset,
+                             QList<SyntaxBracket> *pStack,
+                             QList<SyntaxError> *pErrors) {
+  for (const auto &lineError : line.listErrors) {
+    SyntaxError error(lineError);
+    error.nPos += nOffset;
+    pErrors->append(error);
   }
-  QString sDoc(pRawDoc->toPlainText());
-  SyntaxCheck::filterMonotype(sDoc);
-  QPair<int, QString> ret(-1, QLatin1String(""));
-
-  for (int i = 0; i < sListTplRegExp.size(); i++) {
-    QRegularExpression findTemplate(
-          sListTplRegExp[i],
-          QRegularExpression::InvertedGreedinessOption |
-          QRegularExpression::DotMatchesEverythingOption |
-          QRegularExpression::CaseInsensitiveOption);
-    QRegularExpressionMatchIterator it = findTemplate.globalMatch(sDoc);
-
-    while (it.hasNext()) {
-      QRegularExpressionMatch match = it.next();
-      QString sMacro = match.captured(0);
-      if (sMacro.startsWith("[[" + sListTrans[i],
-                            Qt::CaseInsensitive)) {
-        sMacro.remove("[[" + sListTrans[i], Qt::CaseInsensitive);
-        sMacro = sMacro.trimmed();
-        sMacro.remove(0, 1);  // Remove (
-        sMacro = sMacro.left(sMacro.indexOf(QLatin1String(","))).trimmed();
-        sMacro.remove(QStringLiteral(")]]"));  // Needed if no "," is used
-        sMacro = sMacro.trimmed();
-
-        if (sListTplMacros.contains(sMacro, Qt::CaseInsensitive)) {
-          sMacro.clear();
-        }
-      } else if (sMacro.startsWith("{{{#!" + sListTrans[i] + " ",
-                                   Qt::CaseInsensitive)) {
-        sMacro.remove("{{{#!" + sListTrans[i] + " ", Qt::CaseInsensitive);
-        sMacro = sMacro.trimmed();
-        if (-1 != sMacro.indexOf(QLatin1String(" ")) &&
-            -1 != sMacro.indexOf(QLatin1String("\n"))) {
-          if (sMacro.indexOf(QLatin1String(" ")) < sMacro.indexOf(
-                QLatin1String("\n"))) {
-            sMacro = sMacro.left(sMacro.indexOf(QLatin1String(" "))).trimmed();
-          } else {
-            sMacro = sMacro.left(sMacro.indexOf(QLatin1String("\n"))).trimmed();
-          }
-        } else {
-          sMacro = sMacro.left(sMacro.indexOf(QLatin1String("\n"))).trimmed();
-        }
 
-        sMacro = sMacro.remove(',');
-        sMacro = sMacro.trimmed();
+  for (const auto &lineBracket : line.listBrackets) {
+    SyntaxBracket bracket(lineBracket);
+    bracket.nPos += nOffset;
+    if ('(' == bracket.c || '[' == bracket.c || '{' == bracket.c) {
+      pStack->append(bracket);
+      continue;
+    }
 
-        if (sListTplMacros.contains(sMacro, Qt::CaseInsensitive)) {
-          sMacro.clear();
-        }
+    const QChar cOpen(')' == bracket.c ? '(' : (']' == bracket.c ? '[' : '{'));
+    // Search opening bracket; parenthesis are not matched across code
+    // block borders, which would report a correct block as not closed
+    int nMatch = -1;
+    for (int i = pStack->size() - 1; i >= 0; i--) {
+      const SyntaxBracket &open = pStack->at(i);
+      if (cOpen == open.c && bracket.nLength == open.nLength) {
+        nMatch = i;
+        break;
       }
-
-      if (!sMacro.isEmpty()) {
-        ret.first = match.capturedStart();
-        ret.second = QStringLiteral("UNKNOWN_TPL|") + sMacro;
+      if (3 == open.nLength) {
+        break;
       }
     }
+
+    if (-1 == nMatch) {
+      SyntaxError error{bracket.nPos, bracket.nLength,
+                        3 == bracket.nLength
+                        ? QStringLiteral("OPEN_BLOCK_MISSING")
+                        : QStringLiteral("OPEN_PAR_MISSING"), QString()};
+      pErrors->append(error);
+      continue;
+    }
+    while (pStack->size() > nMatch + 1) {
+      pErrors->append(SyntaxCheck::unclosed(pStack->takeLast()));
+    }
+    pStack->removeLast();
   }
+}
 
-  return ret;
+// ----------------------------------------------------------------------------
+
+void SyntaxCheck::finish(const int nState, const int nEnd,
+                         QList<SyntaxBracket> *pStack,
+                         QList<SyntaxError> *pErrors) {
+  if (0 != (nState & STATE_ROW)) {
+    SyntaxError error{nEnd, 0, QStringLiteral("TABLE_ROW_NOT_CLOSED"),
+                      QString()};
+    pErrors->append(error);
+  }
+  while (!pStack->isEmpty()) {
+    pErrors->append(SyntaxCheck::unclosed(pStack->takeLast()));
+  }
+  std::stable_sort(pErrors->begin(), pErrors->end(),
+                   [](const SyntaxError &e1, const SyntaxError &e2) {
+    return e1.nPos < e2.nPos;
+  });
+}
+
+// ----------------------------------------------------------------------------
+
+auto SyntaxCheck::unclosed(const SyntaxBracket &bracket) -> SyntaxError {
+  SyntaxError error{bracket.nPos, bracket.nLength,
+                    3 == bracket.nLength
+                    ? QStringLiteral("CLOSE_BLOCK_MISSING")
+                    : QStringLiteral("CLOSE_PAR_MISSING"), QString()};
+  return error;
 }
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-void SyntaxCheck::filterMonotype(QString &sDoc) {
-  QString sReplace(QLatin1String(""));
-  QStringList sListMonotype;
-  sListMonotype << QStringLiteral("``");
-  sListMonotype << QStringLiteral("`");
-  for (int i = 0; i < sListMonotype.size(); i++) {
-    int nStart = -1;
-    int nEnd = -1;
-    int nIndex = 0;
-    while (-1 != sDoc.indexOf(sListMonotype[i], nIndex)) {
-      if (-1 == nStart) {
-        nStart = sDoc.indexOf(sListMonotype[i], nIndex);
-        nIndex = nStart + sListMonotype[i].length();
-      } else {
-        nEnd = sDoc.indexOf(sListMonotype[i], nIndex);
-        sDoc.replace(nStart, nEnd - nStart + sListMonotype[i].length(),
-                     sReplace.fill('X',
-                                   nEnd - nStart + sListMonotype[i].length()));
-        nIndex = nEnd + sListMonotype[i].length();
-        nStart = -1;
-      }
+auto SyntaxCheck::startsAt(const QString &sLine, const int nPos,
+                           const QString &sSearch,
+                           const Qt::CaseSensitivity cs) -> bool {
+  if (nPos + sSearch.size() > sLine.size()) {
+    return false;
+  }
+  for (int i = 0; i < sSearch.size(); i++) {
+    if (sLine.at(nPos + i) != sSearch.at(i) &&
+        (Qt::CaseSensitive == cs ||
+         sLine.at(nPos + i).toLower() != sSearch.at(i).toLower())) {
+      return false;
     }
   }
+  return true;
 }
@@ -27,34 +27,81 @@
 #ifndef APPLICATION_SYNTAXCHECK_H_
 #define APPLICATION_SYNTAXCHECK_H_
 
-#include <QObject>
+#include <QChar>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
 
-class QTextDocument;
+// Error codes: OPEN_PAR_MISSING, CLOSE_PAR_MISSING, OPEN_BLOCK_MISSING,
+// CLOSE_BLOCK_MISSING, UNKNOWN_TPL (sArg: template name),
+// TABLE_ROW_NOT_CLOSED, TABLE_FORMAT_NOT_CLOSED
+struct SyntaxError {
+  int nPos;
+  int nLength;
+  QString sCode;
+  QString sArg;
+};
 
-class SyntaxCheck : public QObject {
-  Q_OBJECT
+// Parenthesis or code block ({{{ / }}}: nLength 3)
+struct SyntaxBracket {
+  int nPos;
+  int nLength;
+  QChar c;
+};
 
+// Result of one line, positions relative to start of line
+struct SyntaxLine {
+  int nEndState;
+  // Brackets, which are not closed within the line
+  QList<SyntaxBracket> listBrackets;
+  QList<SyntaxError> listErrors;
+};
+
+/**
+ * \class SyntaxCheck
+ * \brief Single linear scan reporting all syntax errors of an article
+ *
+ * Each line is scanned once; multi line constructs (code blocks, table
+ * rows) are carried in a state value. Brackets left open by a line are
+ * matched with the following lines afterwards.
+ */
+class SyntaxCheck {
  public:
-    explicit SyntaxCheck(QObject *pParent = nullptr);
+    SyntaxCheck(const QStringList &sListTplMacros,
+                const QStringList &sListSmilies,
+                const QStringList &sListTplTrans);
+
+    // All errors of raw text (comments included), sorted by position
+    auto check(const QString &sDoc) const -> QList<SyntaxError>;
 
-    static auto checkInyokaSyntax(
-        const QTextDocument *pRawDoc,
-        const QStringList &sListTplMacros,
-        const QStringList &sListSmilies,
-        const QStringList &sListTplTrans) -> QPair <int, QString>;
+    // Line state is 0 at start of document
+    auto checkLine(const QString &sLine,
+                   const int nState) const -> SyntaxLine;
+    static void appendLine(const SyntaxLine &line, const int nOffset,
+                           QList<SyntaxBracket> *pStack,
+                           QList<SyntaxError> *pErrors);
+    static void finish(const int nState, const int nEnd,
+                       QList<SyntaxBracket> *pStack,
+                       QList<SyntaxError> *pErrors);
+    // Token at position of line (optionally case insensitive)
+    static auto startsAt(const QString &sLine, const int nPos,
+                         const QString &sSearch,
+                         const Qt::CaseSensitivity cs =
+                         Qt::CaseSensitive) -> bool;
 
  private:
-    static auto checkParenthesis(
-        const QTextDocument *pRawDoc,
-        const QStringList &sListSmilies) -> QPair <int, QString>;
-    static auto checkParenthesisPair(const QChar cLeft,
-                                     const QChar cRight) -> bool;
-    static auto checkKnownTemplates(
-        const QTextDocument *pRawDoc,
-        const QStringList &sListTplMacros,
-        const QStringList &sListTplTrans) -> QPair <int, QString>;
-
-    static void filterMonotype(QString &sDoc);
+    enum STATE {STATE_CODE = 0x1, STATE_ROW = 0x2};
+
+    auto checkTemplate(const QString &sLine, const int nStart,
+                       const int nPos, const bool bBlock,
+                       SyntaxLine *pLine) const -> bool;
+    static auto unclosed(const SyntaxBracket &bracket) -> SyntaxError;
+
+    QSet<QString> m_setTplMacros;  // Lower case
+    QHash<QChar, QStringList> m_hashSmilies;  // First character -> smilies
+    QStringList m_sListTplTrans;
 };
 
 #endif  // APPLICATION_SYNTAXCHECK_H_
@@ -0,0 +1,111 @@
+/**
+ * \file syntaxpanel.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Show all syntax errors of current document, jump to error on click.
+ */
+
+#include "./syntaxpanel.h"
+
+#include <QDebug>
+#include <QHeaderView>
+#include <QTextBlock>
+#include <QTextDocument>
+#include <QTreeWidget>
+
+SyntaxPanel::SyntaxPanel(QWidget *pParent)
+  : QDockWidget(pParent),
+    m_pTree(new QTreeWidget(this)) {
+  this->setObjectName(QStringLiteral("SyntaxPanel"));
+  this->setWindowTitle(tr("Syntax errors"));
+
+  m_pTree->setColumnCount(2);
+  m_pTree->setHeaderLabels(QStringList() << tr("Line") << tr("Error"));
+  m_pTree->setRootIsDecorated(false);
+  m_pTree->header()->setStretchLastSection(true);
+  this->setWidget(m_pTree);
+
+  connect(m_pTree, &QTreeWidget::itemActivated,
+          this, &SyntaxPanel::activatedItem);
+  connect(m_pTree, &QTreeWidget::itemClicked,
+          this, &SyntaxPanel::activatedItem);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void SyntaxPanel::setErrors(const QList<SyntaxError> &listErrors,
+                            const QTextDocument *pDoc) {
+  m_pTree->clear();
+  for (const auto &error : listErrors) {
+    auto *pItem = new QTreeWidgetItem(m_pTree);
+    const QTextBlock block(pDoc->findBlock(error.nPos));
+    pItem->setText(0, QString::number(block.blockNumber() + 1));
+    pItem->setText(1, SyntaxPanel::getErrorText(error));
+    pItem->setData(0, Qt::UserRole, error.nPos);
+  }
+  m_pTree->resizeColumnToContents(0);
+
+  if (listErrors.isEmpty()) {
+    this->setWindowTitle(tr("Syntax errors"));
+  } else {
+    this->setWindowTitle(tr("Syntax errors") + " (" +
+                         QString::number(listErrors.size()) + ")");
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void SyntaxPanel::activatedItem(QTreeWidgetItem *pItem) {
+  if (nullptr != pItem) {
+    emit this->jumpToPosition(pItem->data(0, Qt::UserRole).toInt());
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto SyntaxPanel::getErrorText(const SyntaxError &error) -> QString {
+  if ("OPEN_PAR_MISSING" == error.sCode) {
+    return tr("Opening parenthesis missing!");
+  }
+  if ("CLOSE_PAR_MISSING" == error.sCode) {
+    return tr("Closing parenthesis missing!");
+  }
+  if ("OPEN_BLOCK_MISSING" == error.sCode) {
+    return tr("Code block or template not opened with {{{!");
+  }
+  if ("CLOSE_BLOCK_MISSING" == error.sCode) {
+    return tr("Code block or template not closed with }}}!");
+  }
+  if ("UNKNOWN_TPL" == error.sCode) {
+    return tr("Unknown template:") + " " + error.sArg;
+  }
+  if ("TABLE_ROW_NOT_CLOSED" == error.sCode) {
+    return tr("Table row not closed with ||!");
+  }
+  if ("TABLE_FORMAT_NOT_CLOSED" == error.sCode) {
+    return tr("Table cell formating not closed with >!");
+  }
+  qWarning() << "Unknown syntax error code: " + error.sCode;
+  return tr("Syntax error");
+}
@@ -0,0 +1,63 @@
+/**
+ * \file syntaxpanel.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for syntax error panel.
+ */
+
+#ifndef APPLICATION_SYNTAXPANEL_H_
+#define APPLICATION_SYNTAXPANEL_H_
+
+#include <QDockWidget>
+#include <QList>
+
+#include "./syntaxcheck.h"
+
+class QTextDocument;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/**
+ * \class SyntaxPanel
+ * \brief List of all syntax errors of current document
+ */
+class SyntaxPanel : public QDockWidget {
+  Q_OBJECT
+
+ public:
+    explicit SyntaxPanel(QWidget *pParent = nullptr);
+
+    void setErrors(const QList<SyntaxError> &listErrors,
+                   const QTextDocument *pDoc);
+    static auto getErrorText(const SyntaxError &error) -> QString;
+
+ signals:
+    void jumpToPosition(const int nPos);
+
+ private slots:
+    void activatedItem(QTreeWidgetItem *pItem);
+
+ private:
+    QTreeWidget *m_pTree;
+};
+
+#endif  // APPLICATION_SYNTAXPANEL_H_
@@ -27,13 +27,60 @@
 #include "./templates.h"
 
 #include <QApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QMessageBox>
+#include <QSaveFile>
 #include <QSettings>
+#include <QThread>
 
 Templates::Templates(const QString &sCommunity, const QString &sSharePath,
-                     const QString &sUserDataDir) {
+                     const QString &sUserDataDir)
+  : m_bSourceError(false) {
+  // Parsed community data is cached; sources are only read after a change
+  const QString sSnapshot(sUserDataDir + "/snapshot_" + sCommunity + ".dat");
+  const QByteArray baStamp(Templates::getSourceStamp(sCommunity, sSharePath,
+                                                     sUserDataDir));
+  if (this->loadSnapshot(sSnapshot, baStamp)) {
+    qDebug() << "Loaded community snapshot:" << sSnapshot;
+    return;
+  }
+
+  this->readSources(sCommunity, sSharePath, sUserDataDir);
+  if (!m_bSourceError) {
+    this->saveSnapshot(sSnapshot, baStamp);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+// Message boxes only in main thread, otherwise shown by showErrors()
+void Templates::reportError(const QString &sMessage) {
+  m_bSourceError = true;
+  if (QThread::currentThread() == qApp->thread()) {
+    QMessageBox::warning(nullptr, QStringLiteral("Warning"), sMessage);
+  } else {
+    m_sListErrors << sMessage;
+  }
+}
+
+void Templates::showErrors() {
+  for (const auto &sMessage : qAsConst(m_sListErrors)) {
+    QMessageBox::warning(nullptr, QStringLiteral("Warning"), sMessage);
+  }
+  m_sListErrors.clear();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void Templates::readSources(const QString &sCommunity,
+                            const QString &sSharePath,
+                            const QString &sUserDataDir) {
   QString sPath(sSharePath + "/community/" + sCommunity);
   this->initTemplates(sPath + "/templates");
   this->initHtmlTpl(sPath + "/Preview.tpl");
@@ -78,6 +125,129 @@ Templates::Templates(const QString &sCommunity, const QString &sSharePath,
                             m_sListTestedWithTouch,
                             m_sListTestedWithTouchStrings);
   }
+
+  this->initMacroDefinitions();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+// Size and modification time of all sources (and built-in macros.conf)
+auto Templates::getSourceStamp(const QString &sCommunity,
+                               const QString &sSharePath,
+                               const QString &sUserDataDir) -> QByteArray {
+  const QString sPath(sSharePath + "/community/" + sCommunity);
+  const QString sUserPath(sUserDataDir + "/community/" + sCommunity);
+  QFileInfoList fiListSources(QDir(sPath + "/templates").entryInfoList(
+                                QDir::NoDotAndDotDot | QDir::Files,
+                                QDir::Name));
+  fiListSources << QFileInfo(sPath + "/Preview.tpl")
+                << QFileInfo(sPath + "/linkmap/linkmap.csv")
+                << QFileInfo(sPath + "/flagmap/flagmap.csv")
+                << QFileInfo(sPath + "/SmileysMap.csv")
+                << QFileInfo(sPath + "/Textformats.conf")
+                << QFileInfo(sUserPath + "/templates/TestedWith.conf")
+                << QFileInfo(sUserPath + "/templates/TestedWithTouch.conf");
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  for (const auto &fi : qAsConst(fiListSources)) {
+    hash.addData(fi.absoluteFilePath().toUtf8());
+    if (fi.exists()) {
+      hash.addData(QByteArray::number(fi.size()) + ":" +
+                   QByteArray::number(fi.lastModified().toMSecsSinceEpoch()));
+    } else {
+      hash.addData(QByteArrayLiteral("-"));
+    }
+  }
+  QFile fiMacros(QStringLiteral(":/macros.conf"));
+  if (fiMacros.open(QIODevice::ReadOnly)) {
+    hash.addData(fiMacros.readAll());
+    fiMacros.close();
+  }
+  return hash.result();
+}
+
+// ----------------------------------------------------------------------------
+
+auto Templates::getDataLists() -> QList<QStringList *> {
+  return QList<QStringList *>()
+      << &m_sListTplNamesINY << &m_sListTemplatesINY << &m_sListTplMacrosINY
+      << &m_sListTplNamesALL << &m_sListTplMacrosALL
+      << &m_sListFormatStart << &m_sListFormatEnd
+      << &m_sListFormatHtmlStart << &m_sListFormatHtmlEnd
+      << &m_sListIWLs << &m_sListIWLUrls
+      << &m_sListFlags << &m_sListFlagsImg
+      << &m_sListSmilies << &m_sListSmiliesImg
+      << &m_sListTestedWith << &m_sListTestedWithStrings
+      << &m_sListTestedWithTouch << &m_sListTestedWithTouchStrings;
+}
+
+// ----------------------------------------------------------------------------
+
+auto Templates::loadSnapshot(const QString &sSnapshot,
+                             const QByteArray &baStamp) -> bool {
+  QFile snapshotFile(sSnapshot);
+  if (!snapshotFile.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  const QByteArray baData(snapshotFile.readAll());  // Single read
+  snapshotFile.close();
+
+  QDataStream in(baData);
+  in.setVersion(QDataStream::Qt_5_9);
+  quint32 nMagic = 0;
+  quint32 nVersion = 0;
+  QByteArray baSnapshotStamp;
+  in >> nMagic >> nVersion >> baSnapshotStamp;
+  if (nMagic != m_cSNAPSHOTMAGIC || nVersion != m_cSNAPSHOTVERSION ||
+      baSnapshotStamp != baStamp) {
+    qDebug() << "Community files changed, reading sources";
+    return false;
+  }
+
+  QString sPreviewTemplate;
+  QList<QStringList> listData;
+  QList<QPair<QString, QStringList>> listMacros;
+  in >> sPreviewTemplate >> listData >> listMacros;
+  QList<QStringList *> listMembers(this->getDataLists());
+  if (in.status() != QDataStream::Ok ||
+      listData.size() != listMembers.size()) {
+    qWarning() << "Invalid community snapshot:" << sSnapshot;
+    return false;
+  }
+
+  m_sPreviewTemplate = sPreviewTemplate;
+  for (int i = 0; i < listMembers.size(); i++) {
+    *listMembers[i] = listData.at(i);
+  }
+  m_listMacroDefinitions = listMacros;
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void Templates::saveSnapshot(const QString &sSnapshot,
+                             const QByteArray &baStamp) {
+  QList<QStringList> listData;
+  const QList<QStringList *> listMembers(this->getDataLists());
+  for (const auto *pList : listMembers) {
+    listData << *pList;
+  }
+
+  QDir().mkpath(QFileInfo(sSnapshot).absolutePath());
+  // App and plugins may write at the same time, file is replaced atomically
+  QSaveFile snapshotFile(sSnapshot);
+  if (!snapshotFile.open(QIODevice::WriteOnly)) {
+    qWarning() << "Could not write community snapshot:" << sSnapshot;
+    return;
+  }
+  QDataStream out(&snapshotFile);
+  out.setVersion(QDataStream::Qt_5_9);
+  out << m_cSNAPSHOTMAGIC << m_cSNAPSHOTVERSION << baStamp
+      << m_sPreviewTemplate << listData << m_listMacroDefinitions;
+  if (!snapshotFile.commit()) {
+    qWarning() << "Could not write community snapshot:" << sSnapshot;
+  }
 }
 
 // ----------------------------------------------------------------------------
@@ -131,9 +301,8 @@ void Templates::initTemplates(const QString &sTplPath) {
         }
         TplFile.close();
       } else {
-        QMessageBox::warning(nullptr, QStringLiteral("Warning"),
-                             "Could not open template file: \n" +
-                             fi.absoluteFilePath());
+        this->reportError("Could not open template file: \n" +
+                          fi.absoluteFilePath());
         qWarning() << "Could not open template file:"
                    << fi.absoluteFilePath();
       }
@@ -153,9 +322,8 @@ void Templates::initTemplates(const QString &sTplPath) {
         }
         TplFile.close();
       } else {
-        QMessageBox::warning(nullptr, QStringLiteral("Warning"),
-                             "Could not open macro file: \n" +
-                             fi.absoluteFilePath());
+        this->reportError("Could not open macro file: \n" +
+                          fi.absoluteFilePath());
         qWarning() << "Could not open macro file:"
                    << fi.absoluteFilePath();
       }
@@ -166,8 +334,7 @@ void Templates::initTemplates(const QString &sTplPath) {
   m_sListTplNamesALL.append(m_sListTplNamesINY);
 
   if (m_sListTplNamesINY.isEmpty()) {
-    QMessageBox::warning(
-          nullptr, QStringLiteral("Warning"),
+    this->reportError(
           QStringLiteral("Could not find any markup template files!"));
     qWarning() << "Could not find any template files in:"
                << TplDir.absolutePath();
@@ -182,8 +349,7 @@ void Templates::initTemplates(const QString &sTplPath) {
 void Templates::initHtmlTpl(const QString &sTplFile) {
   QFile HTMLTplFile(sTplFile);
   if (!HTMLTplFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-    QMessageBox::warning(
-          nullptr, QStringLiteral("Warning"),
+    this->reportError(
           QStringLiteral("Could not open preview template file!"));
     qWarning() << "Could not open preview template file:"
                << HTMLTplFile.fileName();
@@ -209,9 +375,7 @@ void Templates::initMappings(const QString &sFileName,
                              QStringList &sListMapping) {
   QFile MapFile(sFileName);
   if (!MapFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-    QMessageBox::warning(
-          nullptr, QStringLiteral("Warning"),
-          QStringLiteral("Could not open mapping file!"));
+    this->reportError(QStringLiteral("Could not open mapping file!"));
     qWarning() << "Could not open mapping config file:"
                << MapFile.fileName();
     sListElements << QStringLiteral("ERROR");
@@ -245,14 +409,46 @@ void Templates::initMappings(const QString &sFileName,
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
+// Built-in macro names and translations, used by parser and highlighter
+void Templates::initMacroDefinitions() {
+  QFile fiMacros(QStringLiteral(":/macros.conf"));
+  if (!fiMacros.open(QIODevice::ReadOnly)) {
+    qWarning() << "Could not open macros.conf";
+    this->reportError(QStringLiteral("Could not open macros.conf"));
+    return;
+  }
+
+  QTextStream in(&fiMacros);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+  // Since Qt 6 UTF-8 is used by default
+  in.setCodec("UTF-8");
+#endif
+  QString tmpLine;
+  while (!in.atEnd()) {
+    tmpLine = in.readLine().trimmed();
+    const QStringList tmpList(tmpLine.split(QStringLiteral("=")));
+    if (!tmpLine.isEmpty() && 2 == tmpList.size()) {
+      QStringList sListTranslations;
+      const QStringList tmpList2(tmpList[1].split(QStringLiteral(",")));
+      for (const auto &s : tmpList2) {
+        sListTranslations << s.trimmed();
+      }
+      m_listMacroDefinitions << qMakePair(tmpList[0].trimmed(),
+                                          sListTranslations);
+    }
+  }
+  fiMacros.close();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
 void Templates::initTextformats(const QString &sFilename) {
   QFile formatsFile(sFilename);
   QStringList sListInput;
 
   if (!formatsFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-    QMessageBox::warning(
-          nullptr, QStringLiteral("Warning"),
-          QStringLiteral("Could not open text formats file!"));
+    this->reportError(QStringLiteral("Could not open text formats file!"));
     qWarning() << "Could not open text formats config file:"
                << formatsFile.fileName();
     // Initialize possible text formats
@@ -358,3 +554,38 @@ auto Templates::getListTestedWithTouch() const -> QStringList {
 auto Templates::getListTestedWithTouchStrings() const -> QStringList {
   return m_sListTestedWithTouchStrings;
 }
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto Templates::getMacroDefinitions() const
+    -> QList<QPair<QString, QStringList>> {
+  return m_listMacroDefinitions;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto Templates::getVersion(const bool bWithTemplates) const -> QByteArray {
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(m_sPreviewTemplate.toUtf8());
+
+  QList<QStringList> listData;
+  listData << m_sListTplNamesINY << m_sListTplMacrosINY
+           << m_sListTplNamesALL << m_sListTplMacrosALL
+           << m_sListFormatStart << m_sListFormatEnd
+           << m_sListFormatHtmlStart << m_sListFormatHtmlEnd
+           << m_sListIWLs << m_sListIWLUrls
+           << m_sListFlags << m_sListFlagsImg
+           << m_sListSmilies << m_sListSmiliesImg
+           << m_sListTestedWith << m_sListTestedWithStrings
+           << m_sListTestedWithTouch << m_sListTestedWithTouchStrings;
+  if (bWithTemplates) {
+    listData << m_sListTemplatesINY;
+  }
+  for (const auto &sList : qAsConst(listData)) {
+    hash.addData(sList.join(QChar('\n')).toUtf8());
+    hash.addData(QByteArrayLiteral("\x1f"));
+  }
+  return hash.result().toHex();
+}
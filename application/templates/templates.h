@@ -27,13 +27,25 @@
 #ifndef APPLICATION_TEMPLATES_TEMPLATES_H_
 #define APPLICATION_TEMPLATES_TEMPLATES_H_
 
+#include <QByteArray>
+#include <QList>
+#include <QPair>
 #include <QString>
 #include <QStringList>
 
+/**
+ * \class Templates
+ * \brief Community templates, mappings and text formats
+ *
+ * Parsed data is stored as versioned snapshot in user data folder and
+ * loaded from there as long as no source file changed.
+ */
 class Templates {
  public:
+    // Can be constructed in worker thread; call showErrors() afterwards
     Templates(const QString &sCommunity, const QString &sSharePath,
               const QString &sUserDataDir);
+    void showErrors();
 
     auto getPreviewTemplate() const -> QString;
     auto getListTplNamesINY() const -> QStringList;
@@ -59,14 +71,38 @@ class Templates {
     auto getListTestedWithTouch() const -> QStringList;
     auto getListTestedWithTouchStrings() const -> QStringList;
 
+    // Built-in macros.conf: Macro name, translations
+    auto getMacroDefinitions() const -> QList<QPair<QString, QStringList>>;
+
+    // Hash of all loaded data; template definitions (INY) only if requested
+    auto getVersion(const bool bWithTemplates) const -> QByteArray;
+
  private:
+    void readSources(const QString &sCommunity, const QString &sSharePath,
+                     const QString &sUserDataDir);
+    static auto getSourceStamp(const QString &sCommunity,
+                               const QString &sSharePath,
+                               const QString &sUserDataDir) -> QByteArray;
+    auto getDataLists() -> QList<QStringList *>;
+    auto loadSnapshot(const QString &sSnapshot,
+                      const QByteArray &baStamp) -> bool;
+    void saveSnapshot(const QString &sSnapshot, const QByteArray &baStamp);
+
     void initTemplates(const QString &sTplPath);
     void initHtmlTpl(const QString &sTplFile);
-    static void initMappings(const QString &sFileName,
-                             const QChar cSplit,
-                             QStringList &sListElements,
-                             QStringList &sListMapping);
+    void initMappings(const QString &sFileName,
+                      const QChar cSplit,
+                      QStringList &sListElements,
+                      QStringList &sListMapping);
     void initTextformats(const QString &sFileName);
+    void initMacroDefinitions();
+    void reportError(const QString &sMessage);
+
+    static const quint32 m_cSNAPSHOTMAGIC = 0x494E5954;  // "INYT"
+    static const quint32 m_cSNAPSHOTVERSION = 1;
+
+    bool m_bSourceError;
+    QStringList m_sListErrors;
 
     QString m_sPreviewTemplate;
     QStringList m_sListTplNamesINY;
@@ -94,6 +130,8 @@ class Templates {
     QStringList m_sListTestedWithStrings;
     QStringList m_sListTestedWithTouch;
     QStringList m_sListTestedWithTouchStrings;
+
+    QList<QPair<QString, QStringList>> m_listMacroDefinitions;
 };
 
 #endif  // APPLICATION_TEMPLATES_TEMPLATES_H_
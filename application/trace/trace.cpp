@@ -0,0 +1,276 @@
+/**
+ * \file trace.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Shared trace event ring buffer and Chrome trace event JSON export.
+ */
+
+#include "./trace.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+#include <QVariant>
+
+#include <atomic>
+#include <chrono>
+
+static const char *const sBUFFERPROPERTY = "InyokaEditTraceBuffer";
+static const quint64 nCAPACITY = 1 << 16;  // Events kept in ring buffer
+
+/**
+ * \struct TraceEvent
+ * \brief Ring buffer slot; nSeq is index + 1 once completely written
+ */
+struct TraceEvent {
+  std::atomic<quint64> nSeq{0};
+  char cPhase{};
+  const char *sCategory{};
+  const char *sName{};
+  qint64 nTimestamp{};
+  qint64 nDuration{};
+  quint64 nThread{};
+  quint64 nId{};
+  qint64 nValue{};
+};
+
+/**
+ * \struct TraceBuffer
+ * \brief Shared between application and plugins
+ */
+struct TraceBuffer {
+  std::atomic<bool> bEnabled{false};
+  std::atomic<quint64> nNext{0};
+  std::atomic<TraceEvent *> pEvents{nullptr};
+  qint64 nOrigin{};
+};
+
+static auto steadyNsecs() -> qint64 {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto Trace::buffer() -> TraceBuffer* {
+  // Cached per module (application and each plugin)
+  static std::atomic<TraceBuffer *> s_pBuffer(nullptr);
+  TraceBuffer *pBuffer = s_pBuffer.load(std::memory_order_acquire);
+  if (nullptr != pBuffer) {
+    return pBuffer;
+  }
+
+  static QMutex mutex;
+  QMutexLocker locker(&mutex);
+  pBuffer = s_pBuffer.load(std::memory_order_relaxed);
+  if (nullptr == pBuffer) {
+    QCoreApplication *pApp = QCoreApplication::instance();
+    if (nullptr != pApp) {
+      pBuffer = reinterpret_cast<TraceBuffer *>(static_cast<quintptr>(
+                  pApp->property(sBUFFERPROPERTY).toULongLong()));
+    }
+    if (nullptr == pBuffer) {
+      // Never deleted, plugins may still trace while shutting down
+      pBuffer = new TraceBuffer;
+      pBuffer->nOrigin = steadyNsecs();
+      if (nullptr != pApp) {
+        pApp->setProperty(sBUFFERPROPERTY, static_cast<qulonglong>(
+                            reinterpret_cast<quintptr>(pBuffer)));
+      }
+    }
+    s_pBuffer.store(pBuffer, std::memory_order_release);
+  }
+  return pBuffer;
+}
+
+// ----------------------------------------------------------------------------
+
+void Trace::setEnabled(const bool bEnabled) {
+  TraceBuffer *pBuffer = Trace::buffer();
+  if (bEnabled && nullptr == pBuffer->pEvents.load()) {
+    pBuffer->pEvents.store(new TraceEvent[nCAPACITY]);
+  }
+  pBuffer->bEnabled.store(bEnabled, std::memory_order_release);
+}
+
+auto Trace::isEnabled() -> bool {
+  return Trace::buffer()->bEnabled.load(std::memory_order_relaxed);
+}
+
+auto Trace::now() -> qint64 {
+  return steadyNsecs() - Trace::buffer()->nOrigin;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void Trace::complete(const char *sCategory, const char *sName,
+                     const qint64 nStart, const qint64 nDuration) {
+  Trace::record('X', sCategory, sName, nStart, nDuration, 0, 0);
+}
+
+void Trace::instant(const char *sCategory, const char *sName) {
+  Trace::record('i', sCategory, sName, Trace::now(), 0, 0, 0);
+}
+
+void Trace::counter(const char *sCategory, const char *sName,
+                    const qint64 nValue) {
+  Trace::record('C', sCategory, sName, Trace::now(), 0, 0, nValue);
+}
+
+void Trace::asyncBegin(const char *sCategory, const char *sName,
+                       const quint64 nId) {
+  Trace::record('b', sCategory, sName, Trace::now(), 0, nId, 0);
+}
+
+void Trace::asyncEnd(const char *sCategory, const char *sName,
+                     const quint64 nId) {
+  Trace::record('e', sCategory, sName, Trace::now(), 0, nId, 0);
+}
+
+// ----------------------------------------------------------------------------
+
+void Trace::record(const char cPhase, const char *sCategory,
+                   const char *sName, const qint64 nTimestamp,
+                   const qint64 nDuration, const quint64 nId,
+                   const qint64 nValue) {
+  TraceBuffer *pBuffer = Trace::buffer();
+  if (!pBuffer->bEnabled.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  // Claim slot; oldest events are overwritten
+  const quint64 nIndex = pBuffer->nNext.fetch_add(1,
+                                                  std::memory_order_relaxed);
+  TraceEvent &event = pBuffer->pEvents.load(
+                        std::memory_order_acquire)[nIndex % nCAPACITY];
+  event.nSeq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  event.cPhase = cPhase;
+  event.sCategory = sCategory;
+  event.sName = sName;
+  event.nTimestamp = nTimestamp;
+  event.nDuration = nDuration;
+  event.nThread = reinterpret_cast<quintptr>(QThread::currentThreadId());
+  event.nId = nId;
+  event.nValue = nValue;
+  event.nSeq.store(nIndex + 1, std::memory_order_release);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto Trace::toJson() -> QByteArray {
+  TraceBuffer *pBuffer = Trace::buffer();
+  const TraceEvent *pEvents = pBuffer->pEvents.load(std::memory_order_acquire);
+  const qint64 nPid = QCoreApplication::applicationPid();
+  QJsonArray events;
+
+  // Name of exporting (GUI) thread
+  QJsonObject threadName;
+  threadName.insert(QStringLiteral("name"), QStringLiteral("thread_name"));
+  threadName.insert(QStringLiteral("ph"), QStringLiteral("M"));
+  threadName.insert(QStringLiteral("pid"), nPid);
+  threadName.insert(QStringLiteral("tid"), static_cast<qint64>(
+                      reinterpret_cast<quintptr>(QThread::currentThreadId())));
+  QJsonObject threadArgs;
+  threadArgs.insert(QStringLiteral("name"), QStringLiteral("GUI"));
+  threadName.insert(QStringLiteral("args"), threadArgs);
+  events << threadName;
+
+  const quint64 nEnd = pBuffer->nNext.load(std::memory_order_acquire);
+  const quint64 nBegin = nEnd > nCAPACITY ? nEnd - nCAPACITY : 0;
+  for (quint64 i = nBegin; nullptr != pEvents && i < nEnd; i++) {
+    const TraceEvent &slot = pEvents[i % nCAPACITY];
+    if (slot.nSeq.load(std::memory_order_acquire) != i + 1) {
+      continue;  // Still written or already overwritten
+    }
+    const char cPhase = slot.cPhase;
+    const char *sCategory = slot.sCategory;
+    const char *sName = slot.sName;
+    const qint64 nTimestamp = slot.nTimestamp;
+    const qint64 nDuration = slot.nDuration;
+    const quint64 nThread = slot.nThread;
+    const quint64 nId = slot.nId;
+    const qint64 nValue = slot.nValue;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.nSeq.load(std::memory_order_relaxed) != i + 1) {
+      continue;
+    }
+
+    QJsonObject event;
+    event.insert(QStringLiteral("name"), QString::fromLatin1(sName));
+    event.insert(QStringLiteral("cat"), QString::fromLatin1(sCategory));
+    event.insert(QStringLiteral("ph"), QString(QLatin1Char(cPhase)));
+    event.insert(QStringLiteral("ts"), nTimestamp / 1000.0);  // usecs
+    event.insert(QStringLiteral("pid"), nPid);
+    event.insert(QStringLiteral("tid"), static_cast<qint64>(nThread));
+    switch (cPhase) {
+      case 'X':
+        event.insert(QStringLiteral("dur"), nDuration / 1000.0);
+        break;
+      case 'C': {
+        QJsonObject args;
+        args.insert(QStringLiteral("value"), nValue);
+        event.insert(QStringLiteral("args"), args);
+        break;
+      }
+      case 'b':
+      case 'e':
+        event.insert(QStringLiteral("id"),
+                     "0x" + QString::number(nId, 16));
+        break;
+      case 'i':
+        event.insert(QStringLiteral("s"), QStringLiteral("t"));
+        break;
+      default:
+        break;
+    }
+    events << event;
+  }
+
+  QJsonObject root;
+  root.insert(QStringLiteral("traceEvents"), events);
+  root.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ms"));
+  return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+// ----------------------------------------------------------------------------
+
+auto Trace::save(const QString &sFile) -> bool {
+  QFile file(sFile);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qWarning() << "Could not write trace file:" << sFile
+               << file.errorString();
+    return false;
+  }
+  file.write(Trace::toJson());
+  file.close();
+  qDebug() << "Trace saved:" << sFile;
+  return true;
+}
@@ -0,0 +1,115 @@
+/**
+ * \file trace.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Lock-free ring buffer for trace events (spans, counters, async requests),
+ * exported as Chrome trace event JSON (chrome://tracing, ui.perfetto.dev).
+ *
+ * Application and plugins share one buffer, which is registered as property
+ * of the application object. If tracing is disabled, each call only costs
+ * an atomic load.
+ */
+
+#ifndef APPLICATION_TRACE_TRACE_H_
+#define APPLICATION_TRACE_TRACE_H_
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+struct TraceBuffer;
+
+/**
+ * \class Trace
+ * \brief Record trace events of all modules into one shared ring buffer
+ */
+class Trace {
+ public:
+    static void setEnabled(const bool bEnabled);
+    static auto isEnabled() -> bool;
+
+    // Nanoseconds since start of tracing (monotonic)
+    static auto now() -> qint64;
+
+    // Category and name have to be string literals (not copied)
+    static void complete(const char *sCategory, const char *sName,
+                         const qint64 nStart, const qint64 nDuration);
+    static void instant(const char *sCategory, const char *sName);
+    static void counter(const char *sCategory, const char *sName,
+                        const qint64 nValue);
+    static void asyncBegin(const char *sCategory, const char *sName,
+                           const quint64 nId);
+    static void asyncEnd(const char *sCategory, const char *sName,
+                         const quint64 nId);
+
+    // Async span from request until reply emits finished()
+    template <typename T>
+    static void asyncReply(T *pReply, const char *sCategory,
+                           const char *sName) {
+      if (nullptr == pReply || !Trace::isEnabled()) {
+        return;
+      }
+      const auto nId = reinterpret_cast<quintptr>(pReply);
+      Trace::asyncBegin(sCategory, sName, nId);
+      QObject::connect(pReply, &T::finished, [sCategory, sName, nId]() {
+        Trace::asyncEnd(sCategory, sName, nId);
+      });
+    }
+
+    static auto toJson() -> QByteArray;
+    static auto save(const QString &sFile) -> bool;
+
+ private:
+    static void record(const char cPhase, const char *sCategory,
+                       const char *sName, const qint64 nTimestamp,
+                       const qint64 nDuration, const quint64 nId,
+                       const qint64 nValue);
+    static auto buffer() -> TraceBuffer*;
+};
+
+/**
+ * \class TraceSpan
+ * \brief Scoped span, recorded as complete event when leaving the scope
+ */
+class TraceSpan {
+ public:
+    TraceSpan(const char *sCategory, const char *sName)
+      : m_sCategory(sCategory),
+        m_sName(sName),
+        m_nStart(Trace::isEnabled() ? Trace::now() : -1) {
+    }
+    ~TraceSpan() {
+      if (m_nStart >= 0) {
+        Trace::complete(m_sCategory, m_sName, m_nStart,
+                        Trace::now() - m_nStart);
+      }
+    }
+    TraceSpan(const TraceSpan &) = delete;
+    auto operator=(const TraceSpan &) -> TraceSpan& = delete;
+
+ private:
+    const char *m_sCategory;
+    const char *m_sName;
+    const qint64 m_nStart;
+};
+
+#endif  // APPLICATION_TRACE_TRACE_H_
@@ -0,0 +1,201 @@
+/**
+ * \file trigramindex.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * \section DESCRIPTION
+ * Store and query trigrams of article files for search in files.
+ */
+
+#include "./trigramindex.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <algorithm>
+
+TrigramIndex::TrigramIndex(const QString &sIndexFile)
+  : m_sIndexFile(sIndexFile),
+    m_bChanged(false) {
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto TrigramIndex::load() -> bool {
+  m_hashEntries.clear();
+  m_bChanged = false;
+  QFile indexFile(m_sIndexFile);
+  if (m_sIndexFile.isEmpty() || !indexFile.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  QDataStream in(&indexFile);
+  in.setVersion(QDataStream::Qt_5_9);
+  quint32 nMagic = 0;
+  quint32 nVersion = 0;
+  quint32 nCount = 0;
+  in >> nMagic >> nVersion >> nCount;
+  if (nMagic != m_cMAGIC || nVersion != m_cVERSION) {
+    return false;  // Outdated, will be overwritten by next save()
+  }
+
+  m_hashEntries.reserve(static_cast<int>(nCount));
+  for (quint32 i = 0; i < nCount && in.status() == QDataStream::Ok; i++) {
+    QString sFile;
+    TrigramEntry entry;
+    in >> sFile >> entry.nModified >> entry.nSize >> entry.listTrigrams;
+    m_hashEntries.insert(sFile, entry);
+  }
+  if (in.status() != QDataStream::Ok) {
+    qWarning() << "Corrupt search index:" << m_sIndexFile;
+    m_hashEntries.clear();
+    return false;
+  }
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+auto TrigramIndex::save() -> bool {
+  if (!m_bChanged || m_sIndexFile.isEmpty()) {
+    return true;
+  }
+  QDir dir;
+  if (!dir.mkpath(QFileInfo(m_sIndexFile).absolutePath())) {
+    qWarning() << "Could not create search index folder:" << m_sIndexFile;
+    return false;
+  }
+
+  QSaveFile indexFile(m_sIndexFile);
+  if (!indexFile.open(QIODevice::WriteOnly)) {
+    qWarning() << "Could not write search index:" << m_sIndexFile;
+    return false;
+  }
+  QDataStream out(&indexFile);
+  out.setVersion(QDataStream::Qt_5_9);
+  out << m_cMAGIC << m_cVERSION
+      << static_cast<quint32>(m_hashEntries.size());
+  for (auto it = m_hashEntries.constBegin();
+       it != m_hashEntries.constEnd(); ++it) {
+    out << it.key() << it.value().nModified << it.value().nSize
+        << it.value().listTrigrams;
+  }
+  if (!indexFile.commit()) {
+    qWarning() << "Could not write search index:" << m_sIndexFile;
+    return false;
+  }
+  m_bChanged = false;
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto TrigramIndex::isUpToDate(const QFileInfo &fi) const -> bool {
+  const auto it = m_hashEntries.constFind(fi.absoluteFilePath());
+  return it != m_hashEntries.constEnd() &&
+      it.value().nSize == fi.size() &&
+      it.value().nModified == fi.lastModified().toMSecsSinceEpoch();
+}
+
+// ----------------------------------------------------------------------------
+
+auto TrigramIndex::mayContain(
+    const QString &sFile, const QVector<quint32> &listQuery) const -> bool {
+  const auto it = m_hashEntries.constFind(sFile);
+  if (it == m_hashEntries.constEnd()) {
+    return true;  // Unknown, has to be searched
+  }
+  const QVector<quint32> &listTrigrams = it.value().listTrigrams;
+  return std::includes(listTrigrams.constBegin(), listTrigrams.constEnd(),
+                       listQuery.constBegin(), listQuery.constEnd());
+}
+
+// ----------------------------------------------------------------------------
+
+void TrigramIndex::update(const QString &sFile, const TrigramEntry &entry) {
+  m_hashEntries.insert(sFile, entry);
+  m_bChanged = true;
+}
+
+// ----------------------------------------------------------------------------
+
+void TrigramIndex::remove(const QString &sFile) {
+  if (m_hashEntries.remove(sFile) > 0) {
+    m_bChanged = true;
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void TrigramIndex::removeMissing(const QSet<QString> &setFiles) {
+  for (auto it = m_hashEntries.begin(); it != m_hashEntries.end(); ) {
+    if (setFiles.contains(it.key())) {
+      ++it;
+    } else {
+      it = m_hashEntries.erase(it);
+      m_bChanged = true;
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto TrigramIndex::createEntry(const QFileInfo &fi,
+                               const QString &sText) -> TrigramEntry {
+  TrigramEntry entry;
+  entry.nModified = fi.lastModified().toMSecsSinceEpoch();
+  entry.nSize = fi.size();
+  entry.listTrigrams = TrigramIndex::trigrams(sText);
+  return entry;
+}
+
+// ----------------------------------------------------------------------------
+
+// Three UTF-16 code units of lower case text; collisions of characters
+// above U+03FF only lead to additional files being searched
+auto TrigramIndex::trigrams(const QString &sText) -> QVector<quint32> {
+  QVector<quint32> listTrigrams;
+  const QString sLower(sText.toLower());
+  if (sLower.size() < 3) {
+    return listTrigrams;
+  }
+
+  listTrigrams.reserve(static_cast<int>(sLower.size()) - 2);
+  quint32 nTrigram = (static_cast<quint32>(sLower.at(0).unicode()) << 10) ^
+                     sLower.at(1).unicode();
+  for (int i = 2; i < sLower.size(); i++) {
+    nTrigram = ((nTrigram << 10) ^ sLower.at(i).unicode()) & 0x3FFFFFFF;
+    listTrigrams << nTrigram;
+  }
+  std::sort(listTrigrams.begin(), listTrigrams.end());
+  listTrigrams.erase(std::unique(listTrigrams.begin(), listTrigrams.end()),
+                     listTrigrams.end());
+  listTrigrams.squeeze();
+  return listTrigrams;
+}
@@ -0,0 +1,79 @@
+/**
+ * \file trigramindex.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ *
+ * \section DESCRIPTION
+ * Class definition for trigram index of article files.
+ */
+
+#ifndef APPLICATION_TRIGRAMINDEX_H_
+#define APPLICATION_TRIGRAMINDEX_H_
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+class QFileInfo;
+
+struct TrigramEntry {
+  qint64 nModified = -1;  // Msecs since epoch
+  qint64 nSize = -1;
+  QVector<quint32> listTrigrams;  // Sorted, without duplicates
+};
+
+/**
+ * \class TrigramIndex
+ * \brief Trigrams of lower case text of each file in a folder
+ *
+ * A file can only contain a search term, if it contains all trigrams of
+ * the term. Entries are valid as long as modification time and size of
+ * the file are unchanged, so files which can't match are not read at all.
+ */
+class TrigramIndex {
+ public:
+    explicit TrigramIndex(const QString &sIndexFile = QString());
+
+    auto load() -> bool;
+    auto save() -> bool;
+
+    auto isUpToDate(const QFileInfo &fi) const -> bool;
+    auto mayContain(const QString &sFile,
+                    const QVector<quint32> &listQuery) const -> bool;
+    void update(const QString &sFile, const TrigramEntry &entry);
+    void remove(const QString &sFile);
+    void removeMissing(const QSet<QString> &setFiles);
+
+    static auto createEntry(const QFileInfo &fi,
+                            const QString &sText) -> TrigramEntry;
+    static auto trigrams(const QString &sText) -> QVector<quint32>;
+
+ private:
+    static const quint32 m_cMAGIC = 0x494E5954;  // "INYT"
+    static const quint32 m_cVERSION = 1;
+
+    const QString m_sIndexFile;
+    QHash<QString, TrigramEntry> m_hashEntries;
+    bool m_bChanged;
+};
+
+#endif  // APPLICATION_TRIGRAMINDEX_H_
@@ -40,6 +40,7 @@
 #include <QTextEdit>
 
 #include "./session.h"
+#include "./trace/trace.h"
 #include "./utils.h"
 
 Upload::Upload(QWidget *pParent, Session *pSession,
@@ -155,6 +156,7 @@ void Upload::requestRevision(QString sUrl) {
                        QString(qApp->applicationName() + "/"
                                + qApp->applicationVersion()).toLatin1());
   m_pReply = m_pSession->getNwManager()->get(request);
+  Trace::asyncReply(m_pReply, "network", "Request revision");
   QEventLoop loop;
   connect(m_pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
   loop.exec();
@@ -288,6 +290,7 @@ void Upload::requestUpload() {
 
   m_State = REQUPLOAD;
   m_pReply = m_pSession->getNwManager()->post(request, pMultiPart);
+  Trace::asyncReply(m_pReply, "network", "Upload article");
   QEventLoop loop;
   connect(m_pReply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
   loop.exec();
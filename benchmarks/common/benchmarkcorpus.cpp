@@ -0,0 +1,207 @@
+/**
+ * \file benchmarkcorpus.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Benchmark input: Representative articles and synthetic stress documents.
+ */
+
+#include "./benchmarkcorpus.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+
+auto BenchmarkCorpus::corpusDir() -> QString {
+  if (!qEnvironmentVariableIsEmpty("INYOKAEDIT_CORPUS")) {
+    return QString::fromLocal8Bit(qgetenv("INYOKAEDIT_CORPUS"));
+  }
+  return QStringLiteral(CORPUS_DIR);
+}
+
+// ----------------------------------------------------------------------------
+
+auto BenchmarkCorpus::sharePath() -> QString {
+  // Folder containing "community" (community branch checkout)
+  if (!qEnvironmentVariableIsEmpty("INYOKAEDIT_SHARE")) {
+    return QString::fromLocal8Bit(qgetenv("INYOKAEDIT_SHARE"));
+  }
+  return QStringLiteral(SHARE_DIR);
+}
+
+// ----------------------------------------------------------------------------
+
+auto BenchmarkCorpus::hasCommunityData(const QString &sCommunity) -> bool {
+  const QString sPath(BenchmarkCorpus::sharePath() +
+                      "/community/" + sCommunity);
+  return QFile::exists(sPath + "/Preview.tpl") &&
+      QFile::exists(sPath + "/Textformats.conf");
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto BenchmarkCorpus::loadCorpus() -> QMap<QString, QString> {
+  QMap<QString, QString> corpus;
+  QDir dir(BenchmarkCorpus::corpusDir());
+  const QFileInfoList fiListFiles(dir.entryInfoList(
+                                    QStringList() << QStringLiteral("*.iny"),
+                                    QDir::Files, QDir::Name));
+  for (const auto &fi : fiListFiles) {
+    QFile file(fi.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      qWarning() << "Could not open corpus file:" << fi.absoluteFilePath();
+      continue;
+    }
+    QTextStream in(&file);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    // Since Qt 6 UTF-8 is used by default
+    in.setCodec("UTF-8");
+#endif
+    corpus.insert(fi.fileName(), in.readAll());
+    file.close();
+  }
+
+  if (corpus.isEmpty()) {
+    qWarning() << "No corpus files found in" << dir.absolutePath();
+  }
+  return corpus;
+}
+
+// ----------------------------------------------------------------------------
+
+auto BenchmarkCorpus::stressFiles(
+    const int nLines) -> QMap<QString, QString> {
+  QMap<QString, QString> files;
+  files.insert(QStringLiteral("stress-table"),
+               BenchmarkCorpus::generateTable(nLines));
+  files.insert(QStringLiteral("stress-smilies"),
+               BenchmarkCorpus::generateSmilies(nLines));
+  files.insert(QStringLiteral("stress-lists"),
+               BenchmarkCorpus::generateLists(nLines));
+  files.insert(QStringLiteral("stress-codeblocks"),
+               BenchmarkCorpus::generateCodeblocks(nLines));
+  return files;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+// Concatenate corpus articles until the requested number of lines is reached
+auto BenchmarkCorpus::generateArticle(const int nLines) -> QString {
+  const QMap<QString, QString> corpus(BenchmarkCorpus::loadCorpus());
+  QStringList sListLines;
+  for (const auto &sText : corpus) {
+    sListLines << sText.split('\n');
+  }
+  if (sListLines.isEmpty()) {
+    sListLines << QStringLiteral("Text with '''bold''' and [:Link:].");
+  }
+
+  QStringList sListOutput;
+  sListOutput.reserve(nLines);
+  for (int i = 0; i < nLines; i++) {
+    sListOutput << sListLines.at(i % sListLines.size());
+  }
+  return sListOutput.join('\n');
+}
+
+// ----------------------------------------------------------------------------
+
+auto BenchmarkCorpus::generateTable(const int nLines) -> QString {
+  QStringList sListOutput;
+  sListOutput.reserve(nLines);
+  sListOutput << QStringLiteral("||<tablestyle=\"width: 97%;\" "
+                                "rowclass=\"kopf\"> Nr. || Name || "
+                                "Link || Status ||");
+  for (int i = 1; i < nLines; i++) {
+    sListOutput << QStringLiteral("||<:> %1 || '''Eintrag''' %1 || "
+                                  "[:Seite_%1:Link %1] ||<(> ''offen'' ||")
+                   .arg(i);
+  }
+  return sListOutput.join('\n');
+}
+
+// ----------------------------------------------------------------------------
+
+auto BenchmarkCorpus::generateSmilies(const int nLines) -> QString {
+  QStringList sListOutput;
+  sListOutput.reserve(nLines);
+  for (int i = 0; i < nLines; i++) {
+    sListOutput << QStringLiteral("Zeile %1 :) ;) :-D :( 8-) :?: :!: "
+                                  "{de} {en} :idea: :-) :lol:").arg(i);
+  }
+  return sListOutput.join('\n');
+}
+
+// ----------------------------------------------------------------------------
+
+auto BenchmarkCorpus::generateLists(const int nLines) -> QString {
+  QStringList sListOutput;
+  sListOutput.reserve(nLines);
+  for (int i = 0; i < nLines; i++) {
+    const int nDepth = 1 + (i % 8);
+    if (0 == i % 2) {
+      sListOutput << QString(nDepth * 2 - 1, ' ') +
+                     QStringLiteral("* Punkt %1 mit ''kursiv'' und "
+                                    "[:Link:]").arg(i);
+    } else {
+      sListOutput << QString(nDepth * 2 - 1, ' ') +
+                     QStringLiteral("1. Nummer %1 mit '''fett'''").arg(i);
+    }
+  }
+  return sListOutput.join('\n');
+}
+
+// ----------------------------------------------------------------------------
+
+auto BenchmarkCorpus::generateCodeblocks(const int nLines) -> QString {
+  QStringList sListOutput;
+  sListOutput.reserve(nLines);
+  for (int i = 0; i < nLines; i++) {
+    switch (i % 20) {
+      case 0:
+        sListOutput << QStringLiteral("{{{#!code bash");
+        break;
+      case 9:
+      case 19:
+        sListOutput << QStringLiteral("}}}");
+        break;
+      case 10:
+        sListOutput << QStringLiteral("{{{#!vorlage Befehl");
+        break;
+      default:
+        sListOutput << QStringLiteral("echo '''%1''' [:kein:Link] :) "
+                                      "|| keine || Tabelle ||").arg(i);
+        break;
+    }
+  }
+  return sListOutput.join('\n');
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto BenchmarkCorpus::countLines(const QString &sText) -> int {
+  return sText.count('\n') + 1;
+}
@@ -0,0 +1,52 @@
+/**
+ * \file benchmarkcorpus.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for benchmark input (article corpus, stress files).
+ */
+
+#ifndef BENCHMARKS_COMMON_BENCHMARKCORPUS_H_
+#define BENCHMARKS_COMMON_BENCHMARKCORPUS_H_
+
+#include <QMap>
+#include <QString>
+
+/**
+ * \class BenchmarkCorpus
+ * \brief Articles from corpus folder and generated stress documents
+ */
+class BenchmarkCorpus {
+ public:
+    static auto corpusDir() -> QString;
+    static auto sharePath() -> QString;
+    static auto hasCommunityData(const QString &sCommunity) -> bool;
+    static auto loadCorpus() -> QMap<QString, QString>;
+    static auto stressFiles(const int nLines) -> QMap<QString, QString>;
+    static auto generateArticle(const int nLines) -> QString;
+    static auto generateTable(const int nLines) -> QString;
+    static auto generateSmilies(const int nLines) -> QString;
+    static auto generateLists(const int nLines) -> QString;
+    static auto generateCodeblocks(const int nLines) -> QString;
+    static auto countLines(const QString &sText) -> int;
+};
+
+#endif  // BENCHMARKS_COMMON_BENCHMARKCORPUS_H_
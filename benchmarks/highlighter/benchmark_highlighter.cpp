@@ -0,0 +1,294 @@
+/**
+ * \file benchmark_highlighter.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Benchmark syntax highlighter: Initial highlighting and single line edits.
+ *
+ * Run headless: ./benchmark_highlighter [-iterations N] [-o result.xml,xml]
+ */
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QtTest>
+
+#include "./benchmarkcorpus.h"
+#include "./highlighter.h"
+#include "./irenderservice.h"
+#include "./syntaxhighlighter.h"
+#include "./templates.h"
+#include "./texteditor.h"
+
+/**
+ * \class BenchmarkRenderService
+ * \brief Community data for plugin, rendering is not needed by highlighter
+ */
+class BenchmarkRenderService : public IRenderService {
+ public:
+    explicit BenchmarkRenderService(const Templates *pTemplates)
+      : m_pTemplates(pTemplates) {
+    }
+    auto getTemplates() const -> const Templates* override {
+      return m_pTemplates;
+    }
+    auto getMacroDefinitions() const
+        -> QList<QPair<QString, QStringList>> override {
+      return m_pTemplates->getMacroDefinitions();
+    }
+    auto render(const QString &sRawText,
+                const QString &sFileName = QString()) -> QString override {
+      Q_UNUSED(sRawText)
+      Q_UNUSED(sFileName)
+      return QString();
+    }
+    auto renderFragment(const QString &sFragment,
+                        const bool bWithStyle) -> QString override {
+      Q_UNUSED(sFragment)
+      Q_UNUSED(bWithStyle)
+      return QString();
+    }
+
+ private:
+    const Templates *m_pTemplates;
+};
+
+/**
+ * \class BenchmarkHighlighter
+ * \brief Highlighter throughput and edit latency for each style
+ */
+class BenchmarkHighlighter : public QObject {
+  Q_OBJECT
+
+ private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void initialHighlight_data();
+    void initialHighlight();
+    void singleLineEdit_data();
+    void singleLineEdit();
+
+ private:
+    void addRows();
+    auto createEditor(const QString &sStyle,
+                      const QString &sText) -> SyntaxHighlighter*;
+    static void waitForHighlighter(SyntaxHighlighter *pHighlighter);
+
+    static const int m_cSTRESSLINES = 5000;
+    static const QString m_sCOMMUNITY;
+
+    QTemporaryDir m_userDataDir;
+    QWidget m_parent;
+    Templates *m_pTemplates{};
+    BenchmarkRenderService *m_pRenderService{};
+    QMap<QString, Highlighter *> m_plugins;
+    TextEditor *m_pEditor{};
+};
+
+const QString BenchmarkHighlighter::m_sCOMMUNITY =
+    QStringLiteral("ubuntuusers_de");
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void BenchmarkHighlighter::initTestCase() {
+  if (!BenchmarkCorpus::hasCommunityData(m_sCOMMUNITY)) {
+    QSKIP("Community files not found - set INYOKAEDIT_SHARE to the folder "
+          "containing the community branch checkout.");
+  }
+
+  m_pTemplates = new Templates(m_sCOMMUNITY, BenchmarkCorpus::sharePath(),
+                               m_userDataDir.path());
+  m_pRenderService = new BenchmarkRenderService(m_pTemplates);
+
+  // Real highlighting rules of each style shipped with the plugin
+  const QStringList sListStyles(QStringList() <<
+                                QStringLiteral("standard-style") <<
+                                QStringLiteral("dark-style"));
+  for (const auto &sStyle : sListStyles) {
+#if defined __linux__
+    QSettings settings(QSettings::NativeFormat, QSettings::UserScope,
+                       qApp->applicationName().toLower(),
+                       qApp->applicationName().toLower());
+#else
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope,
+                       qApp->applicationName().toLower(),
+                       qApp->applicationName().toLower());
+#endif
+    settings.setValue(QStringLiteral("Inyoka/Community"), m_sCOMMUNITY);
+    settings.setValue("Plugin_" + QStringLiteral(PLUGIN_NAME) + "/Style",
+                      sStyle);
+    settings.sync();
+
+    auto *pPlugin = new Highlighter();
+    pPlugin->initPlugin(&m_parent, nullptr,
+                        QDir(m_userDataDir.path()),
+                        BenchmarkCorpus::sharePath(), m_pRenderService);
+    m_plugins.insert(sStyle, pPlugin);
+  }
+}
+
+void BenchmarkHighlighter::cleanupTestCase() {
+  delete m_pEditor;
+  m_pEditor = nullptr;
+  qDeleteAll(m_plugins);
+  m_plugins.clear();
+  delete m_pRenderService;
+  m_pRenderService = nullptr;
+  delete m_pTemplates;
+  m_pTemplates = nullptr;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void BenchmarkHighlighter::addRows() {
+  QTest::addColumn<QString>("style");
+  QTest::addColumn<QString>("text");
+
+  QMap<QString, QString> documents(BenchmarkCorpus::loadCorpus());
+  const QMap<QString, QString> stress(
+        BenchmarkCorpus::stressFiles(m_cSTRESSLINES));
+  for (auto it = stress.constBegin(); it != stress.constEnd(); ++it) {
+    documents.insert(it.key(), it.value());
+  }
+  documents.insert(QStringLiteral("stress-article"),
+                   BenchmarkCorpus::generateArticle(m_cSTRESSLINES));
+
+  const QStringList sListStyles(m_plugins.keys());
+  for (const auto &sStyle : sListStyles) {
+    for (auto it = documents.constBegin(); it != documents.constEnd(); ++it) {
+      QTest::newRow(QString(sStyle + "/" + it.key()).toLatin1().constData())
+          << sStyle << it.value();
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+auto BenchmarkHighlighter::createEditor(
+    const QString &sStyle, const QString &sText) -> SyntaxHighlighter* {
+  delete m_pEditor;
+  m_pEditor = new TextEditor(QStringList(), QStringLiteral("Vorlage"));
+  m_pEditor->resize(800, 600);
+  m_pEditor->setPlainText(sText);
+  m_pEditor->show();
+  if (!QTest::qWaitForWindowExposed(m_pEditor)) {
+    qWarning() << "Editor window not exposed";
+  }
+
+  Highlighter *pPlugin = m_plugins.value(sStyle);
+  pPlugin->setCurrentEditor(m_pEditor);
+  pPlugin->setEditorlist(QList<TextEditor *>() << m_pEditor);
+
+  // Child of the document, which is a (grand)child of the editor
+  auto *pHighlighter = m_pEditor->findChild<SyntaxHighlighter *>();
+  if (nullptr == pHighlighter) {
+    qWarning() << "No highlighter attached to editor";
+    return nullptr;
+  }
+  BenchmarkHighlighter::waitForHighlighter(pHighlighter);
+  return pHighlighter;
+}
+
+// ----------------------------------------------------------------------------
+
+void BenchmarkHighlighter::waitForHighlighter(
+    SyntaxHighlighter *pHighlighter) {
+  while (pHighlighter->isPending()) {
+    QCoreApplication::processEvents();
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void BenchmarkHighlighter::initialHighlight_data() {
+  this->addRows();
+}
+
+// Complete document, including viewport first pass and background chunks
+void BenchmarkHighlighter::initialHighlight() {
+  QFETCH(QString, style);
+  QFETCH(QString, text);
+
+  SyntaxHighlighter *pHighlighter = this->createEditor(style, text);
+  QVERIFY(nullptr != pHighlighter);
+  const int nLines = BenchmarkCorpus::countLines(text);
+
+  QElapsedTimer timer;
+  timer.start();
+  pHighlighter->rehighlightDeferred();
+  BenchmarkHighlighter::waitForHighlighter(pHighlighter);
+  const qint64 nNsecs = qMax(Q_INT64_C(1), timer.nsecsElapsed());
+  qInfo() << QTest::currentDataTag() << nLines << "lines:"
+          << qRound64(nLines * 1e9 / nNsecs) << "lines/s";
+
+  QBENCHMARK {
+    pHighlighter->rehighlightDeferred();
+    BenchmarkHighlighter::waitForHighlighter(pHighlighter);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void BenchmarkHighlighter::singleLineEdit_data() {
+  this->addRows();
+}
+
+// Typing latency: Insert and remove one character in the middle of document
+void BenchmarkHighlighter::singleLineEdit() {
+  QFETCH(QString, style);
+  QFETCH(QString, text);
+
+  QVERIFY(nullptr != this->createEditor(style, text));
+  QTextBlock block(m_pEditor->document()->findBlockByNumber(
+                     m_pEditor->document()->blockCount() / 2));
+  QTextCursor cursor(block);
+  cursor.movePosition(QTextCursor::EndOfBlock);
+
+  QBENCHMARK {
+    cursor.insertText(QStringLiteral("'"));
+    cursor.deletePreviousChar();
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto main(int argc, char *argv[]) -> int {
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+  QApplication app(argc, argv);
+  app.setApplicationName(QStringLiteral("InyokaEdit-Benchmark"));
+  // Don't touch user configuration
+  QStandardPaths::setTestModeEnabled(true);
+
+  BenchmarkHighlighter benchmark;
+  return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "benchmark_highlighter.moc"
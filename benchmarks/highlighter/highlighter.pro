@@ -0,0 +1,55 @@
+#  This file is part of InyokaEdit.
+#  Copyright (C) 2011-2021 The InyokaEdit developers
+#
+#  InyokaEdit is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  InyokaEdit is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+
+TEMPLATE      = app
+TARGET        = benchmark_highlighter
+DESTDIR       = ../
+
+QT           += core gui widgets testlib
+CONFIG       += c++11 testcase no_testcase_installs
+CONFIG       -= app_bundle
+DEFINES      += QT_NO_FOREACH
+
+# Plugin sources are compiled into the benchmark directly
+DEFINES      += PLUGIN_NAME=\\\"highlighter\\\" \
+                PLUGIN_VERSION=\\\"benchmark\\\" \
+                PLUGIN_COPY=\\\"\\\"
+
+MOC_DIR       = ./.moc
+OBJECTS_DIR   = ./.objs
+UI_DIR        = ./.ui
+RCC_DIR       = ./.rcc
+
+include(../common/common.pri)
+include(../../application/templates/templates.pri)
+include(../../application/trace/trace.pri)
+
+INCLUDEPATH  += ../../plugins/highlighter \
+                ../../application
+
+HEADERS      += ../../plugins/highlighter/highlighter.h \
+                ../../plugins/highlighter/syntaxhighlighter.h \
+                ../../application/texteditor.h
+
+SOURCES      += benchmark_highlighter.cpp \
+                ../../plugins/highlighter/highlighter.cpp \
+                ../../plugins/highlighter/syntaxhighlighter.cpp \
+                ../../application/texteditor.cpp
+
+FORMS        += ../../plugins/highlighter/highlighter.ui
+
+RESOURCES     = highlighter.qrc \
+                ../../plugins/highlighter/res/highlighter_resources.qrc
@@ -0,0 +1,258 @@
+/**
+ * \file benchmark_parser.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Benchmark Parser::genOutput() on corpus and generated documents.
+ *
+ * Writes total and per stage timings and peak memory as JSON. Link check
+ * and pygmentize are disabled, so no network or external process is used.
+ */
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QTextDocument>
+
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include "./benchmarkcorpus.h"
+#include "./parser.h"
+#include "./templates.h"
+
+static const QString sCOMMUNITY = QStringLiteral("ubuntuusers_de");
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+// Peak resident set size in kB (-1 if not available)
+static auto peakMemory() -> qint64 {
+#if defined __linux__
+  QFile status(QStringLiteral("/proc/self/status"));
+  if (status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    const QList<QByteArray> listLines(status.readAll().split('\n'));
+    for (const auto &line : listLines) {
+      if (line.startsWith("VmHWM:")) {
+        return line.mid(6).trimmed().split(' ').first().toLongLong();
+      }
+    }
+  }
+#endif
+#ifdef Q_OS_UNIX
+  struct rusage usage {};
+  if (0 == getrusage(RUSAGE_SELF, &usage)) {
+#if defined Q_OS_MACOS
+    return usage.ru_maxrss / 1024;  // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+  }
+#endif
+  return -1;
+}
+
+// Reset peak RSS, so that it can be reported for each document (Linux only)
+static void resetPeakMemory() {
+#if defined __linux__
+  QFile clearRefs(QStringLiteral("/proc/self/clear_refs"));
+  if (clearRefs.open(QIODevice::WriteOnly)) {
+    clearRefs.write("5");
+  }
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+static auto runDocument(Parser *pParser, const QString &sName,
+                        const QString &sText, const int nIterations,
+                        const QString &sKind) -> QJsonObject {
+  QTextDocument doc;
+  doc.setPlainText(sText);
+
+  resetPeakMemory();
+  QList<qint64> listTotals;
+  QList<QPair<QString, qint64>> listBestStages;
+  qint64 nBest = -1;
+  qint64 nOutputSize = 0;
+  QElapsedTimer timer;
+
+  for (int i = 0; i < nIterations; i++) {
+    timer.start();
+    const QString sHtml(pParser->genOutput(sName, &doc));
+    const qint64 nTotal = timer.nsecsElapsed();
+    listTotals << nTotal;
+    nOutputSize = sHtml.size();
+    if (nBest < 0 || nTotal < nBest) {
+      nBest = nTotal;
+      listBestStages = pParser->getStageTimings();
+    }
+  }
+  std::sort(listTotals.begin(), listTotals.end());
+
+  const int nLines = BenchmarkCorpus::countLines(sText);
+  QJsonObject stages;
+  for (const auto &stage : qAsConst(listBestStages)) {
+    stages.insert(stage.first, stage.second / 1e6);
+  }
+
+  QJsonObject result;
+  result.insert(QStringLiteral("name"), sName);
+  result.insert(QStringLiteral("kind"), sKind);
+  result.insert(QStringLiteral("lines"), nLines);
+  result.insert(QStringLiteral("chars"), sText.size());
+  result.insert(QStringLiteral("output_chars"), nOutputSize);
+  result.insert(QStringLiteral("iterations"), nIterations);
+  result.insert(QStringLiteral("min_ms"), nBest / 1e6);
+  result.insert(QStringLiteral("median_ms"),
+                listTotals.at(listTotals.size() / 2) / 1e6);
+  result.insert(QStringLiteral("ns_per_line"),
+                static_cast<double>(nBest) / qMax(1, nLines));
+  result.insert(QStringLiteral("stages_ms"), stages);
+  result.insert(QStringLiteral("peak_rss_kb"), peakMemory());
+
+  qInfo().noquote() << sName << "-" << nLines << "lines:"
+                    << nBest / 1e6 << "ms";
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto main(int argc, char *argv[]) -> int {
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+  QApplication app(argc, argv);
+  app.setApplicationName(QStringLiteral("InyokaEdit-Benchmark"));
+
+  QCommandLineParser cmdparser;
+  cmdparser.setApplicationDescription(
+        QStringLiteral("Benchmark of InyokaEdit parser"));
+  cmdparser.addHelpOption();
+  QCommandLineOption cmdOutput(QStringList() << QStringLiteral("o") <<
+                               QStringLiteral("output"),
+                               QStringLiteral("Write JSON result to <file> "
+                                              "instead of stdout."),
+                               QStringLiteral("file"));
+  cmdparser.addOption(cmdOutput);
+  QCommandLineOption cmdIterations(QStringList() << QStringLiteral("i") <<
+                                   QStringLiteral("iterations"),
+                                   QStringLiteral("Runs per document "
+                                                  "(default 3)."),
+                                   QStringLiteral("n"), QStringLiteral("3"));
+  cmdparser.addOption(cmdIterations);
+  QCommandLineOption cmdMaxLines(QStringLiteral("max-lines"),
+                                 QStringLiteral("Largest generated document "
+                                                "(default 100000)."),
+                                 QStringLiteral("n"),
+                                 QStringLiteral("100000"));
+  cmdparser.addOption(cmdMaxLines);
+  QCommandLineOption cmdDebug(QStringLiteral("debug"),
+                              QStringLiteral("Show parser debug output."));
+  cmdparser.addOption(cmdDebug);
+  cmdparser.process(app);
+
+  if (!cmdparser.isSet(cmdDebug)) {
+    QLoggingCategory::setFilterRules(QStringLiteral("*.debug=false"));
+  }
+
+  if (!BenchmarkCorpus::hasCommunityData(sCOMMUNITY)) {
+    qCritical() << "Community files not found in" <<
+                   BenchmarkCorpus::sharePath() + "/community/" + sCOMMUNITY;
+    qCritical() << "Set INYOKAEDIT_SHARE to the folder containing the "
+                   "community branch checkout.";
+    return 1;
+  }
+
+  const int nIterations = qMax(1, cmdparser.value(cmdIterations).toInt());
+  const int nMaxLines = qMax(100, cmdparser.value(cmdMaxLines).toInt());
+
+  QTemporaryDir userDataDir;
+  QTemporaryDir tmpImgDir;
+  Templates templates(sCOMMUNITY, BenchmarkCorpus::sharePath(),
+                      userDataDir.path());
+  // No link check (network) and no pygmentize (external process)
+  Parser parser(BenchmarkCorpus::sharePath(), QDir(tmpImgDir.path()),
+                QString(), false, &templates, sCOMMUNITY, QString());
+  parser.setMeasureStages(true);
+
+  QJsonArray results;
+  const QMap<QString, QString> corpus(BenchmarkCorpus::loadCorpus());
+  for (auto it = corpus.constBegin(); it != corpus.constEnd(); ++it) {
+    results << runDocument(&parser, it.key(), it.value(), nIterations,
+                           QStringLiteral("corpus"));
+  }
+
+  const QMap<QString, QString> stress(BenchmarkCorpus::stressFiles(1000));
+  for (auto it = stress.constBegin(); it != stress.constEnd(); ++it) {
+    results << runDocument(&parser, it.key(), it.value(), nIterations,
+                           QStringLiteral("stress"));
+  }
+
+  // Scalability curve: ns_per_line should stay constant for linear runtime
+  for (int nLines = 100; nLines <= nMaxLines; nLines *= 10) {
+    results << runDocument(&parser,
+                           "generated-" + QString::number(nLines),
+                           BenchmarkCorpus::generateArticle(nLines),
+                           nLines >= 100000 ? 1 : nIterations,
+                           QStringLiteral("scaling"));
+  }
+
+  QJsonObject root;
+  root.insert(QStringLiteral("benchmark"), QStringLiteral("parser"));
+  root.insert(QStringLiteral("date"),
+              QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+  root.insert(QStringLiteral("qt"), QString::fromLatin1(qVersion()));
+  root.insert(QStringLiteral("community"), sCOMMUNITY);
+  root.insert(QStringLiteral("results"), results);
+  const QByteArray baJson(QJsonDocument(root).toJson());
+
+  if (cmdparser.isSet(cmdOutput)) {
+    QFile out(cmdparser.value(cmdOutput));
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+      qCritical() << "Could not write" << out.fileName() << out.errorString();
+      return 1;
+    }
+    out.write(baJson);
+    out.close();
+  } else {
+    QFile out;
+    if (!out.open(stdout, QIODevice::WriteOnly)) {
+      return 1;
+    }
+    out.write(baJson);
+  }
+
+  return 0;
+}
@@ -0,0 +1,46 @@
+#  This file is part of InyokaEdit.
+#  Copyright (C) 2011-2021 The InyokaEdit developers
+#
+#  InyokaEdit is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  InyokaEdit is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+
+TEMPLATE      = app
+TARGET        = benchmark_parser
+DESTDIR       = ../
+
+QT           += core gui widgets network
+CONFIG       += c++11 console
+CONFIG       -= app_bundle
+DEFINES      += QT_NO_FOREACH
+
+# Parser without preview dependencies (no WebKit/WebEngine)
+DEFINES      += NOPREVIEW
+
+MOC_DIR       = ./.moc
+OBJECTS_DIR   = ./.objs
+UI_DIR        = ./.ui
+RCC_DIR       = ./.rcc
+
+include(../common/common.pri)
+include(../../application/templates/templates.pri)
+include(../../application/parser/parser.pri)
+include(../../application/trace/trace.pri)
+
+HEADERS      += ../../application/syntaxcheck.h \
+                ../../application/utils.h
+
+SOURCES      += benchmark_parser.cpp \
+                ../../application/syntaxcheck.cpp \
+                ../../application/utils.cpp
+
+RESOURCES     = parser.qrc
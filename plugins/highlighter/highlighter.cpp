@@ -34,6 +34,7 @@
 #include <QMessageBox>
 #include <QSettings>
 
+#include "../../application/irenderservice.h"
 #include "../../application/templates/templates.h"
 #include "../../application/texteditor.h"
 
@@ -43,8 +44,10 @@ const QString Highlighter::sSEPARATOR = QStringLiteral("|");
 
 void Highlighter::initPlugin(QWidget *pParent, TextEditor *pEditor,
                              const QDir &userDataDir,
-                             const QString &sSharePath) {
+                             const QString &sSharePath,
+                             IRenderService *pRenderService) {
   Q_UNUSED(pEditor)
+  Q_UNUSED(userDataDir)
   qDebug() << "initPlugin()" << PLUGIN_NAME << PLUGIN_VERSION;
 
 #if defined __linux__
@@ -82,10 +85,7 @@ void Highlighter::initPlugin(QWidget *pParent, TextEditor *pEditor,
   m_pSettings->endGroup();
 
   m_pStyleSet = nullptr;
-  m_pTemplates = new Templates(
-                   m_pSettings->value(QStringLiteral("Inyoka/Community"),
-                                      "ubuntuusers_de").toString(),
-                   m_sSharePath, userDataDir.absolutePath());
+  m_pTemplates = pRenderService->getTemplates();  // Shared with application
   this->getTranslations();
   this->readStyle(m_sStyleFile);
   this->defineRules();
@@ -484,38 +484,20 @@ void Highlighter::writeFormat(const QString &sKey,
 // ----------------------------------------------------------------------------
 
 void Highlighter::getTranslations() {
-  QFile fiMacros(QStringLiteral(":/macros.conf"));
-  if (!fiMacros.open(QIODevice::ReadOnly)) {
-    qWarning() << "Could not open macros.conf";
-    QMessageBox::warning(nullptr, QStringLiteral("Error"),
-                         QStringLiteral("Could not open macros.conf"));
-  } else {
-    QTextStream in(&fiMacros);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    // Since Qt 6 UTF-8 is used by default
-    in.setCodec("UTF-8");
-#endif
-    QString tmpLine;
-    QStringList tmpList;
-
-    while (!in.atEnd()) {
-      tmpLine = in.readLine().trimmed();
-      if (!tmpLine.trimmed().isEmpty()) {
-        tmpList = tmpLine.split(QStringLiteral("="));
-        if (2 == tmpList.size()) {
-          const QStringList tmpList2(tmpList[1].split(QStringLiteral(",")));
-          for (const auto &s : tmpList2) {
-            m_sListMacroKeywords << s.trimmed();
-
-            if ("Template" == tmpList[0].trimmed() ||
-                "Code" == tmpList[0].trimmed()) {
-              m_sListParserKeywords << s.trimmed().toLower();
-            }
-          }
-        }
+  // Parsed once and stored in community snapshot (see Templates)
+  const QList<QPair<QString, QStringList>> listMacros(
+        m_pTemplates->getMacroDefinitions());
+  for (const auto &macro : listMacros) {
+    for (const auto &s : macro.second) {
+      m_sListMacroKeywords << s;
+
+      if ("Template" == macro.first || "Code" == macro.first) {
+        m_sListParserKeywords << s.toLower();
+      }
+      if ("Template" == macro.first) {
+        m_sListTplKeywords << s;
       }
     }
-    fiMacros.close();
   }
 }
 
@@ -913,42 +895,58 @@ void Highlighter::showSettings() {
 // ----------------------------------------------------------------------------
 
 void Highlighter::setCurrentEditor(TextEditor *pEditor) {
-  Q_UNUSED(pEditor)
-}
-
-void Highlighter::setEditorlist(const QList<TextEditor *> &listEditors) {
-  m_ListHighlighters.clear();
+  m_pCurrentEditor = pEditor;
 
-  for (auto *pEd : listEditors) {
-    if (!m_listEditors.contains(pEd)) {
-      m_listEditors << pEd;
+  // Only the visible tab is highlighted, others wait until activated
+  for (auto it = m_Highlighters.constBegin();
+       it != m_Highlighters.constEnd(); ++it) {
+    if (!it.value().isNull()) {
+      it.value()->setActive(it.key() == m_pCurrentEditor);
     }
   }
-  for (auto *pEd : qAsConst(m_listEditors)) {
+}
+
+void Highlighter::setEditorlist(const QList<TextEditor *> &listEditors) {
+  const QList<TextEditor *> listKnownEditors(m_Highlighters.keys());
+  for (auto *pEd : listKnownEditors) {
     if (!listEditors.contains(pEd)) {
-      m_listEditors.removeOne(pEd);
-    } else {
-      m_ListHighlighters << new SyntaxHighlighter(pEd->document());
+      m_Highlighters.remove(pEd);
     }
   }
 
-  this->rehighlightAll();
+  QPalette pal;
+  pal.setColor(QPalette::Base, m_colorBackground);
+  pal.setColor(QPalette::Text, m_colorForeground);
+  for (auto *pEd : listEditors) {
+    if (!m_Highlighters.contains(pEd)) {
+      auto *pHighlighter = new SyntaxHighlighter(pEd, pEd->document());
+      pHighlighter->setRules(m_highlightingRules);
+      pHighlighter->setBlockFormats(m_sListTplKeywords, m_parserFormat,
+                                    m_macrosFormat);
+      pHighlighter->setActive(pEd == m_pCurrentEditor);
+      m_Highlighters.insert(pEd, pHighlighter);
+      pEd->setPalette(pal);
+    }
+  }
 }
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
 void Highlighter::rehighlightAll() {
-  for (auto *hlight : qAsConst(m_ListHighlighters)) {
-    hlight->setRules(m_highlightingRules);
-    hlight->rehighlight();
-  }
-
   QPalette pal;
   pal.setColor(QPalette::Base, m_colorBackground);
   pal.setColor(QPalette::Text, m_colorForeground);
-  for (auto *editor : qAsConst(m_listEditors)) {
-    editor->setPalette(pal);
+
+  for (auto it = m_Highlighters.constBegin();
+       it != m_Highlighters.constEnd(); ++it) {
+    if (!it.value().isNull()) {
+      it.value()->setRules(m_highlightingRules);
+      it.value()->setBlockFormats(m_sListTplKeywords, m_parserFormat,
+                                  m_macrosFormat);
+      it.value()->rehighlightDeferred();
+      it.key()->setPalette(pal);
+    }
   }
 }
 
@@ -28,6 +28,8 @@
 #ifndef PLUGINS_HIGHLIGHTER_HIGHLIGHTER_H_
 #define PLUGINS_HIGHLIGHTER_HIGHLIGHTER_H_
 
+#include <QHash>
+#include <QPointer>
 #include <QtPlugin>
 #include <QTextCharFormat>
 #include <QTranslator>
@@ -57,7 +59,8 @@ class Highlighter : public QObject, IEditorPlugin {
  public:
     void initPlugin(QWidget *pParent, TextEditor *pEditor,
                     const QDir &userDataDir,
-                    const QString &sSharePath) override;
+                    const QString &sSharePath,
+                    IRenderService *pRenderService) override;
     auto getPluginName() const -> QString override;
     auto getPluginVersion() const -> QString override;
     void installTranslator(const QString &sLang) override;
@@ -100,9 +103,9 @@ class Highlighter : public QObject, IEditorPlugin {
     QString m_sSharePath;
     QDialog *m_pDialog;
     QSettings *m_pSettings;
-    QList<SyntaxHighlighter *> m_ListHighlighters;
-    QList<TextEditor *> m_listEditors;
-    Templates *m_pTemplates;
+    QHash<TextEditor *, QPointer<SyntaxHighlighter>> m_Highlighters;
+    TextEditor *m_pCurrentEditor{};
+    const Templates *m_pTemplates;
 
     QString m_sStyleFile;
     QString m_sExt;
@@ -110,6 +113,7 @@ class Highlighter : public QObject, IEditorPlugin {
     QSettings *m_pStyleSet;
     QStringList m_sListMacroKeywords;
     QStringList m_sListParserKeywords;
+    QStringList m_sListTplKeywords;
 
     QVector<HighlightingRule> m_highlightingRules;
     QTextCharFormat m_headingsFormat;
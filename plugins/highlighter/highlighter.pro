@@ -33,6 +33,7 @@ UI_DIR        = ./.ui
 RCC_DIR       = ./.rcc
 
 include(../../application/templates/templates.pri)
+include(../../application/trace/trace.pri)
 
 CONFIG       += c++11
 DEFINES      += QT_NO_FOREACH
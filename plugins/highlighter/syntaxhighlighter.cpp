@@ -26,9 +26,38 @@
 
 #include "./syntaxhighlighter.h"
 
-SyntaxHighlighter::SyntaxHighlighter(QTextDocument *pDoc, QObject *pParent)
-  : QSyntaxHighlighter(pDoc) {
-  Q_UNUSED(pParent)
+#include <QElapsedTimer>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextEdit>
+#include <QTimer>
+
+#include "../../application/trace/trace.h"
+
+SyntaxHighlighter::SyntaxHighlighter(QTextEdit *pEditor, QObject *pParent)
+  : QSyntaxHighlighter(pParent),
+    m_pEditor(pEditor),
+    m_pChunkTimer(new QTimer(this)),
+    m_nNextBlock(0),
+    m_nFirstVisible(0),
+    m_nLastVisible(-1),
+    m_bActive(false) {
+  m_pChunkTimer->setInterval(0);
+  connect(m_pChunkTimer, &QTimer::timeout,
+          this, &SyntaxHighlighter::highlightChunk);
+  connect(pEditor->document(), &QTextDocument::contentsChange,
+          this, &SyntaxHighlighter::changedContents);
+  connect(pEditor->verticalScrollBar(), &QScrollBar::valueChanged,
+          this, [this]() {
+    if (m_bActive && m_nNextBlock >= 0) {
+      this->highlightVisibleBlocks();
+    }
+  });
+
+  // Document is attached only here (base class gets no editor), after own
+  // contentsChange handler is connected: It runs before the reformatting of
+  // QSyntaxHighlighter, so that a document reset is highlighted incrementally
+  this->setDocument(pEditor->document());
 }
 
 SyntaxHighlighter::~SyntaxHighlighter() = default;
@@ -38,6 +67,47 @@ SyntaxHighlighter::~SyntaxHighlighter() = default;
 
 void SyntaxHighlighter::setRules(const QVector<HighlightingRule> &rules) {
   m_highlightingRules = rules;
+  // Compile patterns once instead of rebuilding them for every block
+  for (auto &rule : m_highlightingRules) {
+    rule.regexp.setPatternOptions(rule.regexp.patternOptions() |
+                                  QRegularExpression::InvertedGreedinessOption);
+    rule.regexp.optimize();
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void SyntaxHighlighter::setBlockFormats(const QStringList &sListTplKeywords,
+                                        const QTextCharFormat &parserFormat,
+                                        const QTextCharFormat &macrosFormat) {
+  m_parserFormat = parserFormat;
+  m_macrosFormat = macrosFormat;
+  m_sListTplKeywords.clear();
+
+  QStringList sListEscaped;
+  sListEscaped.reserve(sListTplKeywords.size());
+  for (const auto &sKeyword : sListTplKeywords) {
+    m_sListTplKeywords << sKeyword.toLower();
+    sListEscaped << QRegularExpression::escape(sKeyword);
+  }
+
+  // Without keywords no template invocation can start ((?!) never matches)
+  QString sTplStart(QStringLiteral("(?!)"));
+  if (!sListEscaped.isEmpty()) {
+    sTplStart = "\\[\\[(?:" + sListEscaped.join(QStringLiteral("|")) +
+                ")\\s*\\(";
+  }
+
+  // 1: {{{ / {{{#!keyword (2: keyword), 3: }}},
+  // 4: [[Vorlage( (template invocation start), 5: )]],
+  // 6: [[Macro( (other macro, nested inside template invocation)
+  m_blockDelimiters = QRegularExpression(
+                        "(\\{\\{\\{(?:#!(\\w+))?)|(\\}\\}\\})|"
+                        "(" + sTplStart + ")|(\\)\\]\\])|"
+                        "(\\[\\[\\w+\\s*\\()",
+                        QRegularExpression::CaseInsensitiveOption);
+  m_blockDelimiters.optimize();
 }
 
 // ----------------------------------------------------------------------------
@@ -45,15 +115,105 @@ void SyntaxHighlighter::setRules(const QVector<HighlightingRule> &rules) {
 
 // Apply collected highlighting rules
 void SyntaxHighlighter::highlightBlock(const QString &sText) {
+  const int nBlock = this->currentBlock().blockNumber();
+  if (m_nNextBlock >= 0 && nBlock >= m_nNextBlock) {
+    // Not reached by background highlighting yet: Only format visible lines
+    // and keep the stored state, so that changes do not cascade down
+    if (nBlock >= m_nFirstVisible && nBlock <= m_nLastVisible) {
+      this->formatBlock(sText);
+    }
+    return;
+  }
+
+  // Unchanged state lets Qt stop rehighlighting the following blocks
+  this->setCurrentBlockState(this->formatBlock(sText));
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto SyntaxHighlighter::formatBlock(const QString &sText) -> int {
+  int nState = this->previousBlockState();
+  if (nState < 0) {
+    nState = 0;
+  }
+
+  // Lines inside a code block are shown verbatim
+  if (0 != (nState & STATE_CODE) &&
+      !sText.contains(QLatin1String("}}}"))) {
+    return nState;
+  }
+
+  this->applyRules(sText);
+
+  int nCodeStart = 0;
+  QRegularExpressionMatchIterator it = m_blockDelimiters.globalMatch(sText);
+  while (it.hasNext()) {
+    QRegularExpressionMatch match = it.next();
+
+    if (0 != (nState & STATE_CODE)) {
+      // Only closing braces end a code block; markup inside is ignored
+      if (match.capturedStart(3) < 0) {
+        continue;
+      }
+      this->setFormat(nCodeStart, match.capturedStart() - nCodeStart,
+                      QTextCharFormat());
+      this->setFormat(match.capturedStart(), match.capturedLength(),
+                      m_parserFormat);
+      nState &= ~STATE_CODE;
+    } else if (match.capturedStart(1) >= 0) {
+      if (0 != (nState & STATE_TEMPLATE_MASK)) {
+        continue;  // Braces are part of a template argument
+      }
+      if (m_sListTplKeywords.contains(match.captured(2).toLower())) {
+        // Parser template ({{{#!vorlage): content is markup
+        nState += 1 << STATE_DEPTH_SHIFT;
+      } else {
+        // Code block ({{{ or {{{#!code)
+        nState |= STATE_CODE;
+        nCodeStart = match.capturedEnd();
+      }
+    } else if (match.capturedStart(3) >= 0) {
+      if (0 == (nState & STATE_TEMPLATE_MASK) &&
+          (nState >> STATE_DEPTH_SHIFT) > 0) {
+        nState -= 1 << STATE_DEPTH_SHIFT;
+      }
+    } else if (match.capturedStart(5) >= 0) {
+      const int nDepth = (nState & STATE_TEMPLATE_MASK) >> STATE_TEMPLATE_SHIFT;
+      if (nDepth > 0) {
+        nState -= 1 << STATE_TEMPLATE_SHIFT;
+        if (1 == nDepth) {  // End of template invocation itself
+          this->setFormat(match.capturedStart(), match.capturedLength(),
+                          m_macrosFormat);
+        }
+      }
+    } else if (match.capturedStart(4) >= 0 ||
+               0 != (nState & STATE_TEMPLATE_MASK)) {
+      // Template invocation or macro nested inside of it (depth is limited)
+      if ((nState & STATE_TEMPLATE_MASK) != STATE_TEMPLATE_MASK) {
+        nState += 1 << STATE_TEMPLATE_SHIFT;
+      }
+    }
+  }
+
+  if (0 != (nState & STATE_CODE)) {
+    this->setFormat(nCodeStart, sText.length() - nCodeStart,
+                    QTextCharFormat());
+  }
+
+  return nState;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void SyntaxHighlighter::applyRules(const QString &sText) {
   // Go through each highlighting rule
   // rules for every syntax element had been appended in constructor
   QRegularExpressionMatchIterator i;
   QRegularExpressionMatch match;
   for (const auto &rule : qAsConst(m_highlightingRules)) {
-    QRegularExpression express(rule.regexp.pattern(),
-                               rule.regexp.patternOptions() |
-                               QRegularExpression::InvertedGreedinessOption);
-    i = express.globalMatch(sText);
+    i = rule.regexp.globalMatch(sText);
     while (i.hasNext()) {
         match = i.next();
         if (match.hasMatch()) {
@@ -62,5 +222,104 @@ void SyntaxHighlighter::highlightBlock(const QString &sText) {
         }
     }
   }
-  setCurrentBlockState(0);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void SyntaxHighlighter::rehighlightDeferred() {
+  m_nNextBlock = 0;
+  if (m_bActive) {
+    this->highlightVisibleBlocks();
+    m_pChunkTimer->start();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void SyntaxHighlighter::setActive(const bool bActive) {
+  m_bActive = bActive;
+  if (!m_bActive) {
+    // Background tabs are continued as soon as they get activated again
+    m_pChunkTimer->stop();
+  } else if (m_nNextBlock >= 0) {
+    this->highlightVisibleBlocks();
+    m_pChunkTimer->start();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+auto SyntaxHighlighter::isPending() const -> bool {
+  return m_nNextBlock >= 0;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void SyntaxHighlighter::highlightVisibleBlocks() {
+  TraceSpan span("highlighter", "highlightVisibleBlocks");
+  const QRect rect(m_pEditor->viewport()->rect());
+  m_nFirstVisible = m_pEditor->cursorForPosition(rect.topLeft()).blockNumber();
+  m_nLastVisible = m_pEditor->cursorForPosition(
+                     rect.bottomRight()).blockNumber();
+
+  QTextBlock block(this->document()->findBlockByNumber(
+                     qMax(m_nFirstVisible, m_nNextBlock)));
+  while (block.isValid() && block.blockNumber() <= m_nLastVisible) {
+    this->rehighlightBlock(block);
+    block = block.next();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void SyntaxHighlighter::highlightChunk() {
+  TraceSpan span("highlighter", "highlightChunk");
+  QElapsedTimer timer;
+  timer.start();
+
+  QTextBlock block(this->document()->findBlockByNumber(m_nNextBlock));
+  while (block.isValid()) {
+    if (timer.elapsed() >= m_cCHUNKBUDGET) {
+      Trace::counter("highlighter", "Highlighted blocks", m_nNextBlock);
+      return;  // Continue within next event loop cycle
+    }
+    m_nNextBlock = block.blockNumber() + 1;
+    this->rehighlightBlock(block);
+    block = block.next();
+  }
+
+  m_nNextBlock = -1;
+  m_pChunkTimer->stop();
+}
+
+// ----------------------------------------------------------------------------
+
+void SyntaxHighlighter::changedContents(int nPosition, int nCharsRemoved,
+                                        int nCharsAdded) {
+  Q_UNUSED(nCharsRemoved)
+  // Whole document replaced (setPlainText on file load or reused tab):
+  // Highlight it from the beginning in background chunks again
+  if (0 == nPosition && nCharsAdded > 0 &&
+      nCharsAdded >= this->document()->characterCount() - 1) {
+    m_nNextBlock = 0;
+    m_nFirstVisible = 0;
+    m_nLastVisible = -1;
+    if (m_bActive) {
+      m_pChunkTimer->start();
+    }
+    return;
+  }
+
+  if (m_nNextBlock < 0) {
+    return;
+  }
+
+  // Lines may have been removed in front of the background position,
+  // continue directly behind the changed block
+  const int nBlock = this->document()->findBlock(nPosition).blockNumber();
+  if (nBlock < m_nNextBlock) {
+    m_nNextBlock = nBlock + 1;
+  }
 }
@@ -28,11 +28,13 @@
 #define PLUGINS_HIGHLIGHTER_SYNTAXHIGHLIGHTER_H_
 
 #include <QRegularExpression>
+#include <QStringList>
 #include <QSyntaxHighlighter>
 #include <QTextCharFormat>
 #include <QVector>
 
-class QTextDocument;
+class QTextEdit;
+class QTimer;
 
 struct HighlightingRule {
   QRegularExpression regexp;
@@ -47,17 +49,52 @@ class SyntaxHighlighter : public QSyntaxHighlighter {
   Q_OBJECT
 
  public:
-    explicit SyntaxHighlighter(QTextDocument *pDoc = nullptr,
+    // pParent: Owner, e.g. document of editor (editor itself would make the
+    // base class attach the document a second time)
+    explicit SyntaxHighlighter(QTextEdit *pEditor,
                                QObject *pParent = nullptr);
     ~SyntaxHighlighter();
     void setRules(const QVector<HighlightingRule> &rules);
+    void setBlockFormats(const QStringList &sListTplKeywords,
+                         const QTextCharFormat &parserFormat,
+                         const QTextCharFormat &macrosFormat);
+    void rehighlightDeferred();
+    void setActive(const bool bActive);
+    auto isPending() const -> bool;
 
  protected:
     // Apply highlighting rules
     void highlightBlock(const QString &sText) override;
 
+ private slots:
+    void highlightChunk();
+    void changedContents(int nPosition, int nCharsRemoved, int nCharsAdded);
+
  private:
+    // Block state bits: code flag, nesting depth of macros inside a template
+    // invocation and above them nesting depth of parser blocks
+    enum BLOCKSTATE {STATE_CODE = 0x1, STATE_TEMPLATE_SHIFT = 1,
+                     STATE_TEMPLATE_MASK = 0x1E, STATE_DEPTH_SHIFT = 5};
+
+    auto formatBlock(const QString &sText) -> int;
+    void applyRules(const QString &sText);
+    void highlightVisibleBlocks();
+
+    // Time budget per event loop cycle for background highlighting (ms)
+    static const qint64 m_cCHUNKBUDGET = 15;
+
+    QTextEdit *m_pEditor;
+    QTimer *m_pChunkTimer;
+    // Blocks from this number on are highlighted in background chunks
+    int m_nNextBlock;
+    int m_nFirstVisible;
+    int m_nLastVisible;
+    bool m_bActive;
     QVector<HighlightingRule> m_highlightingRules;
+    QRegularExpression m_blockDelimiters;
+    QStringList m_sListTplKeywords;
+    QTextCharFormat m_parserFormat;
+    QTextCharFormat m_macrosFormat;
 };
 
 #endif  // PLUGINS_HIGHLIGHTER_SYNTAXHIGHLIGHTER_H_
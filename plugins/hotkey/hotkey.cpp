@@ -38,8 +38,10 @@
 
 void Hotkey::initPlugin(QWidget *pParent, TextEditor *pEditor,
                         const QDir &userDataDir,
-                        const QString &sSharePath) {
+                        const QString &sSharePath,
+                        IRenderService *pRenderService) {
   Q_UNUSED(userDataDir)
+  Q_UNUSED(pRenderService)
   qDebug() << "initPlugin()" << PLUGIN_NAME << PLUGIN_VERSION;
 
 #if defined __linux__
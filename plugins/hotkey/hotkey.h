@@ -59,7 +59,8 @@ class Hotkey : public QObject, IEditorPlugin {
  public:
     void initPlugin(QWidget *pParent, TextEditor *pEditor,
                     const QDir &userDataDir,
-                    const QString &sSharePath) override;
+                    const QString &sSharePath,
+                    IRenderService *pRenderService) override;
     auto getPluginName() const -> QString override;
     auto getPluginVersion() const -> QString override;
     void installTranslator(const QString &sLang) override;
@@ -0,0 +1,277 @@
+/**
+ * \file markuptokenizer.cpp
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Split Inyoka markup into words of prose for spell checking.
+ */
+
+#include "./markuptokenizer.h"
+
+#include <QTextBoundaryFinder>
+
+MarkupTokenizer::MarkupTokenizer(const QStringList &sListTplKeywords) {
+  for (const auto &sKeyword : sListTplKeywords) {
+    m_sListTplKeywords << sKeyword.toLower();
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto MarkupTokenizer::tokenize(
+    const QString &sText) const -> QList<QPair<int, int>> {
+  QList<QPair<int, int>> listWords;
+  int nState = 0;
+  int nLineStart = 0;
+  while (nLineStart <= sText.length()) {
+    int nLineEnd = sText.indexOf('\n', nLineStart);
+    if (nLineEnd < 0) {
+      nLineEnd = sText.length();
+    }
+    const QList<QPair<int, int>> listLine(
+          this->tokenizeLine(sText.mid(nLineStart, nLineEnd - nLineStart),
+                             &nState));
+    for (const auto &word : listLine) {
+      listWords << qMakePair(nLineStart + word.first, word.second);
+    }
+    nLineStart = nLineEnd + 1;
+  }
+  return listWords;
+}
+
+// ----------------------------------------------------------------------------
+
+auto MarkupTokenizer::tokenizeLine(
+    const QString &sLine, int *pState) const -> QList<QPair<int, int>> {
+  QList<QPair<int, int>> listWords;
+  int nState = *pState;
+  const int nLen = sLine.length();
+  int nPos = 0;
+
+  // Continuation of code block / macro of previous line
+  if (0 != (nState & STATE_CODE)) {
+    const int nEnd = sLine.indexOf(QLatin1String("}}}"));
+    if (nEnd < 0) {
+      return listWords;
+    }
+    nPos = nEnd + 3;
+    nState &= ~STATE_CODE;
+  } else if (0 != (nState & STATE_MACRO)) {
+    const int nEnd = sLine.indexOf(QLatin1String("]]"));
+    if (nEnd < 0) {
+      return listWords;
+    }
+    nPos = nEnd + 2;
+    nState &= ~STATE_MACRO;
+  } else if (sLine.startsWith('#')) {
+    // Comments and meta data (#tag:, ## ...)
+    return listWords;
+  }
+
+  int nProse = nPos;  // Start of current prose span
+  while (nPos < nLen) {
+    const QChar c(sLine.at(nPos));
+    int nSkip = -1;  // End of markup which is not checked
+
+    if (MarkupTokenizer::startsAt(sLine, nPos, QLatin1String("{{{"))) {
+      if (MarkupTokenizer::startsAt(sLine, nPos + 3, QLatin1String("#!"))) {
+        int nKeyEnd = nPos + 5;
+        while (nKeyEnd < nLen && sLine.at(nKeyEnd).isLetterOrNumber()) {
+          nKeyEnd++;
+        }
+        if (m_sListTplKeywords.contains(
+              sLine.mid(nPos + 5, nKeyEnd - nPos - 5).toLower())) {
+          // Parser template: content is markup, name and arguments not
+          nState += 1 << STATE_DEPTH_SHIFT;
+          nSkip = nLen;
+        }
+      }
+      if (nSkip < 0) {
+        // Code block or monospace
+        const int nEnd = sLine.indexOf(QLatin1String("}}}"), nPos + 3);
+        if (nEnd < 0) {
+          nState |= STATE_CODE;
+          nSkip = nLen;
+        } else {
+          nSkip = nEnd + 3;
+        }
+      }
+    } else if (MarkupTokenizer::startsAt(sLine, nPos, QLatin1String("}}}"))) {
+      if ((nState >> STATE_DEPTH_SHIFT) > 0) {
+        nState -= 1 << STATE_DEPTH_SHIFT;
+      }
+      nSkip = nPos + 3;
+    } else if (MarkupTokenizer::startsAt(sLine, nPos, QLatin1String("[["))) {
+      // Macros and templates, e.g. [[Bild(...)]], [[Vorlage(...)]]
+      const int nEnd = sLine.indexOf(QLatin1String("]]"), nPos + 2);
+      if (nEnd < 0) {
+        nState |= STATE_MACRO;
+        nSkip = nLen;
+      } else {
+        nSkip = nEnd + 2;
+      }
+    } else if ('[' == c) {
+      const int nEnd = sLine.indexOf(']', nPos + 1);
+      const int nLabel = nEnd > nPos ?
+                           MarkupTokenizer::linkLabel(sLine, nPos + 1, nEnd)
+                         : -1;
+      if (nLabel >= 0) {
+        // Link target is skipped, label is prose
+        MarkupTokenizer::appendWords(sLine, nProse, nPos, &listWords);
+        MarkupTokenizer::appendWords(sLine, nLabel, nEnd, &listWords);
+        nPos = nEnd + 1;
+        nProse = nPos;
+        continue;
+      }
+    } else if ('`' == c) {
+      const int nEnd = sLine.indexOf('`', nPos + 1);
+      if (nEnd > nPos) {
+        nSkip = nEnd + 1;
+      }
+    } else if ('<' == c &&
+               MarkupTokenizer::startsAt(sLine, nPos - 2,
+                                         QLatin1String("||"))) {
+      // Table cell attributes
+      const int nEnd = sLine.indexOf('>', nPos + 1);
+      if (nEnd > nPos) {
+        nSkip = nEnd + 1;
+      }
+    } else if ('{' == c) {
+      // Flags, e.g. {de}
+      int nEnd = nPos + 1;
+      while (nEnd < nLen && sLine.at(nEnd).isLetter()) {
+        nEnd++;
+      }
+      if (nEnd < nLen && '}' == sLine.at(nEnd) && nEnd - nPos <= 6) {
+        nSkip = nEnd + 1;
+      }
+    } else if ((0 == nPos || !sLine.at(nPos - 1).isLetterOrNumber())
+               && MarkupTokenizer::isUrl(sLine, nPos)) {
+      nSkip = nPos;
+      while (nSkip < nLen && !sLine.at(nSkip).isSpace()) {
+        nSkip++;
+      }
+    }
+
+    if (nSkip >= 0) {
+      MarkupTokenizer::appendWords(sLine, nProse, nPos, &listWords);
+      nPos = nSkip;
+      nProse = nPos;
+    } else {
+      nPos++;
+    }
+  }
+  MarkupTokenizer::appendWords(sLine, nProse, nLen, &listWords);
+
+  *pState = nState;
+  return listWords;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void MarkupTokenizer::appendWords(const QString &sLine, const int nStart,
+                                  const int nEnd,
+                                  QList<QPair<int, int>> *pWords) {
+  if (nEnd <= nStart) {
+    return;
+  }
+
+  // Unicode word boundaries, same as used by QTextCursor::EndOfWord
+  QTextBoundaryFinder finder(QTextBoundaryFinder::Word,
+                             sLine.constData() + nStart, nEnd - nStart);
+  int nWord = nStart;
+  while (-1 != finder.toNextBoundary()) {
+    const int nWordEnd = nStart + finder.position();
+    // Punctuation etc. does not belong to words
+    while (nWord < nWordEnd && !sLine.at(nWord).isLetter()) {
+      nWord++;
+    }
+    // Identifiers and file names are no prose
+    bool bProse = nWord < nWordEnd;
+    for (int i = nWord; bProse && i < nWordEnd; i++) {
+      bProse = !sLine.at(i).isDigit() && '_' != sLine.at(i);
+    }
+    if (bProse) {
+      pWords->append(qMakePair(nWord, nWordEnd - nWord));
+    }
+    nWord = nWordEnd;
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+// Start of link label inside brackets (nEnd if none), -1 if not a link
+auto MarkupTokenizer::linkLabel(const QString &sLine, const int nStart,
+                                const int nEnd) -> int {
+  if (nStart >= nEnd) {
+    return -1;
+  }
+
+  if (':' == sLine.at(nStart)) {
+    // Wiki link [:Page:Label]
+    const int nColon = sLine.indexOf(':', nStart + 1);
+    return (nColon >= 0 && nColon < nEnd) ? nColon + 1 : nEnd;
+  }
+  if ('#' == sLine.at(nStart) || MarkupTokenizer::isUrl(sLine, nStart)) {
+    // Anchor [#anchor Label] or external link [https://... Label]
+    const int nSpace = sLine.indexOf(' ', nStart);
+    return (nSpace >= 0 && nSpace < nEnd) ? nSpace + 1 : nEnd;
+  }
+
+  // InterWiki link [iwl:Target:Label]
+  int nPos = nStart;
+  while (nPos < nEnd &&
+         (sLine.at(nPos).isLetterOrNumber() || '-' == sLine.at(nPos))) {
+    nPos++;
+  }
+  if (nPos > nStart && nPos < nEnd && ':' == sLine.at(nPos)) {
+    const int nColon = sLine.indexOf(':', nPos + 1);
+    return (nColon >= 0 && nColon < nEnd) ? nColon + 1 : nEnd;
+  }
+  return -1;
+}
+
+// ----------------------------------------------------------------------------
+
+auto MarkupTokenizer::isUrl(const QString &sLine, const int nPos) -> bool {
+  return MarkupTokenizer::startsAt(sLine, nPos, QLatin1String("http://"))
+      || MarkupTokenizer::startsAt(sLine, nPos, QLatin1String("https://"))
+      || MarkupTokenizer::startsAt(sLine, nPos, QLatin1String("ftp://"))
+      || MarkupTokenizer::startsAt(sLine, nPos, QLatin1String("www."))
+      || MarkupTokenizer::startsAt(sLine, nPos, QLatin1String("mailto:"));
+}
+
+// ----------------------------------------------------------------------------
+
+auto MarkupTokenizer::startsAt(const QString &sLine, const int nPos,
+                               const QLatin1String &sSearch) -> bool {
+  if (nPos < 0 || nPos + sSearch.size() > sLine.length()) {
+    return false;
+  }
+  for (int i = 0; i < sSearch.size(); i++) {
+    if (sLine.at(nPos + i) != QLatin1Char(sSearch.data()[i])) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,72 @@
+/**
+ * \file markuptokenizer.h
+ *
+ * \section LICENSE
+ *
+ * Copyright (C) 2011-2021 The InyokaEdit developers
+ *
+ * This file is part of InyokaEdit.
+ *
+ * InyokaEdit is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * InyokaEdit is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with InyokaEdit.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * \section DESCRIPTION
+ * Class definition for splitting Inyoka markup into words of prose.
+ */
+
+#ifndef PLUGINS_SPELLCHECKER_MARKUPTOKENIZER_H_
+#define PLUGINS_SPELLCHECKER_MARKUPTOKENIZER_H_
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+/**
+ * \class MarkupTokenizer
+ * \brief Words of prose spans in Inyoka markup
+ *
+ * Code blocks, macros/templates ([[...]]), link targets, URLs, monospace,
+ * table cell attributes and comment/meta lines (e.g. #tag:) are skipped.
+ * Single linear scan per line; multi line constructs are carried in a
+ * state value, so that lines can be checked independently.
+ */
+class MarkupTokenizer {
+ public:
+    // Keywords of parser templates ({{{#!vorlage}}}) with markup content;
+    // without keywords all {{{ }}} blocks are skipped
+    explicit MarkupTokenizer(
+        const QStringList &sListTplKeywords = QStringList());
+
+    // Words (position, length) of one line; state is carried from line to
+    // line, 0 at start of document
+    auto tokenizeLine(
+        const QString &sLine, int *pState) const -> QList<QPair<int, int>>;
+    // Words of complete text, positions relative to start of text
+    auto tokenize(const QString &sText) const -> QList<QPair<int, int>>;
+
+ private:
+    enum STATE {STATE_CODE = 0x1, STATE_MACRO = 0x2, STATE_DEPTH_SHIFT = 2};
+
+    static void appendWords(const QString &sLine, const int nStart,
+                            const int nEnd, QList<QPair<int, int>> *pWords);
+    static auto linkLabel(const QString &sLine, const int nStart,
+                          const int nEnd) -> int;
+    static auto isUrl(const QString &sLine, const int nPos) -> bool;
+    static auto startsAt(const QString &sLine, const int nPos,
+                         const QLatin1String &sSearch) -> bool;
+
+    QStringList m_sListTplKeywords;
+};
+
+#endif  // PLUGINS_SPELLCHECKER_MARKUPTOKENIZER_H_
@@ -60,20 +60,40 @@
 #include <QFile>
 #include <QIcon>
 #include <QMessageBox>
+#include <QSet>
+#include <QTextBlock>
 #include <QTextCodec>
+#include <QTextDocument>
 #include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <QtConcurrent>
 #include <QSettings>
 #include <QStringList>
 #include <QRegularExpression>
 
+#include <algorithm>
+
 #include "./spellcheckdialog.h"
+#include "../../application/irenderservice.h"
 #include "../../application/texteditor.h"
+#include "../../application/trace/trace.h"
 
-SpellChecker::~SpellChecker() = default;
+SpellChecker::~SpellChecker() {
+  // Workers are using this object
+  m_checkWatcher.waitForFinished();
+  if (!m_sPreloadLang.isEmpty()) {
+    delete m_futurePreload.result().pHunspell;
+  }
+  for (const auto &dict : qAsConst(m_listPool)) {
+    delete dict.pHunspell;
+  }
+}
 
 void SpellChecker::initPlugin(QWidget *pParent, TextEditor *pEditor,
                               const QDir &userDataDir,
-                              const QString &sSharePath) {
+                              const QString &sSharePath,
+                              IRenderService *pRenderService) {
   qDebug() << "initPlugin()" << PLUGIN_NAME << PLUGIN_VERSION;
 
 #if defined __linux__
@@ -87,8 +107,10 @@ void SpellChecker::initPlugin(QWidget *pParent, TextEditor *pEditor,
 #endif
 
   m_pHunspell = nullptr;
-  m_pEditor = pEditor;
+  m_pCodec = nullptr;
+  m_pEditor = nullptr;
   m_pParent = pParent;
+  m_pCheckedDoc = nullptr;
   m_UserDataDir = userDataDir;
   m_sSharePath = sSharePath;
 
@@ -98,9 +120,43 @@ void SpellChecker::initPlugin(QWidget *pParent, TextEditor *pEditor,
   this->setDictPath();
   m_sDictLang = m_pSettings->value(QStringLiteral("SpellCheckerLanguage"),
                                    "de_DE").toString();
+  m_bInlineCheck = m_pSettings->value(QStringLiteral("InlineCheck"),
+                                      true).toBool();
+  m_pSettings->endGroup();
+  // Community dictionary (ExtendedDict.txt)
   m_sCommunity = m_pSettings->value(QStringLiteral("Inyoka/Community"),
                                     "ubuntuusers_de").toString();
-  m_pSettings->endGroup();
+
+  // Content of parser templates ({{{#!vorlage) is markup, too
+  if (nullptr != pRenderService) {
+    QStringList sListTplKeywords;
+    const QList<QPair<QString, QStringList>> listMacros(
+          pRenderService->getMacroDefinitions());
+    for (const auto &macro : listMacros) {
+      if ("Template" == macro.first) {
+        sListTplKeywords << macro.second;
+      }
+    }
+    m_tokenizer = MarkupTokenizer(sListTplKeywords);
+  }
+
+  m_pCheckTimer = new QTimer(this);
+  m_pCheckTimer->setSingleShot(true);
+  m_pCheckTimer->setInterval(m_cCHECKDELAY);
+  connect(m_pCheckTimer, &QTimer::timeout,
+          this, &SpellChecker::checkDirtyBlocks);
+  connect(&m_checkWatcher, &QFutureWatcher<QList<CheckedBlock>>::finished,
+          this, &SpellChecker::applyCheckedBlocks);
+
+  // Hunspell needs some time for parsing dictionary, load it in background
+  if (this->dictExists(m_sDictLang)) {
+    m_sPreloadLang = m_sDictLang;
+    m_futurePreload = QtConcurrent::run(&SpellChecker::loadDictionary,
+                                        m_sDictPath, m_sDictLang,
+                                        this->getWordLists(m_sDictLang));
+  }
+
+  this->setCurrentEditor(pEditor);
 }
 
 // ----------------------------------------------------------------------------
@@ -205,30 +261,30 @@ void SpellChecker::setDictPath() {
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-auto SpellChecker::initDictionaries() -> bool {
-  if (!QFile::exists(m_sDictPath + m_sDictLang + ".dic")
-      || !QFile::exists(m_sDictPath + m_sDictLang + ".aff")) {
+auto SpellChecker::initDictionaries(const bool bQuiet) -> bool {
+  TraceSpan span("spellcheck", "initDictionaries");
+  if (!this->dictExists(m_sDictLang)) {
     qWarning() << "Spell checker dictionary file does not exist:"
                << m_sDictPath + m_sDictLang << "*.dic *.aff";
-    QMessageBox::warning(nullptr, qApp->applicationName(),
-                         QString::fromLatin1(
-                           "Spell checker dictionary file does not exist!\n"
-                           "Trying to load fallback dictionary."));
+    if (!bQuiet) {
+      this->showWarning(QString::fromLatin1(
+                          "Spell checker dictionary file does not exist!\n"
+                          "Trying to load fallback dictionary."));
+    }
 
     // Try to load english fallback
     m_sDictLang = QStringLiteral("en_GB");
-    if (!QFile::exists(m_sDictPath + m_sDictLang + ".dic")
-        || !QFile::exists(m_sDictPath + m_sDictLang + ".aff")) {
+    if (!this->dictExists(m_sDictLang)) {
       qWarning() << "Spell checker fallback does not exist:"
                  << m_sDictPath + m_sDictLang << "*.dic *.aff";
       m_sDictLang = QStringLiteral("en-GB");
-      if (!QFile::exists(m_sDictPath + m_sDictLang + ".dic")
-          || !QFile::exists(m_sDictPath + m_sDictLang + ".aff")) {
+      if (!this->dictExists(m_sDictLang)) {
         qWarning() << "Spell checker fallback does not exist:"
                    << m_sDictPath + m_sDictLang << "*.dic *.aff";
-        QMessageBox::warning(nullptr, qApp->applicationName(),
-                             "Spell checker fallback "
-                             + m_sDictLang + " doesn't exist as well.");
+        if (!bQuiet) {
+          this->showWarning("Spell checker fallback "
+                            + m_sDictLang + " doesn't exist as well.");
+        }
         return false;
       }
     }
@@ -242,23 +298,121 @@ auto SpellChecker::initDictionaries() -> bool {
     if (userDictFile.open(QIODevice::WriteOnly)) {
       userDictFile.close();
     } else {
-      QMessageBox::warning(
-            nullptr, qApp->applicationName(),
-            QStringLiteral("User dictionary file couldn't be opened."));
+      if (!bQuiet) {
+        this->showWarning(
+              QStringLiteral("User dictionary file couldn't be opened."));
+      }
       qWarning() << "User dictionary file could not be opened/created:"
                  << m_sUserDict;
     }
   }
 
-  QString sDictFile(m_sDictPath + m_sDictLang + ".dic");
-  QString sAffixFile(m_sDictPath + m_sDictLang + ".aff");
-  QByteArray dictFilePathBA = sDictFile.toLocal8Bit();
-  QByteArray affixFilePathBA = sAffixFile.toLocal8Bit();
+  // Result of background preload (see initPlugin) is kept in pool
+  if (!m_sPreloadLang.isEmpty()) {
+    const HunspellDict preloaded(m_futurePreload.result());
+    m_sPreloadLang.clear();
+    m_futurePreload = QFuture<HunspellDict>();
+    if (nullptr != preloaded.pHunspell) {
+      QMutexLocker locker(&m_mutex);
+      m_listPool.append(preloaded);
+    }
+  }
+
+  int nPooled = -1;
+  for (int i = 0; i < m_listPool.size(); i++) {
+    if (m_listPool.at(i).sLang == m_sDictLang) {
+      nPooled = i;
+      break;
+    }
+  }
+
+  HunspellDict dict;
+  if (nPooled >= 0) {
+    dict = m_listPool.at(nPooled);
+  } else {
+    dict = SpellChecker::loadDictionary(m_sDictPath, m_sDictLang,
+                                        this->getWordLists(m_sDictLang));
+    if (nullptr == dict.pHunspell) {
+      if (!bQuiet) {
+        this->showWarning(QStringLiteral("Dictionary could not be opened."));
+      }
+      return false;
+    }
+  }
+
+  {
+    QMutexLocker locker(&m_mutex);
+    QWriteLocker cacheLocker(&m_cacheLock);
+    if (nPooled >= 0) {
+      m_listPool.removeAt(nPooled);
+    } else {
+      // Ignored words got lost together with old instance
+      m_hashVerdicts.remove(dict.sLang);
+      m_hashSuggestions.remove(dict.sLang);
+    }
+    m_listPool.prepend(dict);
+
+    // Least recently used dictionaries are released
+    while (m_listPool.size() > m_cPOOLSIZE) {
+      const HunspellDict old(m_listPool.takeLast());
+      m_hashVerdicts.remove(old.sLang);
+      m_hashSuggestions.remove(old.sLang);
+      delete old.pHunspell;
+    }
+
+    m_pHunspell = dict.pHunspell;
+    m_pCodec = dict.pCodec;
+    m_sLoadedDict = dict.sLang;
+  }
+
+  this->scheduleFullCheck();
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
+auto SpellChecker::dictExists(const QString &sLang) const -> bool {
+  return QFile::exists(m_sDictPath + sLang + ".dic")
+      && QFile::exists(m_sDictPath + sLang + ".aff");
+}
+
+// ----------------------------------------------------------------------------
+
+void SpellChecker::showWarning(const QString &sMessage) const {
+  // Without parent (headless, see ISpellChecker) only logged
+  if (nullptr != m_pParent) {
+    QMessageBox::warning(nullptr, qApp->applicationName(), sMessage);
+  }
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+// Additional word lists: User dictionary and ExtendedDict.txt
+auto SpellChecker::getWordLists(const QString &sLang) const -> QStringList {
+  return QStringList() << m_UserDataDir.absolutePath() + "/userDict_" +
+                          sLang + ".txt"
+                       << m_sSharePath + "/community/" + m_sCommunity +
+                          "/ExtendedDict.txt"
+                       << qApp->applicationDirPath() + "/ExtendedDict.txt";
+}
+
+// ----------------------------------------------------------------------------
+
+// Runs in preload thread, too - therefore no member access and no dialogs
+auto SpellChecker::loadDictionary(
+    const QString &sDictPath, const QString &sLang,
+    const QStringList &sListWordLists) -> HunspellDict {
+  TraceSpan span("spellcheck", "loadDictionary");
+  HunspellDict dict;
+  dict.sLang = sLang;
+  const QString sDictFile(sDictPath + sLang + ".dic");
+  const QString sAffixFile(sDictPath + sLang + ".aff");
 
   // qDebug() << "Using dictionary:" << sDictFile;
 
   // Detect encoding analyzing the SET option in the affix file
-  m_sEncoding = QStringLiteral("ISO8859-1");
+  QString sEncoding(QStringLiteral("ISO8859-1"));
   QFile _affixFile(sAffixFile);
   if (_affixFile.open(QIODevice::ReadOnly)) {
     QTextStream stream(&_affixFile);
@@ -272,37 +426,30 @@ auto SpellChecker::initDictionaries() -> bool {
       if (sLine.isEmpty()) { continue; }
       match = enc_detector.match(sLine);
       if (match.hasMatch()) {
-        m_sEncoding = match.captured(1);
-        // qDebug() << QString("Encoding set to ") + m_sEncoding;
+        sEncoding = match.captured(1);
+        // qDebug() << QString("Encoding set to ") + sEncoding;
         break;
       }
     }
     _affixFile.close();
   } else {
-    QMessageBox::warning(nullptr, qApp->applicationName(),
-                         QStringLiteral("Dictionary could not be opened."));
     qWarning() << "Dictionary could not be opened:" << sAffixFile;
-    return false;
+    return dict;
   }
-  m_pCodec = QTextCodec::codecForName(
-               this->m_sEncoding.toLatin1().constData());
-
-  delete m_pHunspell;
-  m_pHunspell = nullptr;
-  m_pHunspell = new Hunspell(affixFilePathBA.constData(),
-                             dictFilePathBA.constData());
 
-  this->loadAdditionalDict(m_sUserDict);
-  this->loadAdditionalDict(m_sSharePath + "/community/" +
-                           m_sCommunity + "/ExtendedDict.txt");
-  this->loadAdditionalDict(qApp->applicationDirPath() + "/ExtendedDict.txt");
-  return true;
+  dict.pCodec = QTextCodec::codecForName(sEncoding.toLatin1().constData());
+  dict.pHunspell = new Hunspell(sAffixFile.toLocal8Bit().constData(),
+                                sDictFile.toLocal8Bit().constData());
+  for (const auto &sFile : sListWordLists) {
+    SpellChecker::loadAdditionalDict(dict, sFile);
+  }
+  return dict;
 }
 
-// ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-void SpellChecker::loadAdditionalDict(const QString &sFilename) {
+void SpellChecker::loadAdditionalDict(const HunspellDict &dict,
+                                      const QString &sFilename) {
   QFile DictonaryFile(sFilename);
   if (DictonaryFile.exists()) {
     if (DictonaryFile.open(QIODevice::ReadOnly)) {
@@ -310,7 +457,7 @@ void SpellChecker::loadAdditionalDict(const QString &sFilename) {
       for (QString sWord = stream.readLine();
            !sWord.isEmpty();
            sWord = stream.readLine()) {
-        putWord(sWord);
+        dict.pHunspell->add(dict.pCodec->fromUnicode(sWord).constData());
       }
       DictonaryFile.close();
     } else {
@@ -323,96 +470,97 @@ void SpellChecker::loadAdditionalDict(const QString &sFilename) {
 // ----------------------------------------------------------------------------
 
 void SpellChecker::callPlugin() {
-  if (!this->initDictionaries()) {
+  if (nullptr == m_pHunspell && !this->initDictionaries()) {
     return;
   }
 
+  // Bring misses up to date; verdicts of known words are cached already
+  if (m_checkWatcher.isRunning()) {
+    m_checkWatcher.waitForFinished();
+    this->applyCheckedBlocks();
+  }
+  if (!m_bInlineCheck) {
+    m_listMisses.clear();
+    m_listDirty.clear();
+    QTextCursor all(m_pEditor->document());
+    all.select(QTextCursor::Document);
+    m_listDirty << all;
+  }
+  m_pCheckTimer->stop();
+  while (!m_listDirty.isEmpty()) {  // Changed state cascades once
+    this->setMisses(this->checkBlocks(this->takeDirtyBlocks()));
+  }
+
   m_pCheckDialog = new SpellCheckDialog(this, nullptr);
   m_pCheckDialog->setWindowIcon(this->getIcon());
 
-  QTextCharFormat highlightFormat;
-  highlightFormat.setBackground(QBrush(QColor(255, 96, 96)));
-  highlightFormat.setForeground(QBrush(QColor(0, 0, 0)));
-  // Alternative format
-  // highlightFormat.setUnderlineColor(QColor("red"));
-  // highlightFormat.setUnderlineStyle(QTextCharFormat::SpellCheckUnderline);
-
   // Save the position of the current cursor
   m_oldCursor = m_pEditor->textCursor();
 
-  // Create a new cursor to walk through the text
-  QTextCursor cursor(m_pEditor->document());
-  QList<QTextEdit::ExtraSelection> esList;
-
   SpellCheckDialog::SpellCheckAction spellResult = SpellCheckDialog::None;
-
-  // Don't call cursor.beginEditBlock(), as this prevents the redraw
-  // after changes to the content
-  // cursor.beginEditBlock();
-  while (!cursor.atEnd()) {
-    QCoreApplication::processEvents();
-    cursor.movePosition(QTextCursor::EndOfWord, QTextCursor::KeepAnchor, 1);
-    QString sWord(cursor.selectedText());
-
-    // Workaround for better recognition of words punctuation etc.
-    // does not belong to words
-    while (!sWord.isEmpty()
-           && !sWord.at(0).isLetter()
-           && cursor.anchor() < cursor.position()) {
-      int cursorPos = cursor.position();
-      cursor.setPosition(cursor.anchor() + 1, QTextCursor::MoveAnchor);
-      cursor.setPosition(cursorPos, QTextCursor::KeepAnchor);
-      sWord = cursor.selectedText();
-    }
-
-    if (!sWord.isEmpty() && !this->spell(sWord)) {
-      QTextCursor tmpCursor(cursor);
-      tmpCursor.setPosition(cursor.anchor());
-      m_pEditor->setTextCursor(tmpCursor);
-      m_pEditor->ensureCursorVisible();
-      esList.clear();
-
-      // Highlight the unknown word
-      QTextEdit::ExtraSelection es;
-      es.cursor = cursor;
-      es.format = highlightFormat;
-
-      esList << es;
-      m_pEditor->setExtraSelections(esList);
-      QCoreApplication::processEvents();
-
-      // Ask user what to do
-      spellResult = m_pCheckDialog->checkWord(sWord);
-
-      // Reset the word highlight
-      esList.clear();
-      m_pEditor->setExtraSelections(esList);
-      QCoreApplication::processEvents();
-
-      if (spellResult == SpellCheckDialog::AbortCheck) {
+  int nPos = 0;
+
+  // Jump from miss to miss; list is updated in background while editing
+  while (true) {
+    QTextCursor cursor;
+    for (const auto &miss : qAsConst(m_listMisses)) {
+      if (miss.selectionStart() >= nPos && miss.hasSelection()) {
+        cursor = miss;
         break;
       }
+    }
+    if (cursor.isNull()) {
+      break;
+    }
 
-      switch (spellResult) {
-        case SpellCheckDialog::ReplaceOnce:
-          cursor.insertText(m_pCheckDialog->replacement());
-          break;
-        case SpellCheckDialog::ReplaceAll:
-          this->replaceAll(cursor.position(), sWord,
-                           m_pCheckDialog->replacement());
-          break;
-        default:
-          break;
-      }
-      QCoreApplication::processEvents();
+    const QString sWord(cursor.selectedText());
+    const int nStart = cursor.selectionStart();
+    nPos = cursor.selectionEnd();
+    if (this->spell(sWord)) {
+      continue;  // Ignored / added to dictionary meanwhile
+    }
+
+    QTextCursor tmpCursor(cursor);
+    tmpCursor.setPosition(cursor.selectionStart());
+    m_pEditor->setTextCursor(tmpCursor);
+    m_pEditor->ensureCursorVisible();
+
+    // Highlight the unknown word
+    m_currentWord = cursor;
+    this->updateMarkers();
+
+    // Ask user what to do
+    spellResult = m_pCheckDialog->checkWord(sWord);
+
+    // Reset the word highlight
+    m_currentWord = QTextCursor();
+    this->updateMarkers();
+
+    if (spellResult == SpellCheckDialog::AbortCheck) {
+      break;
+    }
+
+    switch (spellResult) {
+      case SpellCheckDialog::ReplaceOnce:
+        cursor.insertText(m_pCheckDialog->replacement());
+        nPos = nStart + m_pCheckDialog->replacement().length();
+        break;
+      case SpellCheckDialog::ReplaceAll:
+        this->replaceAll(nPos, sWord, m_pCheckDialog->replacement());
+        nPos = nStart + m_pCheckDialog->replacement().length();
+        break;
+      default:
+        break;
     }
-    cursor.movePosition(QTextCursor::NextWord, QTextCursor::MoveAnchor, 1);
   }
 
   delete m_pCheckDialog;
   m_pCheckDialog = nullptr;
 
-  // cursor.endEditBlock();
+  if (!m_bInlineCheck) {
+    m_listMisses.clear();
+  }
+  this->updateMarkers();
   m_pEditor->setTextCursor(m_oldCursor);
 
   if (spellResult != SpellCheckDialog::AbortCheck) {
@@ -426,28 +574,443 @@ void SpellChecker::executePlugin() {}
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
-auto SpellChecker::spell(const QString &sWord) -> bool {
-  return m_pHunspell->spell(m_pCodec->fromUnicode(sWord).toStdString());
+auto SpellChecker::initSpellCheck() -> bool {
+  return this->initDictionaries();
+}
+
+// ----------------------------------------------------------------------------
+
+auto SpellChecker::checkText(
+    const QString &sText) -> QList<QPair<int, QString>> {
+  QList<QPair<int, QString>> listUnknown;
+  if (nullptr == m_pHunspell) {
+    qWarning() << "Spell checker dictionaries not loaded";
+    return listUnknown;
+  }
+  TraceSpan span("spellcheck", "checkText");
+  const HunspellDict *pDict = this->getThreadDict();
+
+  // Same prose spans as interactive and inline check
+  const QList<QPair<int, int>> listWords(m_tokenizer.tokenize(sText));
+  for (const auto &word : listWords) {
+    const QString sWord(sText.mid(word.first, word.second));
+    if (!this->spell(sWord, pDict)) {
+      listUnknown << qMakePair(word.first, sWord);
+    }
+  }
+  return listUnknown;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto SpellChecker::endState(const QTextBlock &block) -> int {
+  if (block.isValid()) {
+    const auto *pData = dynamic_cast<SpellBlockData *>(block.userData());
+    if (nullptr != pData) {
+      return pData->nEndState;
+    }
+  }
+  return 0;
 }
 
 // ----------------------------------------------------------------------------
+
+// Runs in worker thread; only spell() is accessing shared data
+auto SpellChecker::checkBlocks(
+    QList<CheckedBlock> listBlocks) -> QList<CheckedBlock> {
+  TraceSpan span("spellcheck", "checkBlocks");
+  int nState = 0;
+  for (auto &checked : listBlocks) {
+    if (checked.nStartState >= 0) {
+      nState = checked.nStartState;
+    }
+    checked.nStartState = nState;
+    const QList<QPair<int, int>> listWords(
+          m_tokenizer.tokenizeLine(checked.sText, &nState));
+    checked.nEndState = nState;
+    for (const auto &word : listWords) {
+      if (!this->spell(checked.sText.mid(word.first, word.second))) {
+        checked.listMisses << word;
+      }
+    }
+  }
+  return listBlocks;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+void SpellChecker::scheduleFullCheck() {
+  if (!m_bInlineCheck || nullptr == m_pEditor) {
+    return;
+  }
+  QTextCursor all(m_pEditor->document());
+  all.select(QTextCursor::Document);
+  m_listDirty << all;
+  m_pCheckTimer->start();
+}
+
+// ----------------------------------------------------------------------------
+
+void SpellChecker::changedContents(int nPosition, int nCharsRemoved,
+                                   int nCharsAdded) {
+  Q_UNUSED(nCharsRemoved)
+  QTextDocument *pDoc = m_pEditor->document();
+  const int nEnd = qMin(nPosition + nCharsAdded,
+                        qMax(0, pDoc->characterCount() - 1));
+
+  // Markers of changed words are outdated
+  bool bRemoved = false;
+  for (auto it = m_listMisses.begin(); it != m_listMisses.end();) {
+    if (!it->hasSelection() || (it->selectionEnd() >= nPosition
+                                && it->selectionStart() <= nEnd)) {
+      it = m_listMisses.erase(it);
+      bRemoved = true;
+    } else {
+      ++it;
+    }
+  }
+  if (bRemoved) {
+    this->updateMarkers();
+  }
+
+  QTextCursor dirty(pDoc);
+  dirty.setPosition(qMin(nPosition, nEnd));
+  dirty.setPosition(nEnd, QTextCursor::KeepAnchor);
+  m_listDirty << dirty;
+  m_pCheckTimer->start();  // Restart while typing
+}
+
 // ----------------------------------------------------------------------------
 
-auto SpellChecker::suggest(const QString &sWord) -> QStringList {
-  int nSuggestions = 0;
+void SpellChecker::checkDirtyBlocks() {
+  if (nullptr == m_pEditor || m_listDirty.isEmpty()) {
+    return;
+  }
+  if (m_checkWatcher.isRunning()) {
+    m_pCheckTimer->start();
+    return;
+  }
+  // Don't block editor while dictionary is still loaded in background
+  if (nullptr == m_pHunspell && m_futurePreload.isRunning()) {
+    m_pCheckTimer->start();
+    return;
+  }
+  // Dictionaries are loaded with first inline check
+  if (nullptr == m_pHunspell && !this->initDictionaries(true)) {
+    qWarning() << "Inline spell check disabled, no dictionary found.";
+    m_bInlineCheck = false;
+    QObject::disconnect(m_contentsConnection);
+    m_listDirty.clear();
+    return;
+  }
+
+  m_pCheckedDoc = m_pEditor->document();
+  const QList<CheckedBlock> listBlocks(this->takeDirtyBlocks());
+  m_checkWatcher.setFuture(QtConcurrent::run([this, listBlocks]() {
+    return this->checkBlocks(listBlocks);
+  }));
+}
+
+// ----------------------------------------------------------------------------
+
+auto SpellChecker::takeDirtyBlocks() -> QList<CheckedBlock> {
+  QList<CheckedBlock> listBlocks;
+  QSet<int> setBlocks;
+  QTextDocument *pDoc = m_pEditor->document();
+
+  for (const auto &dirty : qAsConst(m_listDirty)) {
+    QTextBlock block(pDoc->findBlock(dirty.selectionStart()));
+    while (block.isValid() && block.position() <= dirty.selectionEnd()) {
+      if (!setBlocks.contains(block.blockNumber())) {
+        setBlocks << block.blockNumber();
+        CheckedBlock checked;
+        checked.nBlock = block.blockNumber();
+        checked.sText = block.text();
+        checked.nStartState = SpellChecker::endState(block.previous());
+        checked.nEndState = 0;
+        listBlocks << checked;
+      }
+      block = block.next();
+    }
+  }
+  m_listDirty.clear();
+
+  // Worker carries state through consecutive blocks
+  std::sort(listBlocks.begin(), listBlocks.end(),
+            [](const CheckedBlock &b1, const CheckedBlock &b2) {
+    return b1.nBlock < b2.nBlock;
+  });
+  for (int i = 1; i < listBlocks.size(); i++) {
+    if (listBlocks.at(i - 1).nBlock + 1 == listBlocks.at(i).nBlock) {
+      listBlocks[i].nStartState = -1;
+    }
+  }
+  return listBlocks;
+}
+
+// ----------------------------------------------------------------------------
+
+void SpellChecker::applyCheckedBlocks() {
+  // Results of an editor which is not active anymore are dropped
+  if (nullptr == m_pCheckedDoc || nullptr == m_pEditor
+      || m_pEditor->document() != m_pCheckedDoc) {
+    m_pCheckedDoc = nullptr;
+    return;
+  }
+  m_pCheckedDoc = nullptr;
+
+  this->setMisses(m_checkWatcher.result());
+  this->updateMarkers();
+  if (!m_listDirty.isEmpty()) {
+    m_pCheckTimer->start();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void SpellChecker::setMisses(const QList<CheckedBlock> &listBlocks) {
+  QTextDocument *pDoc = m_pEditor->document();
+  QSet<int> setChecked;
+  for (const auto &checked : listBlocks) {
+    setChecked << checked.nBlock;
+  }
+  QSet<int> setBlocks;
+  QList<QTextCursor> listNew;
+  int nCascade = -1;
+
+  for (const auto &checked : listBlocks) {
+    QTextBlock block(pDoc->findBlockByNumber(checked.nBlock));
+    if (!block.isValid() || block.text() != checked.sText) {
+      continue;  // Changed while checking, is dirty again
+    }
+    setBlocks << checked.nBlock;
+
+    auto *pData = dynamic_cast<SpellBlockData *>(block.userData());
+    if (nullptr == pData) {
+      pData = new SpellBlockData();
+      block.setUserData(pData);
+    }
+    pData->nStartState = checked.nStartState;
+    pData->nEndState = checked.nEndState;
+
+    // Changed state (e.g. opened code block) affects following blocks
+    const QTextBlock next(block.next());
+    const auto *pNextData = dynamic_cast<SpellBlockData *>(next.userData());
+    if (next.isValid() && !setChecked.contains(checked.nBlock + 1)
+        && (nullptr == pNextData
+            || pNextData->nStartState != checked.nEndState)
+        && (nCascade < 0 || checked.nBlock + 1 < nCascade)) {
+      nCascade = checked.nBlock + 1;
+    }
+
+    for (const auto &miss : checked.listMisses) {
+      QTextCursor cursor(pDoc);
+      cursor.setPosition(block.position() + miss.first);
+      cursor.setPosition(block.position() + miss.first + miss.second,
+                         QTextCursor::KeepAnchor);
+      listNew << cursor;
+    }
+  }
+
+  for (auto it = m_listMisses.begin(); it != m_listMisses.end();) {
+    if (setBlocks.contains(it->block().blockNumber())) {
+      it = m_listMisses.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  m_listMisses << listNew;
+  if (nCascade >= 0) {
+    QTextCursor rest(pDoc);
+    rest.setPosition(pDoc->findBlockByNumber(nCascade).position());
+    rest.movePosition(QTextCursor::End, QTextCursor::KeepAnchor);
+    m_listDirty << rest;
+  }
+  std::sort(m_listMisses.begin(), m_listMisses.end(),
+            [](const QTextCursor &c1, const QTextCursor &c2) {
+    return c1.selectionStart() < c2.selectionStart();
+  });
+}
+
+// ----------------------------------------------------------------------------
+
+void SpellChecker::removeMisses(const QString &sWord) {
+  for (auto it = m_listMisses.begin(); it != m_listMisses.end();) {
+    if (it->selectedText() == sWord) {
+      it = m_listMisses.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  this->updateMarkers();
+}
+
+// ----------------------------------------------------------------------------
+
+void SpellChecker::updateMarkers() {
+  if (nullptr == m_pEditor) {
+    return;
+  }
+
+  // Keep selections of application (e.g. syntax error)
+  QList<QTextEdit::ExtraSelection> listSelections;
+  const QList<QTextEdit::ExtraSelection> listOld(
+        m_pEditor->extraSelections());
+  for (const auto &old : listOld) {
+    if (!old.format.hasProperty(ISpellChecker::m_cMARKERPROPERTY)) {
+      listSelections << old;
+    }
+  }
+
+  QTextEdit::ExtraSelection es;
+  es.format.setProperty(ISpellChecker::m_cMARKERPROPERTY, true);
+  if (m_bInlineCheck) {
+    es.format.setUnderlineColor(QColor(255, 0, 0));
+    es.format.setUnderlineStyle(QTextCharFormat::SpellCheckUnderline);
+    for (const auto &miss : qAsConst(m_listMisses)) {
+      es.cursor = miss;
+      listSelections << es;
+    }
+  }
+
+  if (!m_currentWord.isNull()) {
+    es.format.setBackground(QBrush(QColor(255, 96, 96)));
+    es.format.setForeground(QBrush(QColor(0, 0, 0)));
+    es.cursor = m_currentWord;
+    listSelections << es;
+  }
+
+  m_pEditor->setExtraSelections(listSelections);
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+// Verdict cache is shared by all threads; Hunspell is only asked on a miss.
+// Verdicts are stored under the language of the asked dictionary and not
+// at all, if the language was switched meanwhile (see initDictionaries()).
+auto SpellChecker::spell(const QString &sWord,
+                         const HunspellDict *pDict) -> bool {
+  {
+    QReadLocker locker(&m_cacheLock);
+    const auto itDict = m_hashVerdicts.constFind(
+                          nullptr != pDict ? pDict->sLang : m_sLoadedDict);
+    if (itDict != m_hashVerdicts.constEnd()) {
+      const auto it = itDict->constFind(sWord);
+      if (it != itDict->constEnd()) {
+        return it.value();
+      }
+    }
+  }
+
+  QString sLang;
+  bool bCorrect = false;
+  if (nullptr != pDict) {
+    sLang = pDict->sLang;
+    bCorrect = pDict->pHunspell->spell(
+                 pDict->pCodec->fromUnicode(sWord).toStdString());
+  } else {
+    QMutexLocker locker(&m_mutex);
+    sLang = m_sLoadedDict;
+    bCorrect = m_pHunspell->spell(m_pCodec->fromUnicode(sWord).toStdString());
+  }
+
+  QWriteLocker locker(&m_cacheLock);
+  if (sLang == m_sLoadedDict) {
+    m_hashVerdicts[sLang].insert(sWord, bCorrect);
+  }
+  return bCorrect;
+}
+
+// ----------------------------------------------------------------------------
+
+// Main thread and inline check share the pooled instance (nullptr)
+auto SpellChecker::getThreadDict() -> const HunspellDict* {
+  if (QThread::currentThread() == this->thread()) {
+    return nullptr;
+  }
+
+  QString sLang;
+  {
+    QReadLocker locker(&m_cacheLock);
+    sLang = m_sLoadedDict;
+  }
+  if (!m_threadDicts.hasLocalData() ||
+      m_threadDicts.localData()->dict.sLang != sLang) {
+    auto *pThreadDict = new ThreadDict;
+    pThreadDict->dict = SpellChecker::loadDictionary(
+                          m_sDictPath, sLang, this->getWordLists(sLang));
+    m_threadDicts.setLocalData(pThreadDict);  // Deletes previous one
+  }
+
+  const HunspellDict *pDict = &m_threadDicts.localData()->dict;
+  if (nullptr == pDict->pHunspell) {
+    return nullptr;  // Could not be loaded, fall back to shared instance
+  }
+  return pDict;
+}
+
+// ----------------------------------------------------------------------------
+// ----------------------------------------------------------------------------
+
+auto SpellChecker::getSuggestions(const QString &sWord) -> QStringList {
+  if (nullptr == m_pHunspell) {
+    qWarning() << "Spell checker dictionaries not loaded";
+    return QStringList();
+  }
+  return this->suggest(sWord, this->getThreadDict());
+}
+
+// ----------------------------------------------------------------------------
+
+auto SpellChecker::suggest(const QString &sWord,
+                           const HunspellDict *pDict) -> QStringList {
+  TraceSpan span("spellcheck", "suggest");
+  // Same typos are found again and again (e.g. batch check);
+  // cached under language of asked dictionary like in spell()
+  {
+    QReadLocker locker(&m_cacheLock);
+    const auto itDict = m_hashSuggestions.constFind(
+                          nullptr != pDict ? pDict->sLang : m_sLoadedDict);
+    if (itDict != m_hashSuggestions.constEnd()) {
+      const auto it = itDict->constFind(sWord);
+      if (it != itDict->constEnd()) {
+        return it.value();
+      }
+    }
+  }
+
+  QString sLang;
   QStringList sListSuggestions;
   std::vector<std::string> wordlist;
-  wordlist = m_pHunspell->suggest(m_pCodec->fromUnicode(sWord).toStdString());
+  QTextCodec *pCodec = nullptr;
+  if (nullptr != pDict) {
+    sLang = pDict->sLang;
+    pCodec = pDict->pCodec;
+    wordlist = pDict->pHunspell->suggest(
+                 pCodec->fromUnicode(sWord).toStdString());
+  } else {
+    QMutexLocker locker(&m_mutex);
+    sLang = m_sLoadedDict;
+    pCodec = m_pCodec;
+    wordlist = m_pHunspell->suggest(pCodec->fromUnicode(sWord).toStdString());
+  }
 
-  nSuggestions = static_cast<int>(wordlist.size());
+  const int nSuggestions = static_cast<int>(wordlist.size());
   if (nSuggestions > 0) {
     sListSuggestions.reserve(nSuggestions);
     for (int i = 0; i < nSuggestions; i++) {
-      sListSuggestions << m_pCodec->toUnicode(
+      sListSuggestions << pCodec->toUnicode(
                             QByteArray::fromStdString(wordlist[i]));
     }
   }
 
+  QWriteLocker locker(&m_cacheLock);
+  if (sLang == m_sLoadedDict) {
+    m_hashSuggestions[sLang].insert(sWord, sListSuggestions);
+  }
   return sListSuggestions;
 }
 
@@ -456,29 +1019,35 @@ auto SpellChecker::suggest(const QString &sWord) -> QStringList {
 
 void SpellChecker::replaceAll(const int nPos, const QString &sOld,
                               const QString &sNew) {
-  QTextCursor cursor(m_pEditor->document());
-  cursor.setPosition(nPos-sOld.length(), QTextCursor::MoveAnchor);
-
-  while (!cursor.atEnd()) {
-    QCoreApplication::processEvents();
-    cursor.movePosition(QTextCursor::EndOfWord, QTextCursor::KeepAnchor, 1);
-    QString word = cursor.selectedText();
-
-    while (!word.isEmpty()
-          && !word.at(0).isLetter()
-          && cursor.anchor() < cursor.position()) {
-      int cursorPos = cursor.position();
-      cursor.setPosition(cursor.anchor() + 1, QTextCursor::MoveAnchor);
-      cursor.setPosition(cursorPos, QTextCursor::KeepAnchor);
-      word = cursor.selectedText();
+  TraceSpan span("spellcheck", "replaceAll");
+  QTextDocument *pDoc = m_pEditor->document();
+  const int nStart = nPos - sOld.length();
+
+  // One scan (same words as spell check, i.e. no code, links, etc.)
+  const QString sText(pDoc->toPlainText());
+  const QList<QPair<int, int>> listWords(m_tokenizer.tokenize(sText));
+  QList<int> listMatches;
+  for (const auto &word : listWords) {
+    if (word.first >= nStart && word.second == sOld.length()
+        && sText.mid(word.first, word.second) == sOld) {
+      listMatches << word.first;
     }
+  }
+  if (listMatches.isEmpty()) {
+    return;
+  }
 
-    if (word == sOld) {
-      cursor.insertText(sNew);
-      QCoreApplication::processEvents();
-    }
-    cursor.movePosition(QTextCursor::NextWord, QTextCursor::MoveAnchor, 1);
+  // Back to front, so that positions stay valid; single undo step and
+  // only one relayout / rehighlight
+  QTextCursor cursor(pDoc);
+  cursor.beginEditBlock();
+  for (int i = listMatches.size() - 1; i >= 0; i--) {
+    cursor.setPosition(listMatches.at(i));
+    cursor.setPosition(listMatches.at(i) + sOld.length(),
+                       QTextCursor::KeepAnchor);
+    cursor.insertText(sNew);
   }
+  cursor.endEditBlock();
 }
 
 // ----------------------------------------------------------------------------
@@ -486,13 +1055,20 @@ void SpellChecker::replaceAll(const int nPos, const QString &sOld,
 
 void SpellChecker::ignoreWord(const QString &sWord) {
   this->putWord(sWord);
+  this->removeMisses(sWord);
 }
 
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
 void SpellChecker::putWord(const QString &sWord) {
-  m_pHunspell->add(m_pCodec->fromUnicode(sWord).constData());
+  {
+    QMutexLocker locker(&m_mutex);
+    m_pHunspell->add(m_pCodec->fromUnicode(sWord).constData());
+  }
+  // Thread dictionaries do not know the word, but the cache is asked first
+  QWriteLocker locker(&m_cacheLock);
+  m_hashVerdicts[m_sLoadedDict].insert(sWord, true);
 }
 
 // ----------------------------------------------------------------------------
@@ -500,6 +1076,7 @@ void SpellChecker::putWord(const QString &sWord) {
 
 void SpellChecker::addToUserWordlist(const QString &sWord) {
   this->putWord(sWord);
+  this->removeMisses(sWord);
   if (!m_sUserDict.isEmpty()) {
     QFile userDictonaryFile(m_sUserDict);
     if (userDictonaryFile.open(QIODevice::Append)) {
@@ -533,7 +1110,20 @@ void SpellChecker::showSettings() {
 // ----------------------------------------------------------------------------
 
 void SpellChecker::setCurrentEditor(TextEditor *pEditor) {
+  if (pEditor == m_pEditor) {
+    return;
+  }
+  QObject::disconnect(m_contentsConnection);
   m_pEditor = pEditor;
+  m_listDirty.clear();
+  m_listMisses.clear();
+
+  if (m_bInlineCheck && nullptr != m_pEditor) {
+    m_contentsConnection = connect(m_pEditor->document(),
+                                   &QTextDocument::contentsChange,
+                                   this, &SpellChecker::changedContents);
+    this->scheduleFullCheck();
+  }
 }
 
 void SpellChecker::setEditorlist(const QList<TextEditor *> &listEditors) {
@@ -59,13 +59,24 @@
 
 #include <QAction>  // Cannot use forward declaration (since Qt 6)
 #include <QDir>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QMutex>
 #include <QObject>
+#include <QPair>
+#include <QReadWriteLock>
+#include <QThreadStorage>
 #include <QTranslator>
 #include <QtPlugin>
 #include <QString>
+#include <QTextBlockUserData>
 #include <QTextCursor>
 
+#include "./markuptokenizer.h"
 #include "../../application/ieditorplugin.h"
+#include "../../application/ispellchecker.h"
 
 #if defined _WIN32
 #include "../windows_files/hunspell-mingw/include/hunspell.hxx"
@@ -75,17 +86,50 @@
 
 class QSettings;
 class QTextCodec;
+class QTextBlock;
+class QTextDocument;
+class QTimer;
 
 class TextEditor;
 class SpellCheckDialog;
 
+struct CheckedBlock {
+  int nBlock;
+  QString sText;
+  // Tokenizer state; -1: end state of previous block in list
+  int nStartState;
+  int nEndState;
+  // Unknown words (position in block, length)
+  QList<QPair<int, int>> listMisses;
+};
+
+// Loaded dictionary, words of additional word lists are added already
+struct HunspellDict {
+  QString sLang;
+  Hunspell *pHunspell = nullptr;
+  QTextCodec *pCodec = nullptr;
+};
+
+// Own dictionary of a thread calling checkText() (Hunspell is not thread
+// safe); deleted by QThreadStorage when the thread finishes
+struct ThreadDict {
+  ~ThreadDict() { delete dict.pHunspell; }
+  HunspellDict dict;
+};
+
+// Tokenizer states of a checked block
+struct SpellBlockData : public QTextBlockUserData {
+  int nStartState = 0;
+  int nEndState = 0;
+};
+
 /**
  * \class SpellChecker
  * \brief Spell checker using hunspell.
  */
-class SpellChecker : public QObject, IEditorPlugin {
+class SpellChecker : public QObject, IEditorPlugin, ISpellChecker {
   Q_OBJECT
-  Q_INTERFACES(IEditorPlugin)
+  Q_INTERFACES(IEditorPlugin ISpellChecker)
   Q_PLUGIN_METADATA(IID "InyokaEdit.spellchecker")
 
  public:
@@ -93,7 +137,8 @@ class SpellChecker : public QObject, IEditorPlugin {
 
     void initPlugin(QWidget *pParent, TextEditor *pEditor,
                     const QDir &userDataDir,
-                    const QString &sSharePath) override;
+                    const QString &sSharePath,
+                    IRenderService *pRenderService) override;
     auto getPluginName() const -> QString override;
     auto getPluginVersion() const -> QString override;
     void installTranslator(const QString &sLang) override;
@@ -105,26 +150,59 @@ class SpellChecker : public QObject, IEditorPlugin {
     void setCurrentEditor(TextEditor *pEditor) override;
     void setEditorlist(const QList<TextEditor *> &listEditors) override;
 
+    auto initSpellCheck() -> bool override;
+    auto checkText(const QString &sText) -> QList<QPair<int, QString>> override;
+    auto getSuggestions(const QString &sWord) -> QStringList override;
+
  public slots:
     void callPlugin() override;
     void executePlugin() override;
     void showSettings() override;
     void showAbout() override;
 
+ private slots:
+    void changedContents(int nPosition, int nCharsRemoved, int nCharsAdded);
+    void checkDirtyBlocks();
+    void applyCheckedBlocks();
+
  private:
     friend class SpellCheckDialog;
 
     void setDictPath();
-    auto initDictionaries() -> bool;
-    void loadAdditionalDict(const QString &sFilename);
+    auto initDictionaries(const bool bQuiet = false) -> bool;
+    auto dictExists(const QString &sLang) const -> bool;
+    void showWarning(const QString &sMessage) const;
+    auto getWordLists(const QString &sLang) const -> QStringList;
+    static auto loadDictionary(
+        const QString &sDictPath, const QString &sLang,
+        const QStringList &sListWordLists) -> HunspellDict;
+    static void loadAdditionalDict(const HunspellDict &dict,
+                                   const QString &sFilename);
 
-    auto spell(const QString &sWord) -> bool;
-    auto suggest(const QString &sWord) -> QStringList;
+    // pDict: Hunspell of calling thread, nullptr: shared (locked) instance
+    auto spell(const QString &sWord,
+               const HunspellDict *pDict = nullptr) -> bool;
+    auto suggest(const QString &sWord,
+                 const HunspellDict *pDict = nullptr) -> QStringList;
+    auto getThreadDict() -> const HunspellDict*;
     void ignoreWord(const QString &sWord);
     void addToUserWordlist(const QString &sWord);
     void putWord(const QString &sWord);
     void replaceAll(const int nPos, const QString &sOld, const QString &sNew);
 
+    static auto endState(const QTextBlock &block) -> int;
+    auto checkBlocks(QList<CheckedBlock> listBlocks) -> QList<CheckedBlock>;
+    void scheduleFullCheck();
+    auto takeDirtyBlocks() -> QList<CheckedBlock>;
+    void setMisses(const QList<CheckedBlock> &listBlocks);
+    void removeMisses(const QString &sWord);
+    void updateMarkers();
+
+    // Delay after last change before changed blocks are checked (ms)
+    static const int m_cCHECKDELAY = 300;
+    // Loaded dictionaries kept for switching language
+    static const int m_cPOOLSIZE = 3;
+
     Hunspell *m_pHunspell;
     TextEditor *m_pEditor;
     QAction *m_pExecuteAct;
@@ -140,9 +218,33 @@ class SpellChecker : public QObject, IEditorPlugin {
     QTranslator m_translator;
     QString m_sSharePath;
     QString m_sCommunity;
-    QString m_sEncoding;
     // TODO(volunteer): Replace with QStringConverter for Qt6 (currently core5compat is used)
     QTextCodec *m_pCodec;
+    MarkupTokenizer m_tokenizer;
+
+    // Inline check: Changed blocks are checked in a worker thread
+    bool m_bInlineCheck;
+    QTimer *m_pCheckTimer;
+    QMetaObject::Connection m_contentsConnection;
+    QFutureWatcher<QList<CheckedBlock>> m_checkWatcher;
+    QTextDocument *m_pCheckedDoc;
+    QList<QTextCursor> m_listDirty;
+    // Sorted by position; cursors follow edits of the document
+    QList<QTextCursor> m_listMisses;
+    QTextCursor m_currentWord;
+    // Guards shared Hunspell, codec and pool (main thread, inline worker)
+    QMutex m_mutex;
+    // Guards loaded language and caches; lookups only need a read lock
+    QReadWriteLock m_cacheLock;
+    QString m_sLoadedDict;
+    QThreadStorage<ThreadDict *> m_threadDicts;
+    // Most recently used first; m_pHunspell is the first entry
+    QList<HunspellDict> m_listPool;
+    QFuture<HunspellDict> m_futurePreload;
+    QString m_sPreloadLang;
+    // Dictionary -> word -> correct / suggestions
+    QHash<QString, QHash<QString, bool>> m_hashVerdicts;
+    QHash<QString, QHash<QString, QStringList>> m_hashSuggestions;
 };
 
 #endif  // PLUGINS_SPELLCHECKER_SPELLCHECKER_H_
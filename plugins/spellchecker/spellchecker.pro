@@ -59,7 +59,9 @@ OBJECTS_DIR   = ./.objs
 UI_DIR        = ./.ui
 RCC_DIR       = ./.rcc
 
-QT           += widgets
+include(../../application/trace/trace.pri)
+
+QT           += widgets concurrent
 greaterThan(QT_MAJOR_VERSION, 5) {
   QT         += core5compat
 }
@@ -72,10 +74,12 @@ CONFIG(debug, debug|release) {
   DEFINES    += QT_DISABLE_DEPRECATED_BEFORE=0x060000
 }
 
-HEADERS      += spellcheckdialog.h \
+HEADERS      += markuptokenizer.h \
+                spellcheckdialog.h \
                 spellchecker.h
 
-SOURCES      += spellcheckdialog.cpp \
+SOURCES      += markuptokenizer.cpp \
+                spellcheckdialog.cpp \
                 spellchecker.cpp
 
 FORMS        += spellcheckdialog.ui
@@ -28,19 +28,19 @@
 
 #include <QApplication>
 #include <QDebug>
-#include <QTextDocument>
 #include <QMessageBox>
+#include <QRegularExpression>
 #include <QSettings>
 
-#include "../../application/parser/parser.h"
-#include "../../application/templates/templates.h"
+#include "../../application/irenderservice.h"
 #include "../../application/texteditor.h"
 
 #include "ui_uu_tabletemplate.h"
 
 void Uu_TableTemplate::initPlugin(QWidget *pParent, TextEditor *pEditor,
                                   const QDir &userDataDir,
-                                  const QString &sSharePath) {
+                                  const QString &sSharePath,
+                                  IRenderService *pRenderService) {
   qDebug() << "initPlugin()" << PLUGIN_NAME << PLUGIN_VERSION;
 
 #if defined __linux__
@@ -56,18 +56,8 @@ void Uu_TableTemplate::initPlugin(QWidget *pParent, TextEditor *pEditor,
   m_pParent = pParent;
   m_pEditor = pEditor;
   m_dirPreview = userDataDir;
-  m_pTextDocument = new QTextDocument(this);
   m_sSharePath = sSharePath;
-  m_pTemplates = new Templates(
-                   m_pSettings->value(QStringLiteral("Inyoka/Community"),
-                                      "ubuntuusers_de").toString(),
-                   m_sSharePath, m_dirPreview.absolutePath());
-  m_pParser = new Parser(m_sSharePath, QDir(QLatin1String("")),
-                         QLatin1String(""), false, m_pTemplates,
-                         m_pSettings->value(QStringLiteral("Inyoka/Community"),
-                                            "ubuntuusers_de").toString(),
-                         m_pSettings->value(QStringLiteral("Pygmentize"),
-                                            "").toString());
+  m_pRenderService = pRenderService;  // Parser of application
 
   // Build UI
   m_pDialog = new QDialog(m_pParent);
@@ -259,22 +249,9 @@ void Uu_TableTemplate::executePlugin() {}
 
 #ifndef NOPREVIEW
 void Uu_TableTemplate::preview() {
-  m_pTextDocument->setPlainText(this->generateTable());
-
-  QString sRetHtml(m_pParser->genOutput(QLatin1String(""), m_pTextDocument));
-  // Remove for preview useless elements
-  sRetHtml.remove(
-        QRegularExpression(QStringLiteral("<h1 class=\"pagetitle\">.*</h1>"),
-                           QRegularExpression::DotMatchesEverythingOption));
-  sRetHtml.remove(
-        QRegularExpression(QStringLiteral("<p class=\"meta\">.*</p>"),
-                           QRegularExpression::DotMatchesEverythingOption));
-  sRetHtml.replace(QLatin1String("</style>"),
-                   QLatin1String("#page table{margin:0px;}</style>"));
-
-  m_pPreviewWebview->setHtml(sRetHtml,
-                             QUrl::fromLocalFile(m_dirPreview.absolutePath()
-                                                 + "/"));
+  m_pPreviewWebview->setHtml(
+        m_pRenderService->renderFragment(this->generateTable(), true),
+        QUrl::fromLocalFile(m_dirPreview.absolutePath() + "/"));
 }
 #endif
 
@@ -44,10 +44,7 @@
 #include "../../application/ieditorplugin.h"
 
 class QSettings;
-class QTextDocument;
 
-class Parser;
-class Templates;
 class TextEditor;
 
 namespace Ui {
@@ -66,7 +63,8 @@ class Uu_TableTemplate : public QObject, IEditorPlugin {
  public:
     void initPlugin(QWidget *pParent, TextEditor *pEditor,
                     const QDir &userDataDir,
-                    const QString &sSharePath) override;
+                    const QString &sSharePath,
+                    IRenderService *pRenderService) override;
     auto getPluginName() const -> QString override;
     auto getPluginVersion() const -> QString override;
     void installTranslator(const QString &sLang) override;
@@ -100,10 +98,8 @@ class Uu_TableTemplate : public QObject, IEditorPlugin {
     QDialog *m_pDialog;
     QSettings *m_pSettings;
     TextEditor *m_pEditor;
-    Templates *m_pTemplates;
-    Parser *m_pParser;
+    IRenderService *m_pRenderService;
     QDir m_dirPreview;
-    QTextDocument *m_pTextDocument;
 #ifdef USEQTWEBKIT
     QWebView *m_pPreviewWebview;
 #endif